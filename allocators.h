@@ -0,0 +1,811 @@
+#pragma once
+#include "vector.h"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+
+/// Аллокатор поверх malloc/realloc/free.
+/// Позволяет вектору тривиально перемещаемых элементов менять размер буфера через realloc:
+/// блок расширяется или сжимается на месте, если это возможно, а крупные блоки,
+/// выделенные glibc через mmap, переносятся с помощью mremap без копирования данных
+template <typename T>
+struct MallocAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc does not support over-aligned types");
+
+    using value_type = T;
+
+    MallocAllocator() = default;
+
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > SIZE_MAX / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        void* buf = std::malloc(n * sizeof(T));
+        if (buf == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(buf);
+    }
+
+    void deallocate(T* buf, size_t /*n*/) noexcept {
+        std::free(buf);
+    }
+
+    /// Меняет размер блока buf с old_n на new_n элементов, сохраняя его содержимое.
+    /// При нехватке памяти выбрасывает std::bad_alloc, оставляя исходный блок нетронутым
+    T* reallocate(T* buf, size_t /*old_n*/, size_t new_n) {
+        if (new_n > SIZE_MAX / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        void* new_buf = std::realloc(static_cast<void*>(buf), new_n * sizeof(T));
+        if (new_buf == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(new_buf);
+    }
+
+    bool operator==(const MallocAllocator& /*other*/) const noexcept {
+        return true;
+    }
+};
+
+
+/// Аллокатор, выравнивающий блоки по Alignment байт через перегрузки operator new
+/// с std::align_val_t. Подходит для выровненных SIMD-загрузок (например, 64 байта для AVX-512)
+/// и для размещения элементов в отдельных кеш-линиях
+template <typename T, size_t Alignment>
+struct AlignedAllocator {
+    static_assert((Alignment & (Alignment - 1)) == 0, "alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "alignment must not be weaker than alignof(T)");
+
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > SIZE_MAX / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(operator new(n * sizeof(T), std::align_val_t{Alignment}));
+    }
+
+    void deallocate(T* buf, size_t n) noexcept {
+        operator delete(buf, n * sizeof(T), std::align_val_t{Alignment});
+    }
+
+    bool operator==(const AlignedAllocator& /*other*/) const noexcept {
+        return true;
+    }
+};
+
+/// Способ получить большие страницы для крупных блоков
+enum class HugePageMode {
+    /// прозрачные большие страницы: madvise(MADV_HUGEPAGE) для выровненной области
+    TRANSPARENT,
+    /// заранее зарезервированные страницы hugetlbfs (MAP_HUGETLB),
+    /// при их нехватке — прозрачные большие страницы
+    RESERVED,
+};
+
+/// Аллокатор для больших векторов: блоки от Threshold байт размещаются в анонимных
+/// отображениях, выровненных по 2 МиБ и подкреплённых большими страницами, что снижает
+/// число промахов TLB при сплошном проходе. Меньшие блоки выделяются operator new
+/// с выравниванием Alignment. Изменение размера крупного блока выполняется через mremap
+/// без копирования данных
+template <typename T, HugePageMode Mode = HugePageMode::TRANSPARENT,
+          size_t Threshold = 2 * 1024 * 1024, size_t Alignment = alignof(T)>
+struct HugePageAllocator {
+    static_assert((Alignment & (Alignment - 1)) == 0, "alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "alignment must not be weaker than alignof(T)");
+
+    /// размер большой страницы x86-64 и AArch64 с гранулой 4 КиБ
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = HugePageAllocator<U, Mode, Threshold, Alignment>;
+    };
+
+    HugePageAllocator() = default;
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U, Mode, Threshold, Alignment>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > SIZE_MAX / sizeof(T) - HUGE_PAGE_SIZE) {
+            throw std::bad_array_new_length();
+        }
+        const size_t bytes = n * sizeof(T);
+        if (!IsHuge(bytes)) {
+            return static_cast<T*>(operator new(bytes, std::align_val_t{Alignment}));
+        }
+        return static_cast<T*>(MapHuge(MappedSize(bytes)));
+    }
+
+    void deallocate(T* buf, size_t n) noexcept {
+        const size_t bytes = n * sizeof(T);
+        if (!IsHuge(bytes)) {
+            operator delete(buf, bytes, std::align_val_t{Alignment});
+        } else {
+            munmap(buf, MappedSize(bytes));
+        }
+    }
+
+    /// Меняет размер блока, сохраняя содержимое побайтово.
+    /// Крупный блок переносится в новую выровненную область через mremap,
+    /// остальные случаи сводятся к выделению, копированию и освобождению
+    T* reallocate(T* buf, size_t old_n, size_t new_n) {
+        if (new_n > SIZE_MAX / sizeof(T) - HUGE_PAGE_SIZE) {
+            throw std::bad_array_new_length();
+        }
+        const size_t old_bytes = old_n * sizeof(T);
+        const size_t new_bytes = new_n * sizeof(T);
+        if (IsHuge(old_bytes) && IsHuge(new_bytes)) {
+            const size_t old_size = MappedSize(old_bytes);
+            const size_t new_size = MappedSize(new_bytes);
+            if (new_size <= old_size) {
+                // сжатие отображения всегда выполняется на месте
+                if (new_size != old_size) {
+                    munmap(reinterpret_cast<std::byte*>(buf) + new_size, old_size - new_size);
+                }
+                return buf;
+            }
+            if (void* moved = RemapHuge(buf, old_size, new_size)) {
+                return static_cast<T*>(moved);
+            }
+        }
+        T* new_buf = allocate(new_n);
+        std::memcpy(static_cast<void*>(new_buf), static_cast<const void*>(buf), std::min(old_bytes, new_bytes));
+        deallocate(buf, old_n);
+        return new_buf;
+    }
+
+    bool operator==(const HugePageAllocator& /*other*/) const noexcept {
+        return true;
+    }
+
+private:
+    static bool IsHuge(size_t bytes) noexcept {
+        return bytes >= Threshold;
+    }
+
+    static size_t MappedSize(size_t bytes) noexcept {
+        return (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    }
+
+    /// Резервирует область size байт, выровненную по HUGE_PAGE_SIZE, без доступа к ней
+    static void* ReserveAligned(size_t size) {
+        const size_t padded = size + HUGE_PAGE_SIZE;
+        void* raw = mmap(nullptr, padded, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        // обрезаем невыровненные края
+        const auto addr = reinterpret_cast<uintptr_t>(raw);
+        const uintptr_t aligned = (addr + HUGE_PAGE_SIZE - 1) & ~(uintptr_t{HUGE_PAGE_SIZE} - 1);
+        if (aligned != addr) {
+            munmap(raw, aligned - addr);
+        }
+        const size_t tail = addr + padded - (aligned + size);
+        if (tail != 0) {
+            munmap(reinterpret_cast<void*>(aligned + size), tail);
+        }
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    static void* MapHuge(size_t size) {
+        if constexpr (Mode == HugePageMode::RESERVED) {
+            void* reserved = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (reserved != MAP_FAILED) {
+                return reserved;
+            }
+        }
+        void* area = ReserveAligned(size);
+        if (mmap(area, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED) {
+            munmap(area, size);
+            throw std::bad_alloc();
+        }
+        // совет ядру; если прозрачные большие страницы выключены, память остаётся обычной
+        madvise(area, size, MADV_HUGEPAGE);
+        return area;
+    }
+
+    /// Переносит отображение в выровненную область большего размера.
+    /// Возвращает nullptr, если ядро не может перенести отображение (например, hugetlbfs)
+    static void* RemapHuge(void* buf, size_t old_size, size_t new_size) {
+        void* target = ReserveAligned(new_size);
+        void* moved = mremap(buf, old_size, new_size, MREMAP_MAYMOVE | MREMAP_FIXED, target);
+        if (moved == MAP_FAILED) {
+            munmap(target, new_size);
+            return nullptr;
+        }
+        madvise(moved, new_size, MADV_HUGEPAGE);
+        return moved;
+    }
+};
+
+namespace recycling_detail {
+
+/// Размеры блоков — степени двойки от 16 байт до 1 МиБ; более крупные блоки не кешируются
+inline constexpr size_t MIN_CLASS_SHIFT = 4;
+inline constexpr size_t MAX_CLASS_SHIFT = 20;
+inline constexpr size_t CLASS_COUNT = MAX_CLASS_SHIFT - MIN_CLASS_SHIFT + 1;
+
+inline size_t ClassOf(size_t bytes) noexcept {
+    return std::max<size_t>(std::bit_width(bytes - 1), MIN_CLASS_SHIFT) - MIN_CLASS_SHIFT;
+}
+
+inline size_t ClassBytes(size_t size_class) noexcept {
+    return size_t{1} << (size_class + MIN_CLASS_SHIFT);
+}
+
+inline std::atomic<size_t>& Retention() noexcept {
+    static std::atomic<size_t> retention{256 * 1024};
+    return retention;
+}
+
+/// Свободный блок хранит в своих первых байтах ссылку на следующий и свой класс размера
+struct FreeBlock {
+    FreeBlock* next;
+    size_t size_class;
+};
+
+/// Счётчик, который пишет только поток-владелец, а читать может любой поток
+inline void Bump(std::atomic<uint64_t>& counter) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+/// Кеш свободных блоков одного потока. Локальные списки использует только владелец,
+/// остальные потоки возвращают блоки через стек remote_. Кеш не уничтожается:
+/// после завершения потока он освобождается и достаётся следующему новому потоку
+struct Pool {
+    std::array<FreeBlock*, CLASS_COUNT> free{};
+    std::array<size_t, CLASS_COUNT> cached{};
+    std::atomic<FreeBlock*> remote{nullptr};
+    std::atomic<bool> owned{false};
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> trimmed{0};
+    std::atomic<uint64_t> remote_returns{0};
+
+    void* Allocate(size_t size_class) {
+        if (free[size_class] == nullptr) {
+            DrainRemote();
+        }
+        if (FreeBlock* block = free[size_class]) {
+            free[size_class] = block->next;
+            --cached[size_class];
+            Bump(hits);
+            return block;
+        }
+        Bump(misses);
+        return operator new(ClassBytes(size_class));
+    }
+
+    /// блок освобождается владельцем
+    void Deallocate(void* ptr, size_t size_class) noexcept {
+        const size_t limit = std::max<size_t>(1, Retention().load(std::memory_order_relaxed) / ClassBytes(size_class));
+        if (cached[size_class] >= limit) {
+            Bump(trimmed);
+            operator delete(ptr);
+            return;
+        }
+        auto* block = static_cast<FreeBlock*>(ptr);
+        block->next = free[size_class];
+        free[size_class] = block;
+        ++cached[size_class];
+    }
+
+    /// блок возвращается из другого потока; брошенному кешу блоки не передаются
+    void ReturnRemote(void* ptr, size_t size_class) noexcept {
+        remote_returns.fetch_add(1, std::memory_order_relaxed);
+        if (!owned.load(std::memory_order_acquire)) {
+            operator delete(ptr);
+            return;
+        }
+        auto* block = static_cast<FreeBlock*>(ptr);
+        block->size_class = size_class;
+        block->next = remote.load(std::memory_order_relaxed);
+        while (!remote.compare_exchange_weak(block->next, block, std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+        }
+    }
+
+    /// переносит возвращённые другими потоками блоки в локальные списки
+    void DrainRemote() noexcept {
+        FreeBlock* block = remote.exchange(nullptr, std::memory_order_acquire);
+        while (block != nullptr) {
+            FreeBlock* next = block->next;
+            Deallocate(block, block->size_class);
+            block = next;
+        }
+    }
+
+    /// освобождает все кешированные блоки
+    void Trim() noexcept {
+        DrainRemote();
+        for (size_t size_class = 0; size_class != CLASS_COUNT; ++size_class) {
+            while (FreeBlock* block = free[size_class]) {
+                free[size_class] = block->next;
+                operator delete(block);
+            }
+            cached[size_class] = 0;
+        }
+    }
+};
+
+/// Все созданные кеши и кеши завершившихся потоков, ожидающие нового владельца
+class Registry {
+public:
+    static Registry& Instance() {
+        /// не уничтожается, так как кеши потоков освобождаются уже после статических объектов
+        static Registry* registry = new Registry;
+        return *registry;
+    }
+
+    Pool* Acquire() {
+        std::lock_guard lock(mutex_);
+        Pool* pool = nullptr;
+        if (abandoned_.empty()) {
+            pool = all_.emplace_back(new Pool);
+        } else {
+            pool = abandoned_.back();
+            abandoned_.pop_back();
+        }
+        pool->owned.store(true, std::memory_order_release);
+        return pool;
+    }
+
+    void Abandon(Pool* pool) {
+        pool->owned.store(false, std::memory_order_release);
+        pool->Trim();
+        std::lock_guard lock(mutex_);
+        abandoned_.push_back(pool);
+    }
+
+    template <typename Op>
+    void ForEach(Op op) {
+        std::lock_guard lock(mutex_);
+        for (Pool* pool : all_) {
+            op(*pool);
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<Pool*> all_;
+    std::vector<Pool*> abandoned_;
+};
+
+/// Указатель на кеш потока тривиально уничтожаем, поэтому остаётся доступным и после
+/// разрушения PoolOwner, когда деструкторы других thread_local объектов ещё освобождают память
+inline thread_local Pool* current_pool = nullptr;
+inline thread_local bool thread_exited = false;
+
+struct PoolOwner {
+    Pool* pool = Registry::Instance().Acquire();
+
+    ~PoolOwner() {
+        current_pool = nullptr;
+        thread_exited = true;
+        Registry::Instance().Abandon(pool);
+    }
+};
+
+/// Кеш текущего потока; nullptr, если поток уже завершается
+inline Pool* CurrentPool() {
+    if (current_pool == nullptr && !thread_exited) {
+        thread_local PoolOwner owner;
+        current_pool = owner.pool;
+    }
+    return current_pool;
+}
+
+}  // namespace recycling_detail
+
+/// Показания кешей RecyclingAllocator всех потоков
+struct RecyclingStats {
+    /// выделения, обслуженные кешированным блоком
+    uint64_t hits = 0;
+    /// выделения, потребовавшие operator new
+    uint64_t misses = 0;
+    /// освобождённые блоки, не поместившиеся в кеш из-за ограничения удержания
+    uint64_t trimmed = 0;
+    /// блоки, освобождённые не в том потоке, которым принадлежит аллокатор
+    uint64_t remote_returns = 0;
+};
+
+[[nodiscard]] inline RecyclingStats GetRecyclingStats() {
+    RecyclingStats stats;
+    recycling_detail::Registry::Instance().ForEach([&stats](const recycling_detail::Pool& pool) {
+        stats.hits += pool.hits.load(std::memory_order_relaxed);
+        stats.misses += pool.misses.load(std::memory_order_relaxed);
+        stats.trimmed += pool.trimmed.load(std::memory_order_relaxed);
+        stats.remote_returns += pool.remote_returns.load(std::memory_order_relaxed);
+    });
+    return stats;
+}
+
+/// Устанавливает, сколько байт блоков каждого класса размера поток держит в кеше
+/// (не меньше одного блока). 0 отключает удержание, кроме этого одного блока
+inline void SetRecyclingRetention(size_t bytes_per_class) noexcept {
+    recycling_detail::Retention().store(bytes_per_class, std::memory_order_relaxed);
+}
+
+/// Аллокатор, который повторно использует недавно освобождённые блоки вместо operator new.
+/// Размер блока округляется до степени двойки; у каждого потока свои списки свободных
+/// блоков по классам размера, и выделение из них не требует синхронизации.
+/// Аллокатор запоминает кеш потока, в котором создан: блок, освобождённый в другом потоке,
+/// возвращается в этот кеш через неблокирующий стек и подбирается владельцем при промахе.
+/// Блоки крупнее 1 МиБ выделяются и освобождаются напрямую
+template <typename T>
+struct RecyclingAllocator {
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "over-aligned types are not supported");
+
+    using value_type = T;
+
+    RecyclingAllocator()
+            : home_(recycling_detail::CurrentPool())  //
+    {
+    }
+
+    template <typename U>
+    RecyclingAllocator(const RecyclingAllocator<U>& other) noexcept
+            : home_(other.home_)  //
+    {
+    }
+
+    T* allocate(size_t n) {
+        if (n > SIZE_MAX / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        const size_t bytes = n * sizeof(T);
+        if (bytes > recycling_detail::ClassBytes(recycling_detail::CLASS_COUNT - 1)) {
+            return static_cast<T*>(operator new(bytes));
+        }
+        const size_t size_class = recycling_detail::ClassOf(bytes);
+        if (recycling_detail::Pool* pool = recycling_detail::CurrentPool()) {
+            return static_cast<T*>(pool->Allocate(size_class));
+        }
+        return static_cast<T*>(operator new(recycling_detail::ClassBytes(size_class)));
+    }
+
+    void deallocate(T* buf, size_t n) noexcept {
+        const size_t bytes = n * sizeof(T);
+        if (bytes > recycling_detail::ClassBytes(recycling_detail::CLASS_COUNT - 1)) {
+            operator delete(buf);
+            return;
+        }
+        const size_t size_class = recycling_detail::ClassOf(bytes);
+        recycling_detail::Pool* pool = recycling_detail::CurrentPool();
+        if (pool != nullptr && pool == home_) {
+            pool->Deallocate(buf, size_class);
+        } else if (home_ != nullptr) {
+            home_->ReturnRemote(buf, size_class);
+        } else {
+            operator delete(buf);
+        }
+    }
+
+    /// Блок любого кеша можно вернуть в любой кеш, поэтому все экземпляры равны
+    bool operator==(const RecyclingAllocator& /*other*/) const noexcept {
+        return true;
+    }
+
+private:
+    template <typename U>
+    friend struct RecyclingAllocator;
+
+    recycling_detail::Pool* home_;
+};
+
+/// Округляет вместимость базовой политики вверх до размера блока RecyclingAllocator,
+/// чтобы байты, которые всё равно занимает блок своего класса, стали вместимостью
+template <typename Base = DoublingGrowth>
+struct RecyclingClassGrowth {
+    static size_t Grow(size_t capacity, size_t required, size_t elem_size) noexcept {
+        return RoundUp(Base::Grow(capacity, required, elem_size), elem_size);
+    }
+
+    static size_t Fit(size_t required, size_t elem_size) noexcept {
+        return RoundUp(Base::Fit(required, elem_size), elem_size);
+    }
+
+private:
+    static size_t RoundUp(size_t count, size_t elem_size) noexcept {
+        if (count == 0 || count > recycling_detail::ClassBytes(recycling_detail::CLASS_COUNT - 1) / elem_size) {
+            return count;
+        }
+        return recycling_detail::ClassBytes(recycling_detail::ClassOf(count * elem_size)) / elem_size;
+    }
+};
+
+/// Размещение страниц крупного блока по узлам NUMA
+enum class NumaPlacement {
+    /// политика потока по умолчанию: страница попадает на узел потока, первым записавшего в неё.
+    /// Аллокатор сам ничего не распределяет. Vector(size_t) заполняет буфер параллельно только
+    /// с VECTOR_WITH_TBB и после снижения SetParallelThreshold (по умолчанию параллельный режим
+    /// выключен); Vector(size_t, default_init) для тривиальных T не пишет в память вовсе.
+    /// Рабочие потоки TBB не привязаны к узлам, поэтому и при параллельном заполнении страницы
+    /// оказываются на узлах тех потоков, которым достались участки, без какого-либо порядка.
+    /// Для размещения участков по узлам служит PARTITIONED
+    FIRST_TOUCH,
+    /// все страницы на одном узле
+    BIND,
+    /// страницы по очереди на всех доступных узлах
+    INTERLEAVE,
+    /// буфер делится на равные непрерывные участки, k-й участок предпочтительно
+    /// размещается на k-м доступном узле независимо от того, какой поток его заполнит
+    PARTITIONED,
+};
+
+namespace numa_detail {
+
+inline constexpr size_t MAX_NODES = 1024;
+inline constexpr size_t MASK_BITS = 8 * sizeof(unsigned long);
+using NodeMask = std::array<unsigned long, MAX_NODES / MASK_BITS>;
+
+/// ядро читает maxnode - 1 бит маски
+inline constexpr unsigned long MASK_MAX_NODE = MAX_NODES + 1;
+
+inline NodeMask MaskOf(std::span<const int> nodes) noexcept {
+    NodeMask mask{};
+    for (int node : nodes) {
+        mask[node / MASK_BITS] |= 1UL << (node % MASK_BITS);
+    }
+    return mask;
+}
+
+/// Задаёт политику области; как и madvise, это совет: при ошибке память остаётся с политикой потока
+inline void SetPolicy(void* addr, size_t len, int mode, std::span<const int> nodes) noexcept {
+    const NodeMask mask = MaskOf(nodes);
+    syscall(SYS_mbind, addr, len, mode, mask.data(), MASK_MAX_NODE, 0);
+}
+
+inline std::vector<int> QueryAllowedNodes() {
+    std::vector<int> nodes;
+    NodeMask mask{};
+    int mode = 0;
+    if (syscall(SYS_get_mempolicy, &mode, mask.data(), MASK_MAX_NODE, nullptr, MPOL_F_MEMS_ALLOWED) == 0) {
+        for (size_t node = 0; node != MAX_NODES; ++node) {
+            if ((mask[node / MASK_BITS] >> (node % MASK_BITS)) & 1) {
+                nodes.push_back(static_cast<int>(node));
+            }
+        }
+    }
+    if (nodes.empty()) {
+        // ядро без NUMA: вся память на узле 0
+        nodes.push_back(0);
+    }
+    return nodes;
+}
+
+}  // namespace numa_detail
+
+/// Узлы NUMA, память которых доступна процессу, в порядке возрастания номеров
+[[nodiscard]] inline std::span<const int> NumaNodes() {
+    static const std::vector<int> nodes = numa_detail::QueryAllowedNodes();
+    return nodes;
+}
+
+/// Узел, на котором размещена страница с адресом addr; -1, если ядро не сообщает узел.
+/// Ещё не выделенная страница выделяется по политике своей области
+[[nodiscard]] inline int NumaNodeOf(const void* addr) noexcept {
+    int node = -1;
+    if (syscall(SYS_get_mempolicy, &node, nullptr, 0UL, const_cast<void*>(addr), MPOL_F_NODE | MPOL_F_ADDR) != 0) {
+        return -1;
+    }
+    return node;
+}
+
+/// Аллокатор, размещающий блоки от Threshold байт по узлам NUMA согласно NumaPlacement.
+/// Такие блоки выделяются анонимными отображениями, политика задаётся до первой записи,
+/// поэтому действует и на страницы, которые заполнит конструктор вектора.
+/// Меньшие блоки выделяются operator new и размещаются по политике потока.
+/// Аллокаторы равны, если совпадает размещение: вектор с другим размещением
+/// при перемещающем присваивании переносит элементы в свой буфер
+template <typename T, size_t Threshold = 2 * 1024 * 1024>
+class NumaAllocator {
+public:
+    static constexpr size_t PAGE_SIZE = 4096;
+
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = NumaAllocator<U, Threshold>;
+    };
+
+    /// node учитывается только при NumaPlacement::BIND и должен входить в NumaNodes()
+    explicit NumaAllocator(NumaPlacement placement = NumaPlacement::FIRST_TOUCH, int node = 0)
+            : placement_(placement)
+            , node_(placement == NumaPlacement::BIND ? node : 0)  //
+    {
+        if (placement_ == NumaPlacement::BIND && !std::ranges::binary_search(NumaNodes(), node_)) {
+            throw std::invalid_argument("NUMA node is not available");
+        }
+    }
+
+    template <typename U>
+    NumaAllocator(const NumaAllocator<U, Threshold>& other) noexcept
+            : placement_(other.Placement())
+            , node_(other.Node())  //
+    {
+    }
+
+    T* allocate(size_t n) {
+        if (n > (SIZE_MAX - PAGE_SIZE) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        const size_t bytes = n * sizeof(T);
+        if (!IsMapped(bytes)) {
+            return static_cast<T*>(operator new(bytes, std::align_val_t{alignof(T)}));
+        }
+        const size_t size = MappedSize(bytes);
+        void* area = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (area == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        Place(area, size);
+        return static_cast<T*>(area);
+    }
+
+    void deallocate(T* buf, size_t n) noexcept {
+        const size_t bytes = n * sizeof(T);
+        if (!IsMapped(bytes)) {
+            operator delete(buf, bytes, std::align_val_t{alignof(T)});
+        } else {
+            munmap(buf, MappedSize(bytes));
+        }
+    }
+
+    [[nodiscard]] NumaPlacement Placement() const noexcept {
+        return placement_;
+    }
+
+    [[nodiscard]] int Node() const noexcept {
+        return node_;
+    }
+
+    /// Полуинтервал индексов из первых size элементов блока buf вместимости capacity,
+    /// которые следует обрабатывать на узле node. При BIND весь блок принадлежит своему узлу,
+    /// блок меньше Threshold — узлу своей первой страницы. Для остальных размещений это k-й
+    /// из равных участков блока для k-го узла NumaNodes(). Только при PARTITIONED участок
+    /// совпадает с размещением страниц; при FIRST_TOUCH и INTERLEAVE это просто деление работы
+    /// поровну, и о том, где лежат элементы участка, оно ничего не говорит (см. NodeOf).
+    /// Участки разных узлов не пересекаются и вместе покрывают [0, size)
+    [[nodiscard]] std::pair<size_t, size_t> LocalRange(const T* buf, size_t capacity, size_t size, int node) const {
+        const std::span<const int> nodes = NumaNodes();
+        if (placement_ == NumaPlacement::BIND || !IsMapped(capacity * sizeof(T))) {
+            const int owner = placement_ == NumaPlacement::BIND || size == 0 ? node_ : NumaNodeOf(buf);
+            return node == owner ? std::pair<size_t, size_t>{0, size} : std::pair<size_t, size_t>{0, 0};
+        }
+        const auto it = std::ranges::lower_bound(nodes, node);
+        if (it == nodes.end() || *it != node) {
+            return {0, 0};
+        }
+        const size_t pages = MappedSize(capacity * sizeof(T)) / PAGE_SIZE;
+        const auto k = static_cast<size_t>(it - nodes.begin());
+        return {std::min(size, SliceBegin(pages, k, nodes.size())),
+                std::min(size, SliceBegin(pages, k + 1, nodes.size()))};
+    }
+
+    bool operator==(const NumaAllocator& other) const noexcept {
+        return placement_ == other.placement_ && node_ == other.node_;
+    }
+
+private:
+    static bool IsMapped(size_t bytes) noexcept {
+        return bytes >= Threshold;
+    }
+
+    static size_t MappedSize(size_t bytes) noexcept {
+        return (bytes + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    }
+
+    /// первая страница k-го из parts равных участков блока из pages страниц
+    static size_t SlicePage(size_t pages, size_t k, size_t parts) noexcept {
+        return pages / parts * k + pages % parts * k / parts;
+    }
+
+    /// первый элемент, который начинается в k-м участке
+    static size_t SliceBegin(size_t pages, size_t k, size_t parts) noexcept {
+        return (SlicePage(pages, k, parts) * PAGE_SIZE + sizeof(T) - 1) / sizeof(T);
+    }
+
+    void Place(void* area, size_t size) const noexcept {
+        const std::span<const int> nodes = NumaNodes();
+        switch (placement_) {
+            case NumaPlacement::FIRST_TOUCH:
+                break;
+            case NumaPlacement::BIND:
+                numa_detail::SetPolicy(area, size, MPOL_BIND, std::span(&node_, 1));
+                break;
+            case NumaPlacement::INTERLEAVE:
+                numa_detail::SetPolicy(area, size, MPOL_INTERLEAVE, nodes);
+                break;
+            case NumaPlacement::PARTITIONED: {
+                // при нехватке памяти на узле участок дополняется с других узлов
+                const size_t pages = size / PAGE_SIZE;
+                for (size_t k = 0; k != nodes.size(); ++k) {
+                    const size_t first = SlicePage(pages, k, nodes.size());
+                    const size_t last = SlicePage(pages, k + 1, nodes.size());
+                    if (first != last) {
+                        numa_detail::SetPolicy(static_cast<std::byte*>(area) + first * PAGE_SIZE,
+                                               (last - first) * PAGE_SIZE, MPOL_PREFERRED, nodes.subspan(k, 1));
+                    }
+                }
+                break;
+            }
+        }
+    }
+
+    NumaPlacement placement_;
+    int node_;
+};
+
+/// Вектор с буфером, выровненным по Alignment байт
+template <typename T, size_t Alignment, typename Growth = DoublingGrowth>
+using AlignedVector = Vector<T, AlignedAllocator<T, Alignment>, Growth>;
+
+/// Вектор, крупные буферы которого размещаются на больших страницах
+template <typename T, HugePageMode Mode = HugePageMode::TRANSPARENT, typename Growth = DoublingGrowth>
+using HugePageVector = Vector<T, HugePageAllocator<T, Mode>, Growth>;
+
+/// Вектор, буферы которого повторно используются через кеш потока
+template <typename T, typename Growth = RecyclingClassGrowth<>>
+using RecyclingVector = Vector<T, RecyclingAllocator<T>, Growth>;
+
+/// Вектор, страницы крупного буфера которого размещаются по узлам NUMA
+template <typename T, typename Growth = DoublingGrowth>
+using NumaVector = Vector<T, NumaAllocator<T>, Growth>;
+
+/// Узел NUMA, на котором фактически размещена страница элемента v[index]; -1, если ядро
+/// не сообщает узел. Узел спрашивается у ядра при каждом вызове: при FIRST_TOUCH он зависит
+/// от того, какой поток первым записал в страницу, и заранее не известен
+template <typename T, size_t Threshold, typename Growth>
+[[nodiscard]] int NodeOf(const Vector<T, NumaAllocator<T, Threshold>, Growth>& v, size_t index) noexcept {
+    assert(index < v.Size());
+    return NumaNodeOf(v.begin() + index);
+}
+
+/// Участок индексов v, который следует обрабатывать на узле node (см. NumaAllocator::LocalRange)
+template <typename T, size_t Threshold, typename Growth>
+[[nodiscard]] std::pair<size_t, size_t> LocalRange(const Vector<T, NumaAllocator<T, Threshold>, Growth>& v, int node) {
+    return v.GetAllocator().LocalRange(v.begin(), v.Capacity(), v.Size(), node);
+}
@@ -0,0 +1,964 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/// Где CompactVector хранит размер и вместимость
+enum class CompactLayout {
+    /// 32-битные размер и вместимость рядом с указателем: объект занимает 16 байт,
+    /// вместимость ограничена UINT32_MAX элементов
+    INLINE_32,
+    /// размер и вместимость в заголовке перед элементами в куче, в объекте только указатель:
+    /// 8 байт. Пустой вектор хранит нулевой указатель и не выделяет памяти
+    HEAP_PREFIX,
+};
+
+namespace compact_detail {
+
+template <typename T, typename Alloc>
+class InlineStorage {
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+public:
+    static constexpr size_t MAX_CAPACITY = UINT32_MAX;
+
+    InlineStorage() = default;
+
+    explicit InlineStorage(const Alloc& alloc) noexcept
+            : alloc_(alloc)  //
+    {
+    }
+
+    InlineStorage(size_t capacity, const Alloc& alloc)
+            : alloc_(alloc)  //
+    {
+        assert(capacity <= MAX_CAPACITY);
+        if (capacity != 0) {
+            buffer_ = AllocTraits::allocate(alloc_, capacity);
+            RecordAllocation<T>(capacity);
+            capacity_ = static_cast<uint32_t>(capacity);
+        }
+    }
+
+    InlineStorage(InlineStorage&& other) noexcept
+            : alloc_(std::move(other.alloc_))
+            , buffer_(std::exchange(other.buffer_, nullptr))
+            , size_(std::exchange(other.size_, 0))
+            , capacity_(std::exchange(other.capacity_, 0))  //
+    {
+    }
+
+    InlineStorage& operator=(InlineStorage&&) = delete;
+
+    ~InlineStorage() {
+        if (buffer_ != nullptr) {
+            AllocTraits::deallocate(alloc_, buffer_, capacity_);
+        }
+    }
+
+    [[nodiscard]] T* Data() const noexcept {
+        return buffer_;
+    }
+
+    [[nodiscard]] size_t Size() const noexcept {
+        return size_;
+    }
+
+    [[nodiscard]] size_t Capacity() const noexcept {
+        return capacity_;
+    }
+
+    void SetSize(size_t size) noexcept {
+        assert(size <= capacity_);
+        size_ = static_cast<uint32_t>(size);
+    }
+
+    void Swap(InlineStorage& other) noexcept {
+        std::swap(buffer_, other.buffer_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(alloc_, other.alloc_);
+        } else {
+            assert(alloc_ == other.alloc_);
+        }
+    }
+
+    [[nodiscard]] const Alloc& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+private:
+    [[no_unique_address]] Alloc alloc_;
+    T* buffer_ = nullptr;
+    uint32_t size_ = 0;
+    uint32_t capacity_ = 0;
+};
+
+template <typename T, typename Alloc>
+class PrefixStorage {
+    struct Header {
+        size_t size;
+        size_t capacity;
+    };
+
+    static constexpr size_t UNIT = std::max(alignof(T), alignof(Header));
+
+    /// единица выделения: заголовок и элементы занимают целое число единиц
+    struct alignas(UNIT) Unit {
+        std::byte bytes[UNIT];
+    };
+
+    static constexpr size_t HEADER_UNITS = (sizeof(Header) + UNIT - 1) / UNIT;
+
+    using UnitAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Unit>;
+    using AllocTraits = std::allocator_traits<UnitAlloc>;
+
+public:
+    static constexpr size_t MAX_CAPACITY = (SIZE_MAX / UNIT - HEADER_UNITS) * UNIT / sizeof(T);
+
+    PrefixStorage() = default;
+
+    explicit PrefixStorage(const Alloc& alloc) noexcept
+            : alloc_(alloc)  //
+    {
+    }
+
+    PrefixStorage(size_t capacity, const Alloc& alloc)
+            : alloc_(alloc)  //
+    {
+        assert(capacity <= MAX_CAPACITY);
+        if (capacity != 0) {
+            Unit* units = AllocTraits::allocate(alloc_, UnitsFor(capacity));
+            RecordAllocation<T>(capacity);
+            header_ = std::construct_at(reinterpret_cast<Header*>(units), Header{0, capacity});
+        }
+    }
+
+    PrefixStorage(PrefixStorage&& other) noexcept
+            : alloc_(std::move(other.alloc_))
+            , header_(std::exchange(other.header_, nullptr))  //
+    {
+    }
+
+    PrefixStorage& operator=(PrefixStorage&&) = delete;
+
+    ~PrefixStorage() {
+        if (header_ != nullptr) {
+            const size_t units = UnitsFor(header_->capacity);
+            std::destroy_at(header_);
+            AllocTraits::deallocate(alloc_, reinterpret_cast<Unit*>(header_), units);
+        }
+    }
+
+    [[nodiscard]] T* Data() const noexcept {
+        return header_ == nullptr ? nullptr : reinterpret_cast<T*>(reinterpret_cast<Unit*>(header_) + HEADER_UNITS);
+    }
+
+    [[nodiscard]] size_t Size() const noexcept {
+        return header_ == nullptr ? 0 : header_->size;
+    }
+
+    [[nodiscard]] size_t Capacity() const noexcept {
+        return header_ == nullptr ? 0 : header_->capacity;
+    }
+
+    void SetSize(size_t size) noexcept {
+        assert(size <= Capacity());
+        if (header_ != nullptr) {
+            header_->size = size;
+        }
+    }
+
+    void Swap(PrefixStorage& other) noexcept {
+        std::swap(header_, other.header_);
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(alloc_, other.alloc_);
+        } else {
+            assert(alloc_ == other.alloc_);
+        }
+    }
+
+    [[nodiscard]] Alloc GetAllocator() const noexcept {
+        return Alloc(alloc_);
+    }
+
+private:
+    static size_t UnitsFor(size_t capacity) noexcept {
+        return HEADER_UNITS + (capacity * sizeof(T) + UNIT - 1) / UNIT;
+    }
+
+    [[no_unique_address]] UnitAlloc alloc_;
+    Header* header_ = nullptr;
+};
+
+}  // namespace compact_detail
+
+/// Вектор с уменьшенным заголовком для хранения множества маленьких или пустых векторов
+/// внутри других объектов. Интерфейс и гарантии при исключениях те же, что у Vector:
+/// реаллокация строит новый буфер целиком и лишь затем освобождает старый.
+/// Из интерфейса Vector нет конструкторов из диапазонов, AppendWith, ResizeAndOverwrite
+/// и ShrinkTo; массовые операции выполняются последовательно.
+/// При INLINE_32 запрос вместимости больше UINT32_MAX выбрасывает std::length_error.
+/// Обмен и перемещающее присваивание требуют, чтобы аллокатор распространялся при обмене
+/// или аллокаторы были равны
+template <typename T, CompactLayout Layout, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth>
+class BasicCompactVector {
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using Storage = std::conditional_t<Layout == CompactLayout::INLINE_32, compact_detail::InlineStorage<T, Alloc>,
+                                       compact_detail::PrefixStorage<T, Alloc>>;
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+    using allocator_type = Alloc;
+
+    static constexpr size_t MAX_CAPACITY = Storage::MAX_CAPACITY;
+
+    BasicCompactVector() = default;
+
+    explicit BasicCompactVector(const Alloc& alloc) noexcept;
+
+    /// Создаёт size элементов, инициализированных значением по умолчанию
+    explicit BasicCompactVector(size_t size, const Alloc& alloc = Alloc());
+
+    BasicCompactVector(const BasicCompactVector& other);
+    BasicCompactVector(const BasicCompactVector& other, const Alloc& alloc);
+    BasicCompactVector(BasicCompactVector&& other) noexcept;
+
+    /// Аллокатор не копируется: элементы rhs копируются в память текущего аллокатора
+    BasicCompactVector& operator=(const BasicCompactVector& rhs);
+    BasicCompactVector& operator=(BasicCompactVector&& rhs) noexcept;
+
+    ~BasicCompactVector();
+
+    iterator begin() noexcept;
+    iterator end() noexcept;
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    [[nodiscard]] size_t Size() const noexcept;
+    [[nodiscard]] size_t Capacity() const noexcept;
+    [[nodiscard]] bool IsEmpty() const noexcept;
+
+    const T& operator[](size_t index) const noexcept;
+    T& operator[](size_t index) noexcept;
+
+    void Reserve(size_t new_capacity);
+    /// Освобождает лишнюю память; при HEAP_PREFIX пустой вектор освобождает и заголовок
+    void ShrinkToFit();
+    void Resize(size_t new_size);
+    /// Как Resize, но новые элементы инициализируются по умолчанию,
+    /// то есть элементы тривиальных типов не обнуляются
+    void ResizeForOverwrite(size_t new_size);
+    /// Уничтожает элементы, сохраняя вместимость
+    void Clear() noexcept;
+    void Swap(BasicCompactVector& other) noexcept;
+
+    template <typename Type>
+    void PushBack(Type&& value);
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args);
+    void PopBack() noexcept;
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args);
+    iterator Insert(const_iterator pos, const T& value);
+    iterator Insert(const_iterator pos, T&& value);
+    iterator Erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>);
+    iterator Erase(const_iterator first, const_iterator last) noexcept(std::is_nothrow_move_assignable_v<T>);
+    /// Удаляет элемент pos за O(1), перемещая на его место последний элемент; порядок не сохраняется
+    iterator SwapErase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>);
+    /// Удаляет элементы, для которых pred истинен, с сохранением порядка остальных;
+    /// при исключениях ведёт себя как Vector::EraseIf
+    template <typename Predicate>
+    size_t EraseIf(Predicate pred);
+    /// Как EraseIf, но на место удаляемого элемента переносится последний
+    template <typename Predicate>
+    size_t RemoveIf(Predicate pred);
+    /// Вставляет count копий value перед pos; value может быть элементом вектора
+    iterator Insert(const_iterator pos, size_t count, const T& value);
+    /// Вставляет элементы [first, last) перед pos, выделяя память не более одного раза.
+    /// Итераторы не должны указывать на элементы этого же вектора
+    template <std::input_iterator InputIt>
+    iterator Insert(const_iterator pos, InputIt first, InputIt last);
+
+    /// Добавляет элементы диапазона в конец. Для диапазонов известного размера память
+    /// выделяется не более одного раза, и диапазон может состоять из элементов этого же вектора;
+    /// при исключении добавленные элементы удаляются
+    template <std::ranges::input_range Range>
+    void AppendRange(Range&& range);
+
+    /// Заменяет содержимое вектора элементами [first, last), присваивая их существующим
+    /// элементам, если многопроходный диапазон помещается во вместимость. Итераторы
+    /// не должны указывать на элементы этого же вектора
+    template <std::input_iterator InputIt>
+    void Assign(InputIt first, InputIt last);
+    /// Заменяет содержимое вектора count копиями value; value может быть элементом вектора
+    void Assign(size_t count, const T& value);
+    void Assign(std::initializer_list<T> init);
+    template <std::ranges::input_range Range>
+    void AssignRange(Range&& range);
+
+    [[nodiscard]] Alloc GetAllocator() const noexcept;
+
+private:
+    Storage data_;
+
+    /// переносить элементы при росте перемещением, даже если оно может выбросить исключение
+    static constexpr bool RELOCATE_BY_MOVE = relocates_by_move_v<T, Growth>;
+
+    /// выбрасывает std::length_error, если вместимость не помещается в заголовок
+    static void CheckCapacity(size_t capacity);
+
+    /// вместимость для required элементов при росте по политике Growth
+    [[nodiscard]] size_t NextCapacity(size_t required) const;
+
+    /// вместимость под точно запрошенное количество элементов
+    [[nodiscard]] static size_t FitCapacity(size_t required);
+
+    /// меняет вместимость буфера, сохраняя элементы
+    void Reallocate(size_t new_capacity);
+
+    /// вставляет count элементов в позицию index, как Vector::InsertWith:
+    /// construct(dst, offset, n) создаёт элементы вставки [offset, offset + n) в неинициализированной памяти,
+    /// assign(dst, offset, n) присваивает их уже существующим элементам
+    template <typename Construct, typename AssignOp>
+    iterator InsertWith(size_t index, size_t count, Construct&& construct, AssignOp&& assign);
+
+    /// вставляет count элементов с началом в first в позицию index
+    template <typename Iterator>
+    iterator InsertN(size_t index, Iterator first, size_t count);
+
+    /// заменяет элементы вектора count элементами многопроходного диапазона, начиная с first
+    template <typename ForwardIt>
+    void AssignForward(ForwardIt first, size_t count);
+};
+
+/// 16-байтный вектор с 32-битными размером и вместимостью
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth>
+using CompactVector = BasicCompactVector<T, CompactLayout::INLINE_32, Alloc, Growth>;
+
+/// Вектор размером в один указатель: размер и вместимость хранятся в куче перед элементами
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth>
+using ThinVector = BasicCompactVector<T, CompactLayout::HEAP_PREFIX, Alloc, Growth>;
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+BasicCompactVector<T, Layout, Alloc, Growth>::BasicCompactVector(const Alloc& alloc) noexcept
+        : data_(alloc)  //
+{
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+BasicCompactVector<T, Layout, Alloc, Growth>::BasicCompactVector(size_t size, const Alloc& alloc)
+        : data_(FitCapacity(size), alloc)  //
+{
+    std::uninitialized_value_construct_n(data_.Data(), size);
+    data_.SetSize(size);
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+BasicCompactVector<T, Layout, Alloc, Growth>::BasicCompactVector(const BasicCompactVector& other)
+        : BasicCompactVector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator()))  //
+{
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+BasicCompactVector<T, Layout, Alloc, Growth>::BasicCompactVector(const BasicCompactVector& other, const Alloc& alloc)
+        : data_(FitCapacity(other.Size()), alloc)  //
+{
+    std::uninitialized_copy_n(other.begin(), other.Size(), data_.Data());
+    data_.SetSize(other.Size());
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+BasicCompactVector<T, Layout, Alloc, Growth>::BasicCompactVector(BasicCompactVector&& other) noexcept
+        : data_(std::move(other.data_))  //
+{
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+BasicCompactVector<T, Layout, Alloc, Growth>& BasicCompactVector<T, Layout, Alloc, Growth>::operator=(
+        const BasicCompactVector& rhs) {
+    if (this == &rhs) {
+        return *this;
+    }
+    const size_t count = rhs.Size();
+    if (count > Capacity()) {
+        /// новый буфер заполняется целиком до освобождения старого
+        BasicCompactVector copy(rhs, GetAllocator());
+        Swap(copy);
+    } else if (count < Size()) {
+        std::copy_n(rhs.begin(), count, begin());
+        std::destroy(begin() + count, end());
+        data_.SetSize(count);
+    } else {
+        std::copy_n(rhs.begin(), Size(), begin());
+        std::uninitialized_copy(rhs.begin() + Size(), rhs.end(), end());
+        data_.SetSize(count);
+    }
+    return *this;
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+BasicCompactVector<T, Layout, Alloc, Growth>& BasicCompactVector<T, Layout, Alloc, Growth>::operator=(
+        BasicCompactVector&& rhs) noexcept {
+    if (this != &rhs) {
+        BasicCompactVector moved(std::move(rhs));
+        Swap(moved);
+    }
+    return *this;
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+BasicCompactVector<T, Layout, Alloc, Growth>::~BasicCompactVector() {
+    std::destroy_n(data_.Data(), data_.Size());
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+typename BasicCompactVector<T, Layout, Alloc, Growth>::iterator BasicCompactVector<T, Layout, Alloc, Growth>::begin() noexcept {
+    return data_.Data();
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+typename BasicCompactVector<T, Layout, Alloc, Growth>::iterator BasicCompactVector<T, Layout, Alloc, Growth>::end() noexcept {
+    return data_.Data() + data_.Size();
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+typename BasicCompactVector<T, Layout, Alloc, Growth>::const_iterator BasicCompactVector<T, Layout, Alloc, Growth>::begin() const noexcept {
+    return data_.Data();
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+typename BasicCompactVector<T, Layout, Alloc, Growth>::const_iterator BasicCompactVector<T, Layout, Alloc, Growth>::end() const noexcept {
+    return data_.Data() + data_.Size();
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+typename BasicCompactVector<T, Layout, Alloc, Growth>::const_iterator BasicCompactVector<T, Layout, Alloc, Growth>::cbegin() const noexcept {
+    return begin();
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+typename BasicCompactVector<T, Layout, Alloc, Growth>::const_iterator BasicCompactVector<T, Layout, Alloc, Growth>::cend() const noexcept {
+    return end();
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+size_t BasicCompactVector<T, Layout, Alloc, Growth>::Size() const noexcept {
+    return data_.Size();
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+size_t BasicCompactVector<T, Layout, Alloc, Growth>::Capacity() const noexcept {
+    return data_.Capacity();
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+bool BasicCompactVector<T, Layout, Alloc, Growth>::IsEmpty() const noexcept {
+    return data_.Size() == 0;
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+const T& BasicCompactVector<T, Layout, Alloc, Growth>::operator[](size_t index) const noexcept {
+    assert(index < Size());
+    return data_.Data()[index];
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+T& BasicCompactVector<T, Layout, Alloc, Growth>::operator[](size_t index) noexcept {
+    assert(index < Size());
+    return data_.Data()[index];
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+void BasicCompactVector<T, Layout, Alloc, Growth>::Reserve(size_t new_capacity) {
+    if (new_capacity > Capacity()) {
+        Reallocate(FitCapacity(new_capacity));
+    }
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+void BasicCompactVector<T, Layout, Alloc, Growth>::ShrinkToFit() {
+    if (Size() == 0) {
+        Storage empty(GetAllocator());
+        data_.Swap(empty);
+        return;
+    }
+    const size_t new_capacity = FitCapacity(Size());
+    if (new_capacity < Capacity()) {
+        Reallocate(new_capacity);
+    }
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+void BasicCompactVector<T, Layout, Alloc, Growth>::Resize(size_t new_size) {
+    const size_t size = Size();
+    if (new_size < size) {
+        std::destroy(begin() + new_size, end());
+    } else if (new_size > size) {
+        Reserve(new_size);
+        std::uninitialized_value_construct_n(data_.Data() + size, new_size - size);
+    }
+    data_.SetSize(new_size);
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+void BasicCompactVector<T, Layout, Alloc, Growth>::ResizeForOverwrite(size_t new_size) {
+    const size_t size = Size();
+    if (new_size < size) {
+        std::destroy(begin() + new_size, end());
+    } else if (new_size > size) {
+        Reserve(new_size);
+        std::uninitialized_default_construct_n(data_.Data() + size, new_size - size);
+    }
+    data_.SetSize(new_size);
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+void BasicCompactVector<T, Layout, Alloc, Growth>::Clear() noexcept {
+    std::destroy(begin(), end());
+    data_.SetSize(0);
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+void BasicCompactVector<T, Layout, Alloc, Growth>::Swap(BasicCompactVector& other) noexcept {
+    data_.Swap(other.data_);
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+template<typename Type>
+void BasicCompactVector<T, Layout, Alloc, Growth>::PushBack(Type&& value) {
+    EmplaceBack(std::forward<Type>(value));
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+template<typename... Args>
+T& BasicCompactVector<T, Layout, Alloc, Growth>::EmplaceBack(Args&&... args) {
+    const size_t size = Size();
+    if (size == Capacity()) {
+        /// аргументы могут ссылаться на элементы вектора, поэтому новый элемент
+        /// создаётся в новом буфере до переноса старых
+        Storage new_data(NextCapacity(size + 1), GetAllocator());
+        T* slot = std::construct_at(new_data.Data() + size, std::forward<Args>(args)...);
+        try {
+            RelocateElements<T, RELOCATE_BY_MOVE>(data_.Data(), size, new_data.Data(), size);
+        } catch (...) {
+            std::destroy_at(slot);
+            throw;
+        }
+        new_data.SetSize(size + 1);
+        data_.Swap(new_data);
+    } else {
+        std::construct_at(data_.Data() + size, std::forward<Args>(args)...);
+        data_.SetSize(size + 1);
+    }
+    return data_.Data()[size];
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+void BasicCompactVector<T, Layout, Alloc, Growth>::PopBack() noexcept {
+    assert(!IsEmpty());
+    std::destroy_at(end() - 1);
+    data_.SetSize(Size() - 1);
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+template<typename... Args>
+typename BasicCompactVector<T, Layout, Alloc, Growth>::iterator BasicCompactVector<T, Layout, Alloc, Growth>::Emplace(
+        const_iterator pos, Args&&... args) {
+    assert(pos >= begin() && pos <= end());
+    const size_t index = pos - begin();
+    const size_t size = Size();
+    if (index == size) {
+        EmplaceBack(std::forward<Args>(args)...);
+    } else if (size == Capacity()) {
+        Storage new_data(NextCapacity(size + 1), GetAllocator());
+        T* slot = std::construct_at(new_data.Data() + index, std::forward<Args>(args)...);
+        try {
+            RelocateElements<T, RELOCATE_BY_MOVE>(data_.Data(), size, new_data.Data(), index, 1);
+        } catch (...) {
+            std::destroy_at(slot);
+            throw;
+        }
+        new_data.SetSize(size + 1);
+        data_.Swap(new_data);
+    } else {
+        /// временный объект защищает от перезаписи при вставке элемента этого же вектора
+        T temp_value(std::forward<Args>(args)...);
+        T* data = data_.Data();
+        std::construct_at(data + size, std::move(data[size - 1]));
+        data_.SetSize(size + 1);
+        std::move_backward(data + index, data + size - 1, data + size);
+        data[index] = std::move(temp_value);
+    }
+    return begin() + index;
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+typename BasicCompactVector<T, Layout, Alloc, Growth>::iterator BasicCompactVector<T, Layout, Alloc, Growth>::Insert(
+        const_iterator pos, const T& value) {
+    return Emplace(pos, value);
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+typename BasicCompactVector<T, Layout, Alloc, Growth>::iterator BasicCompactVector<T, Layout, Alloc, Growth>::Insert(
+        const_iterator pos, T&& value) {
+    return Emplace(pos, std::move(value));
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+typename BasicCompactVector<T, Layout, Alloc, Growth>::iterator BasicCompactVector<T, Layout, Alloc, Growth>::Erase(
+        const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>) {
+    assert(pos >= begin() && pos < end());
+    return Erase(pos, pos + 1);
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+typename BasicCompactVector<T, Layout, Alloc, Growth>::iterator BasicCompactVector<T, Layout, Alloc, Growth>::Erase(
+        const_iterator first, const_iterator last) noexcept(std::is_nothrow_move_assignable_v<T>) {
+    assert(first >= begin() && first <= last && last <= end());
+    const size_t index = first - begin();
+    const size_t count = last - first;
+    if (count != 0) {
+        T* pos = begin() + index;
+        std::move(pos + count, end(), pos);
+        std::destroy(end() - count, end());
+        data_.SetSize(Size() - count);
+    }
+    return begin() + index;
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+typename BasicCompactVector<T, Layout, Alloc, Growth>::iterator BasicCompactVector<T, Layout, Alloc, Growth>::SwapErase(
+        const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>) {
+    assert(pos >= begin() && pos < end());
+    T* hole = begin() + (pos - cbegin());
+    T* last = end() - 1;
+    if (hole != last) {
+        *hole = std::move(*last);
+    }
+    std::destroy_at(last);
+    data_.SetSize(Size() - 1);
+    return hole;
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+template<typename Predicate>
+size_t BasicCompactVector<T, Layout, Alloc, Growth>::EraseIf(Predicate pred) {
+    T* const last = end();
+    T* out = begin() + (std::find_if(cbegin(), cend(), std::ref(pred)) - cbegin());
+    if (out == last) {
+        return 0;
+    }
+    /// первый отброшенный элемент уже проверен find_if; [it, last) ещё не проверены
+    /// и при исключении из pred сдвигаются к out
+    T* it = out + 1;
+    auto finish = [&]() {
+        std::move(it, last, out);
+        const size_t removed = it - out;
+        std::destroy(last - removed, last);
+        data_.SetSize(Size() - removed);
+        return removed;
+    };
+    try {
+        for (; it != last; ++it) {
+            if (!pred(std::as_const(*it))) {
+                *out = std::move(*it);
+                ++out;
+            }
+        }
+    } catch (...) {
+        finish();
+        throw;
+    }
+    return finish();
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+template<typename Predicate>
+size_t BasicCompactVector<T, Layout, Alloc, Growth>::RemoveIf(Predicate pred) {
+    T* const first = begin();
+    T* const old_last = end();
+    T* last = old_last;
+    /// [last, old_last) — ячейки, элементы которых отброшены или перенесены в начало
+    auto finish = [&]() noexcept {
+        std::destroy(last, old_last);
+        data_.SetSize(last - first);
+        return static_cast<size_t>(old_last - last);
+    };
+    try {
+        for (T* it = first; it != last;) {
+            if (!pred(std::as_const(*it))) {
+                ++it;
+                continue;
+            }
+            --last;
+            if (it != last) {
+                *it = std::move(*last);
+            }
+        }
+    } catch (...) {
+        finish();
+        throw;
+    }
+    return finish();
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+typename BasicCompactVector<T, Layout, Alloc, Growth>::iterator BasicCompactVector<T, Layout, Alloc, Growth>::Insert(
+        const_iterator pos, size_t count, const T& value) {
+    assert(pos >= begin() && pos <= end());
+    const size_t index = pos - cbegin();
+    const T* address = std::addressof(value);
+    const std::less<const T*> before;
+    /// value может ссылаться на элемент вектора, который будет сдвинут, и тогда вставляется его копия
+    if (Size() + count <= Capacity() && !before(address, begin()) && before(address, end())) {
+        const T value_copy(value);
+        return InsertWith(index, count,
+                          [&value_copy](T* dst, size_t /*offset*/, size_t n) { std::uninitialized_fill_n(dst, n, value_copy); },
+                          [&value_copy](T* dst, size_t /*offset*/, size_t n) { std::fill_n(dst, n, value_copy); });
+    }
+    /// при реаллокации старые элементы остаются на месте, пока копии не созданы
+    return InsertWith(index, count,
+                      [&value](T* dst, size_t /*offset*/, size_t n) { std::uninitialized_fill_n(dst, n, value); },
+                      [&value](T* dst, size_t /*offset*/, size_t n) { std::fill_n(dst, n, value); });
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+template<std::input_iterator InputIt>
+typename BasicCompactVector<T, Layout, Alloc, Growth>::iterator BasicCompactVector<T, Layout, Alloc, Growth>::Insert(
+        const_iterator pos, InputIt first, InputIt last) {
+    assert(pos >= begin() && pos <= end());
+    const size_t index = pos - cbegin();
+    if constexpr (std::forward_iterator<InputIt>) {
+        return InsertN(index, first, static_cast<size_t>(std::distance(first, last)));
+    } else {
+        /// размер однопроходного диапазона заранее неизвестен: собираем его отдельно
+        BasicCompactVector tail(GetAllocator());
+        for (; first != last; ++first) {
+            tail.EmplaceBack(*first);
+        }
+        return InsertN(index, std::make_move_iterator(tail.begin()), tail.Size());
+    }
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+template<std::ranges::input_range Range>
+void BasicCompactVector<T, Layout, Alloc, Growth>::AppendRange(Range&& range) {
+    if constexpr (std::ranges::sized_range<Range> || std::ranges::forward_range<Range>) {
+        /// при реаллокации элементы создаются в новом буфере до переноса старых,
+        /// поэтому источником может быть сам вектор
+        InsertN(Size(), std::ranges::begin(range), static_cast<size_t>(std::ranges::distance(range)));
+    } else {
+        const size_t old_size = Size();
+        try {
+            for (auto&& value : range) {
+                EmplaceBack(std::forward<decltype(value)>(value));
+            }
+        } catch (...) {
+            std::destroy(begin() + old_size, end());
+            data_.SetSize(old_size);
+            throw;
+        }
+    }
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+template<std::input_iterator InputIt>
+void BasicCompactVector<T, Layout, Alloc, Growth>::Assign(InputIt first, InputIt last) {
+    if constexpr (std::forward_iterator<InputIt>) {
+        AssignForward(first, static_cast<size_t>(std::distance(first, last)));
+    } else {
+        /// новые элементы собираются отдельно, поэтому при исключении вектор не меняется
+        BasicCompactVector replacement(GetAllocator());
+        for (; first != last; ++first) {
+            replacement.EmplaceBack(*first);
+        }
+        Swap(replacement);
+    }
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+void BasicCompactVector<T, Layout, Alloc, Growth>::Assign(size_t count, const T& value) {
+    const size_t size = Size();
+    if (count > Capacity()) {
+        /// копии создаются до уничтожения старых элементов, среди которых может быть value
+        Storage new_data(FitCapacity(count), GetAllocator());
+        std::uninitialized_fill_n(new_data.Data(), count, value);
+        std::destroy_n(data_.Data(), size);
+        new_data.SetSize(count);
+        data_.Swap(new_data);
+        return;
+    }
+    if (count < size) {
+        std::fill_n(begin(), count, value);
+        std::destroy(begin() + count, end());
+    } else {
+        std::fill_n(begin(), size, value);
+        std::uninitialized_fill_n(end(), count - size, value);
+    }
+    data_.SetSize(count);
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+void BasicCompactVector<T, Layout, Alloc, Growth>::Assign(std::initializer_list<T> init) {
+    AssignForward(init.begin(), init.size());
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+template<std::ranges::input_range Range>
+void BasicCompactVector<T, Layout, Alloc, Growth>::AssignRange(Range&& range) {
+    if constexpr (std::ranges::forward_range<Range>) {
+        AssignForward(std::ranges::begin(range), static_cast<size_t>(std::ranges::distance(range)));
+    } else {
+        BasicCompactVector replacement(GetAllocator());
+        replacement.AppendRange(std::forward<Range>(range));
+        Swap(replacement);
+    }
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+Alloc BasicCompactVector<T, Layout, Alloc, Growth>::GetAllocator() const noexcept {
+    return data_.GetAllocator();
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+void BasicCompactVector<T, Layout, Alloc, Growth>::CheckCapacity(size_t capacity) {
+    if (capacity > MAX_CAPACITY) {
+        throw std::length_error("CompactVector capacity exceeds its header limit");
+    }
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+size_t BasicCompactVector<T, Layout, Alloc, Growth>::NextCapacity(size_t required) const {
+    CheckCapacity(required);
+    /// рост упирается в предел заголовка, но не выходит за него
+    return std::min(Growth::Grow(Capacity(), required, sizeof(T)), MAX_CAPACITY);
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+size_t BasicCompactVector<T, Layout, Alloc, Growth>::FitCapacity(size_t required) {
+    CheckCapacity(required);
+    return std::min(Growth::Fit(required, sizeof(T)), MAX_CAPACITY);
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+void BasicCompactVector<T, Layout, Alloc, Growth>::Reallocate(size_t new_capacity) {
+    const size_t size = Size();
+    assert(new_capacity >= size);
+    Storage new_data(new_capacity, GetAllocator());
+    RelocateElements<T, RELOCATE_BY_MOVE>(data_.Data(), size, new_data.Data(), size);
+    new_data.SetSize(size);
+    data_.Swap(new_data);
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+template<typename Construct, typename AssignOp>
+typename BasicCompactVector<T, Layout, Alloc, Growth>::iterator BasicCompactVector<T, Layout, Alloc, Growth>::InsertWith(
+        size_t index, size_t count, Construct&& construct, AssignOp&& assign) {
+    const size_t size = Size();
+    assert(index <= size);
+    if (count == 0) {
+        return begin() + index;
+    }
+    if (size + count > Capacity()) {
+        /// вставляемые элементы создаются в новом буфере, затем старые переносятся вокруг них.
+        /// При исключении вектор остаётся в исходном состоянии
+        Storage new_data(NextCapacity(size + count), GetAllocator());
+        construct(new_data.Data() + index, 0, count);
+        try {
+            RelocateElements<T, RELOCATE_BY_MOVE>(data_.Data(), size, new_data.Data(), index, count);
+        } catch (...) {
+            std::destroy_n(new_data.Data() + index, count);
+            throw;
+        }
+        new_data.SetSize(size + count);
+        data_.Swap(new_data);
+        return begin() + index;
+    }
+
+    T* pos = data_.Data() + index;
+    T* old_end = data_.Data() + size;
+    const size_t elems_after = size - index;
+    if (elems_after > count) {
+        /// последние count элементов переезжают в неинициализированную область,
+        /// остальные сдвигаются присваиванием
+        std::uninitialized_move_n(old_end - count, count, old_end);
+        data_.SetSize(size + count);
+        std::move_backward(pos, old_end - count, old_end);
+        assign(pos, 0, count);
+    } else {
+        /// часть вставляемых элементов попадает за конец вектора
+        construct(old_end, elems_after, count - elems_after);
+        data_.SetSize(size + count - elems_after);
+        std::uninitialized_move_n(pos, elems_after, pos + count);
+        data_.SetSize(size + count);
+        assign(pos, 0, elems_after);
+    }
+    return begin() + index;
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+template<typename Iterator>
+typename BasicCompactVector<T, Layout, Alloc, Growth>::iterator BasicCompactVector<T, Layout, Alloc, Growth>::InsertN(
+        size_t index, Iterator first, size_t count) {
+    return InsertWith(index, count,
+                      [&first](T* dst, size_t offset, size_t n) {
+                          std::ranges::uninitialized_copy_n(std::ranges::next(first, offset), n, dst, dst + n);
+                      },
+                      [&first](T* dst, size_t offset, size_t n) {
+                          std::ranges::copy_n(std::ranges::next(first, offset), n, dst);
+                      });
+}
+
+template<typename T, CompactLayout Layout, typename Alloc, typename Growth>
+template<typename ForwardIt>
+void BasicCompactVector<T, Layout, Alloc, Growth>::AssignForward(ForwardIt first, size_t count) {
+    const size_t size = Size();
+    if (count > Capacity()) {
+        /// новый буфер заполняется целиком до освобождения старого
+        Storage new_data(FitCapacity(count), GetAllocator());
+        std::ranges::uninitialized_copy_n(first, count, new_data.Data(), new_data.Data() + count);
+        std::destroy_n(data_.Data(), size);
+        new_data.SetSize(count);
+        data_.Swap(new_data);
+        return;
+    }
+    T* data = data_.Data();
+    if (count < size) {
+        std::ranges::copy_n(first, count, data);
+        std::destroy(data + count, data + size);
+    } else {
+        auto rest = std::ranges::copy_n(first, size, data).in;
+        std::ranges::uninitialized_copy_n(rest, count - size, data + size, data + count);
+    }
+    data_.SetSize(count);
+}
+
+/// Поэлементное сравнение; для арифметических типов используется векторизованное simd::Equal
+template <typename T, CompactLayout Layout, typename Alloc, typename Growth>
+bool operator==(const BasicCompactVector<T, Layout, Alloc, Growth>& lhs,
+                const BasicCompactVector<T, Layout, Alloc, Growth>& rhs) {
+    if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+        return simd::Equal(lhs, rhs);
+    } else {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+}
@@ -0,0 +1,294 @@
+#pragma once
+#include "segment_layout.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+/// Вектор, в конец которого можно одновременно добавлять элементы из многих потоков.
+/// Элементы лежат в сегментах геометрически растущего размера (SegmentLayout), поэтому
+/// рост не переносит уже добавленные элементы и их адреса остаются неизменными.
+/// Индекс нового элемента резервируется одним atomic fetch_add; сегмент выделяет первый
+/// обратившийся к нему поток, остальные ждут его публикации и ничего не выделяют.
+/// Элемент считается опубликованным, когда конструктор завершился: после этого
+/// IsPublished(index) возвращает true и элемент можно читать через operator[] из любого потока.
+/// Разрушение, Reserve и Clear не потокобезопасны относительно других операций
+template <typename T, typename Alloc = std::allocator<T>, size_t FirstSegmentSize = 32>
+class ConcurrentVector {
+    using Layout = SegmentLayout<FirstSegmentSize>;
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using FlagAlloc = typename AllocTraits::template rebind_alloc<std::atomic<bool>>;
+    using FlagAllocTraits = std::allocator_traits<FlagAlloc>;
+
+    static_assert(std::is_same_v<typename AllocTraits::value_type, T>, "Alloc::value_type must be the same as T");
+    static_assert(std::is_nothrow_destructible_v<T>, "elements must have a non-throwing destructor");
+
+public:
+    using allocator_type = Alloc;
+
+    ConcurrentVector() = default;
+
+    explicit ConcurrentVector(const Alloc& alloc) noexcept;
+
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    ~ConcurrentVector();
+
+    /// Добавляет элемент и возвращает ссылку на него; ссылка действительна до разрушения вектора.
+    /// Если конструктор выбросил исключение, зарезервированный индекс остаётся неопубликованным
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args);
+
+    template <typename Type>
+    T& PushBack(Type&& value);
+
+    /// Резервирует count подряд идущих индексов одним fetch_add и создаёт в них
+    /// элементы со значением по умолчанию. Возвращает индекс первого из них
+    size_t GrowBy(size_t count);
+
+    /// То же, но элементы создаются копированием value
+    size_t GrowBy(size_t count, const T& value);
+
+    /// Количество зарезервированных индексов. Элементы с индексами меньше Size()
+    /// могут ещё создаваться другими потоками — см. IsPublished
+    [[nodiscard]] size_t Size() const noexcept;
+    [[nodiscard]] bool IsEmpty() const noexcept;
+    /// Количество элементов в уже выделенных сегментах
+    [[nodiscard]] size_t Capacity() const noexcept;
+
+    /// Завершено ли создание элемента index
+    [[nodiscard]] bool IsPublished(size_t index) const noexcept;
+
+    /// Элемент должен быть опубликован
+    const T& operator[](size_t index) const noexcept;
+    T& operator[](size_t index) noexcept;
+
+    /// Заранее выделяет сегменты под capacity элементов
+    void Reserve(size_t capacity);
+
+    /// Уничтожает элементы, сохраняя выделенные сегменты
+    void Clear() noexcept;
+
+    [[nodiscard]] Alloc GetAllocator() const noexcept;
+
+private:
+    [[no_unique_address]] Alloc alloc_;
+    std::atomic<size_t> size_{0};
+    std::atomic<T*> segments_[Layout::MAX_SEGMENTS] = {};
+    /// признаки публикации элементов, по одному массиву на сегмент
+    std::atomic<std::atomic<bool>*> published_[Layout::MAX_SEGMENTS] = {};
+    /// сегмент выделяется одним потоком: тем, кто первым поднял его флаг
+    std::atomic<bool> allocating_[Layout::MAX_SEGMENTS] = {};
+
+    /// возвращает сегмент, выделяя его при первом обращении
+    T* GetSegment(size_t segment);
+
+    /// создаёт элементы [first, first + count), вызывая construct(T* place) для каждого
+    template <typename Construct>
+    void ConstructRange(size_t first, size_t count, Construct construct);
+
+    /// ячейка и признак публикации элемента index в уже выделенном сегменте
+    [[nodiscard]] T* Slot(size_t index) const noexcept;
+    [[nodiscard]] std::atomic<bool>& Flag(size_t index) const noexcept;
+
+}; // class ConcurrentVector
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+ConcurrentVector<T, Alloc, FirstSegmentSize>::ConcurrentVector(const Alloc& alloc) noexcept
+        : alloc_(alloc)  //
+{
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+ConcurrentVector<T, Alloc, FirstSegmentSize>::~ConcurrentVector() {
+    Clear();
+    FlagAlloc flag_alloc(alloc_);
+    for (size_t k = 0; k != Layout::MAX_SEGMENTS; ++k) {
+        if (T* segment = segments_[k].load(std::memory_order_relaxed)) {
+            AllocTraits::deallocate(alloc_, segment, Layout::SegmentSize(k));
+            FlagAllocTraits::deallocate(flag_alloc, published_[k].load(std::memory_order_relaxed), Layout::SegmentSize(k));
+        }
+    }
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+template<typename... Args>
+T& ConcurrentVector<T, Alloc, FirstSegmentSize>::EmplaceBack(Args&&... args) {
+    const size_t index = size_.fetch_add(1, std::memory_order_relaxed);
+    const size_t k = Layout::SegmentOf(index);
+    T* place = GetSegment(k) + (index - Layout::SegmentBase(k));
+    new (place) T(std::forward<Args>(args)...);
+    Flag(index).store(true, std::memory_order_release);
+    return *place;
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+template<typename Type>
+T& ConcurrentVector<T, Alloc, FirstSegmentSize>::PushBack(Type&& value) {
+    return EmplaceBack(std::forward<Type>(value));
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+size_t ConcurrentVector<T, Alloc, FirstSegmentSize>::GrowBy(size_t count) {
+    const size_t first = size_.fetch_add(count, std::memory_order_relaxed);
+    ConstructRange(first, count, [](T* place) {
+        new (place) T();
+    });
+    return first;
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+size_t ConcurrentVector<T, Alloc, FirstSegmentSize>::GrowBy(size_t count, const T& value) {
+    const size_t first = size_.fetch_add(count, std::memory_order_relaxed);
+    ConstructRange(first, count, [&value](T* place) {
+        new (place) T(value);
+    });
+    return first;
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+size_t ConcurrentVector<T, Alloc, FirstSegmentSize>::Size() const noexcept {
+    return size_.load(std::memory_order_acquire);
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+bool ConcurrentVector<T, Alloc, FirstSegmentSize>::IsEmpty() const noexcept {
+    return Size() == 0;
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+size_t ConcurrentVector<T, Alloc, FirstSegmentSize>::Capacity() const noexcept {
+    size_t capacity = 0;
+    for (size_t k = 0; k != Layout::MAX_SEGMENTS; ++k) {
+        if (segments_[k].load(std::memory_order_acquire) != nullptr) {
+            capacity += Layout::SegmentSize(k);
+        }
+    }
+    return capacity;
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+bool ConcurrentVector<T, Alloc, FirstSegmentSize>::IsPublished(size_t index) const noexcept {
+    const std::atomic<bool>* flags = published_[Layout::SegmentOf(index)].load(std::memory_order_acquire);
+    return flags != nullptr
+           && flags[index - Layout::SegmentBase(Layout::SegmentOf(index))].load(std::memory_order_acquire);
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+const T& ConcurrentVector<T, Alloc, FirstSegmentSize>::operator[](size_t index) const noexcept {
+    return const_cast<ConcurrentVector&>(*this)[index];
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+T& ConcurrentVector<T, Alloc, FirstSegmentSize>::operator[](size_t index) noexcept {
+    assert(IsPublished(index));
+    return *Slot(index);
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+void ConcurrentVector<T, Alloc, FirstSegmentSize>::Reserve(size_t capacity) {
+    for (size_t k = 0; k != Layout::SegmentsFor(capacity); ++k) {
+        GetSegment(k);
+    }
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+void ConcurrentVector<T, Alloc, FirstSegmentSize>::Clear() noexcept {
+    const size_t size = size_.exchange(0, std::memory_order_relaxed);
+    for (size_t k = 0; k != Layout::SegmentsFor(size); ++k) {
+        T* segment = segments_[k].load(std::memory_order_relaxed);
+        std::atomic<bool>* flags = published_[k].load(std::memory_order_relaxed);
+        if (segment == nullptr) {
+            // сегмент не удалось выделить, его индексы не опубликованы
+            continue;
+        }
+        const size_t count = std::min(Layout::SegmentSize(k), size - Layout::SegmentBase(k));
+        for (size_t i = 0; i != count; ++i) {
+            if (flags[i].exchange(false, std::memory_order_relaxed)) {
+                std::destroy_at(segment + i);
+            }
+        }
+    }
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+Alloc ConcurrentVector<T, Alloc, FirstSegmentSize>::GetAllocator() const noexcept {
+    return alloc_;
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+T* ConcurrentVector<T, Alloc, FirstSegmentSize>::GetSegment(size_t segment) {
+    while (true) {
+        if (T* existing = segments_[segment].load(std::memory_order_acquire)) {
+            return existing;
+        }
+        if (!allocating_[segment].exchange(true, std::memory_order_acquire)) {
+            break;
+        }
+        // сегмент выделяет другой поток; если у него не получится, флаг опустится и выделять будет этот
+        allocating_[segment].wait(true, std::memory_order_relaxed);
+    }
+    // флаг поднят этим потоком, но сегмент мог быть опубликован между проверкой и подъёмом флага
+    if (T* existing = segments_[segment].load(std::memory_order_acquire)) {
+        allocating_[segment].store(false, std::memory_order_release);
+        allocating_[segment].notify_all();
+        return existing;
+    }
+    const size_t size = Layout::SegmentSize(segment);
+    FlagAlloc flag_alloc(alloc_);
+    std::atomic<bool>* flags = nullptr;
+    T* buffer;
+    try {
+        flags = FlagAllocTraits::allocate(flag_alloc, size);
+        std::uninitialized_value_construct_n(flags, size);
+        buffer = AllocTraits::allocate(alloc_, size);
+    } catch (...) {
+        if (flags != nullptr) {
+            FlagAllocTraits::deallocate(flag_alloc, flags, size);
+        }
+        allocating_[segment].store(false, std::memory_order_release);
+        allocating_[segment].notify_all();
+        throw;
+    }
+    // признаки публикуются раньше сегмента: кто увидел сегмент, увидит и их
+    published_[segment].store(flags, std::memory_order_release);
+    segments_[segment].store(buffer, std::memory_order_release);
+    allocating_[segment].store(false, std::memory_order_release);
+    allocating_[segment].notify_all();
+    return buffer;
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+template<typename Construct>
+void ConcurrentVector<T, Alloc, FirstSegmentSize>::ConstructRange(size_t first, size_t count, Construct construct) {
+    size_t index = first;
+    const size_t last = first + count;
+    while (index != last) {
+        const size_t k = Layout::SegmentOf(index);
+        T* segment = GetSegment(k);
+        const size_t segment_end = std::min(last, Layout::SegmentBase(k) + Layout::SegmentSize(k));
+        for (; index != segment_end; ++index) {
+            construct(segment + (index - Layout::SegmentBase(k)));
+            Flag(index).store(true, std::memory_order_release);
+        }
+    }
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+T* ConcurrentVector<T, Alloc, FirstSegmentSize>::Slot(size_t index) const noexcept {
+    const size_t k = Layout::SegmentOf(index);
+    return segments_[k].load(std::memory_order_acquire) + (index - Layout::SegmentBase(k));
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+std::atomic<bool>& ConcurrentVector<T, Alloc, FirstSegmentSize>::Flag(size_t index) const noexcept {
+    const size_t k = Layout::SegmentOf(index);
+    return published_[k].load(std::memory_order_acquire)[index - Layout::SegmentBase(k)];
+}
@@ -0,0 +1,424 @@
+#pragma once
+#include "vector.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/// Вектор с копированием при записи: копии разделяют один неизменяемый блок со счётчиком ссылок,
+/// поэтому копирование стоит одного атомарного инкремента. Первый изменяющий вызов у копии,
+/// блок которой разделён с другими, клонирует элементы в собственный блок.
+/// Разные объекты CowVector, разделяющие блок, можно читать и изменять из разных потоков
+/// (как std::shared_ptr); один и тот же объект требует внешней синхронизации.
+/// Неконстантные operator[], begin() и end() считаются изменяющими: для чтения
+/// из неконстантного объекта используйте Get() или std::as_const.
+/// Они и EmplaceBack отдают изменяемую ссылку в блок, который после этого становится
+/// неразделяемым: пока объект им владеет, копирование клонирует элементы, чтобы запись
+/// через сохранённую ссылку не изменила копию
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth>
+class CowVector {
+    using Data = Vector<T, Alloc, Growth>;
+
+    struct Block {
+        explicit Block(Data&& data) noexcept
+                : data(std::move(data))  //
+        {
+        }
+
+        std::atomic<size_t> refs{1};
+        /// сбрасывается, когда наружу отдана изменяемая ссылка; в этот момент блоком владеет
+        /// один объект, поэтому флаг меняется и читается только под его синхронизацией
+        bool shareable = true;
+        Data data;
+    };
+
+    using BlockAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Block>;
+    using BlockTraits = std::allocator_traits<BlockAlloc>;
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+    using allocator_type = Alloc;
+
+    CowVector() = default;
+
+    explicit CowVector(const Alloc& alloc) noexcept;
+
+    /// Забирает элементы data в новый блок без копирования
+    explicit CowVector(Data data);
+
+    /// Разделяет блок other: O(1). Неразделяемый блок клонируется
+    CowVector(const CowVector& other);
+
+    /// Разделяет блок rhs. Если аллокаторы различны, а аллокатор нельзя присвоить
+    /// (как std::pmr::polymorphic_allocator), элементы копируются в память текущего аллокатора
+    CowVector& operator=(const CowVector& rhs);
+
+    CowVector(CowVector&& other) noexcept;
+    CowVector& operator=(CowVector&& rhs) noexcept;
+
+    ~CowVector();
+
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+    /// Клонируют элементы, если блок разделён
+    iterator begin();
+    iterator end();
+
+    [[nodiscard]] size_t Size() const noexcept;
+    [[nodiscard]] size_t Capacity() const noexcept;
+    [[nodiscard]] bool IsEmpty() const noexcept;
+
+    const T& operator[](size_t index) const noexcept;
+    /// Клонирует элементы, если блок разделён
+    T& operator[](size_t index);
+
+    /// Неизменяемое содержимое; пустой вектор, если блока нет
+    [[nodiscard]] const Data& Get() const noexcept;
+
+    /// Количество объектов CowVector, разделяющих блок (0, если блока нет)
+    [[nodiscard]] size_t UseCount() const noexcept;
+
+    /// Изменяющие операции. Если блок разделён, элементы сначала клонируются в новый блок,
+    /// а при исключении объект продолжает разделять прежний блок
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args);
+    template <typename Type>
+    void PushBack(Type&& value);
+    void PopBack();
+    const_iterator Erase(const_iterator pos);
+    const_iterator Erase(const_iterator first, const_iterator last);
+    template <typename... Args>
+    const_iterator Emplace(const_iterator pos, Args&&... args);
+    void Reserve(size_t new_capacity);
+    void Resize(size_t new_size);
+    /// Отпускает блок, не клонируя его
+    void Clear() noexcept;
+
+    /// Вызывает op(Data&) над собственной копией элементов, клонируя их при необходимости,
+    /// и возвращает её результат. Подходит для серии изменений с одним клонированием
+    template <typename Operation>
+    decltype(auto) Modify(Operation op);
+
+    void Swap(CowVector& other) noexcept;
+
+    [[nodiscard]] Alloc GetAllocator() const noexcept;
+
+private:
+    [[no_unique_address]] Alloc alloc_;
+    Block* block_ = nullptr;
+
+    /// выполняет op над элементами, которыми владеет только этот объект. Разделённый блок
+    /// клонируется с запасом вместимости под extra элементов и отпускается после op,
+    /// так как аргументы op могут ссылаться на его элементы
+    template <typename Operation>
+    decltype(auto) Mutate(size_t extra, Operation op, bool unshare = false);
+
+    /// значение unshare для операций, отдающих изменяемую ссылку
+    static constexpr bool UNSHARE = true;
+
+    /// новая ссылка на блок для копии: сам блок или, если он неразделяемый, его клон в памяти alloc
+    Block* Share(const Alloc& alloc) const;
+
+    Block* MakeBlock(Data&& data);
+    void Release(Block* block) noexcept;
+
+}; // class CowVector
+
+template<typename T, typename Alloc, typename Growth>
+CowVector<T, Alloc, Growth>::CowVector(const Alloc& alloc) noexcept
+        : alloc_(alloc)  //
+{
+}
+
+template<typename T, typename Alloc, typename Growth>
+CowVector<T, Alloc, Growth>::CowVector(Data data)
+        : alloc_(data.GetAllocator())
+        , block_(data.Capacity() == 0 ? nullptr : MakeBlock(std::move(data)))  //
+{
+}
+
+template<typename T, typename Alloc, typename Growth>
+CowVector<T, Alloc, Growth>::CowVector(const CowVector& other)
+        : alloc_(other.alloc_)
+        , block_(other.Share(alloc_))  //
+{
+}
+
+template<typename T, typename Alloc, typename Growth>
+CowVector<T, Alloc, Growth>& CowVector<T, Alloc, Growth>::operator=(const CowVector& rhs) {
+    if (block_ == rhs.block_) {
+        return *this;
+    }
+    if constexpr (!std::is_copy_assignable_v<Alloc>) {
+        if (alloc_ != rhs.alloc_) {
+            Block* copy = rhs.block_ == nullptr ? nullptr : MakeBlock(Data(rhs.block_->data, alloc_));
+            Release(std::exchange(block_, copy));
+            return *this;
+        }
+    }
+    Block* shared = rhs.Share(rhs.alloc_);
+    Release(std::exchange(block_, shared));
+    if constexpr (std::is_copy_assignable_v<Alloc>) {
+        alloc_ = rhs.alloc_;
+    }
+    return *this;
+}
+
+template<typename T, typename Alloc, typename Growth>
+CowVector<T, Alloc, Growth>::CowVector(CowVector&& other) noexcept
+        : alloc_(other.alloc_)
+        , block_(std::exchange(other.block_, nullptr))  //
+{
+}
+
+template<typename T, typename Alloc, typename Growth>
+CowVector<T, Alloc, Growth>& CowVector<T, Alloc, Growth>::operator=(CowVector&& rhs) noexcept {
+    if (this != &rhs) {
+        Release(std::exchange(block_, std::exchange(rhs.block_, nullptr)));
+        if constexpr (std::is_copy_assignable_v<Alloc>) {
+            alloc_ = rhs.alloc_;
+        } else {
+            assert(alloc_ == rhs.alloc_);
+        }
+    }
+    return *this;
+}
+
+template<typename T, typename Alloc, typename Growth>
+CowVector<T, Alloc, Growth>::~CowVector() {
+    Release(block_);
+}
+
+template<typename T, typename Alloc, typename Growth>
+typename CowVector<T, Alloc, Growth>::const_iterator CowVector<T, Alloc, Growth>::begin() const noexcept {
+    return Get().begin();
+}
+
+template<typename T, typename Alloc, typename Growth>
+typename CowVector<T, Alloc, Growth>::const_iterator CowVector<T, Alloc, Growth>::end() const noexcept {
+    return Get().end();
+}
+
+template<typename T, typename Alloc, typename Growth>
+typename CowVector<T, Alloc, Growth>::const_iterator CowVector<T, Alloc, Growth>::cbegin() const noexcept {
+    return begin();
+}
+
+template<typename T, typename Alloc, typename Growth>
+typename CowVector<T, Alloc, Growth>::const_iterator CowVector<T, Alloc, Growth>::cend() const noexcept {
+    return end();
+}
+
+template<typename T, typename Alloc, typename Growth>
+typename CowVector<T, Alloc, Growth>::iterator CowVector<T, Alloc, Growth>::begin() {
+    if (block_ == nullptr) {
+        return nullptr;
+    }
+    return Mutate(0, [](Data& data) { return data.begin(); }, UNSHARE);
+}
+
+template<typename T, typename Alloc, typename Growth>
+typename CowVector<T, Alloc, Growth>::iterator CowVector<T, Alloc, Growth>::end() {
+    if (block_ == nullptr) {
+        return nullptr;
+    }
+    return Mutate(0, [](Data& data) { return data.end(); }, UNSHARE);
+}
+
+template<typename T, typename Alloc, typename Growth>
+size_t CowVector<T, Alloc, Growth>::Size() const noexcept {
+    return Get().Size();
+}
+
+template<typename T, typename Alloc, typename Growth>
+size_t CowVector<T, Alloc, Growth>::Capacity() const noexcept {
+    return Get().Capacity();
+}
+
+template<typename T, typename Alloc, typename Growth>
+bool CowVector<T, Alloc, Growth>::IsEmpty() const noexcept {
+    return Get().IsEmpty();
+}
+
+template<typename T, typename Alloc, typename Growth>
+const T& CowVector<T, Alloc, Growth>::operator[](size_t index) const noexcept {
+    return Get()[index];
+}
+
+template<typename T, typename Alloc, typename Growth>
+T& CowVector<T, Alloc, Growth>::operator[](size_t index) {
+    assert(index < Size());
+    return Mutate(0, [index](Data& data) -> T& { return data[index]; }, UNSHARE);
+}
+
+template<typename T, typename Alloc, typename Growth>
+const typename CowVector<T, Alloc, Growth>::Data& CowVector<T, Alloc, Growth>::Get() const noexcept {
+    static const Data EMPTY;
+    return block_ == nullptr ? EMPTY : block_->data;
+}
+
+template<typename T, typename Alloc, typename Growth>
+size_t CowVector<T, Alloc, Growth>::UseCount() const noexcept {
+    return block_ == nullptr ? 0 : block_->refs.load(std::memory_order_relaxed);
+}
+
+template<typename T, typename Alloc, typename Growth>
+template<typename... Args>
+T& CowVector<T, Alloc, Growth>::EmplaceBack(Args&&... args) {
+    return Mutate(1, [&args...](Data& data) -> T& { return data.EmplaceBack(std::forward<Args>(args)...); },
+                  UNSHARE);
+}
+
+template<typename T, typename Alloc, typename Growth>
+template<typename Type>
+void CowVector<T, Alloc, Growth>::PushBack(Type&& value) {
+    /// в отличие от EmplaceBack ссылка на элемент наружу не попадает, и блок остаётся разделяемым
+    Mutate(1, [&value](Data& data) { data.EmplaceBack(std::forward<Type>(value)); });
+}
+
+template<typename T, typename Alloc, typename Growth>
+void CowVector<T, Alloc, Growth>::PopBack() {
+    assert(!IsEmpty());
+    Mutate(0, [](Data& data) { data.PopBack(); });
+}
+
+template<typename T, typename Alloc, typename Growth>
+typename CowVector<T, Alloc, Growth>::const_iterator CowVector<T, Alloc, Growth>::Erase(const_iterator pos) {
+    return Erase(pos, pos + 1);
+}
+
+template<typename T, typename Alloc, typename Growth>
+typename CowVector<T, Alloc, Growth>::const_iterator CowVector<T, Alloc, Growth>::Erase(const_iterator first,
+                                                                                                const_iterator last) {
+    /// итераторы указывают в разделённый блок, поэтому до клонирования переводятся в индексы
+    const size_t index = first - std::as_const(*this).begin();
+    const size_t count = last - first;
+    if (count == 0) {
+        return first;
+    }
+    return Mutate(0, [index, count](Data& data) -> const_iterator {
+        return data.Erase(data.begin() + index, data.begin() + index + count);
+    });
+}
+
+template<typename T, typename Alloc, typename Growth>
+template<typename... Args>
+typename CowVector<T, Alloc, Growth>::const_iterator CowVector<T, Alloc, Growth>::Emplace(const_iterator pos,
+                                                                                                  Args&&... args) {
+    const size_t index = pos - std::as_const(*this).begin();
+    return Mutate(1, [index, &args...](Data& data) -> const_iterator {
+        return data.Emplace(data.begin() + index, std::forward<Args>(args)...);
+    });
+}
+
+template<typename T, typename Alloc, typename Growth>
+void CowVector<T, Alloc, Growth>::Reserve(size_t new_capacity) {
+    if (new_capacity > Capacity()) {
+        Mutate(new_capacity - Size(), [new_capacity](Data& data) { data.Reserve(new_capacity); });
+    }
+}
+
+template<typename T, typename Alloc, typename Growth>
+void CowVector<T, Alloc, Growth>::Resize(size_t new_size) {
+    Mutate(new_size > Size() ? new_size - Size() : 0, [new_size](Data& data) { data.Resize(new_size); });
+}
+
+template<typename T, typename Alloc, typename Growth>
+void CowVector<T, Alloc, Growth>::Clear() noexcept {
+    Release(std::exchange(block_, nullptr));
+}
+
+template<typename T, typename Alloc, typename Growth>
+template<typename Operation>
+decltype(auto) CowVector<T, Alloc, Growth>::Modify(Operation op) {
+    return Mutate(0, std::move(op));
+}
+
+template<typename T, typename Alloc, typename Growth>
+void CowVector<T, Alloc, Growth>::Swap(CowVector& other) noexcept {
+    std::swap(block_, other.block_);
+    if constexpr (std::is_copy_assignable_v<Alloc>) {
+        std::swap(alloc_, other.alloc_);
+    } else {
+        assert(alloc_ == other.alloc_);
+    }
+}
+
+template<typename T, typename Alloc, typename Growth>
+Alloc CowVector<T, Alloc, Growth>::GetAllocator() const noexcept {
+    return alloc_;
+}
+
+template<typename T, typename Alloc, typename Growth>
+template<typename Operation>
+decltype(auto) CowVector<T, Alloc, Growth>::Mutate(size_t extra, Operation op, bool unshare) {
+    Block* shared = nullptr;
+    if (block_ == nullptr) {
+        block_ = MakeBlock(Data(alloc_));
+    } else if (block_->refs.load(std::memory_order_acquire) != 1) {
+        const Data& data = block_->data;
+        Data copy(alloc_);
+        copy.Reserve(extra == 0 ? data.Size() : Growth::Grow(data.Size(), data.Size() + extra, sizeof(T)));
+        copy.AppendRange(data);
+        shared = std::exchange(block_, MakeBlock(std::move(copy)));
+    }
+    if (unshare) {
+        /// блоком владеет только этот объект: флаг сбрасывается до того, как op отдаст ссылку
+        block_->shareable = false;
+    }
+    if (shared == nullptr) {
+        return op(block_->data);
+    }
+    /// при исключении клон уничтожается, и объект снова разделяет прежний блок
+    try {
+        if constexpr (std::is_void_v<decltype(op(block_->data))>) {
+            op(block_->data);
+            Release(shared);
+            return;
+        } else {
+            decltype(auto) result = op(block_->data);
+            Release(shared);
+            return static_cast<decltype(result)>(result);
+        }
+    } catch (...) {
+        Release(std::exchange(block_, shared));
+        throw;
+    }
+}
+
+template<typename T, typename Alloc, typename Growth>
+typename CowVector<T, Alloc, Growth>::Block* CowVector<T, Alloc, Growth>::Share(const Alloc& alloc) const {
+    if (block_ == nullptr) {
+        return nullptr;
+    }
+    if (!block_->shareable) {
+        CowVector copy(Data(block_->data, alloc));
+        return std::exchange(copy.block_, nullptr);
+    }
+    /// новая ссылка появляется от уже существующей, поэтому упорядочивание не нужно
+    block_->refs.fetch_add(1, std::memory_order_relaxed);
+    return block_;
+}
+
+template<typename T, typename Alloc, typename Growth>
+typename CowVector<T, Alloc, Growth>::Block* CowVector<T, Alloc, Growth>::MakeBlock(Data&& data) {
+    BlockAlloc block_alloc(alloc_);
+    Block* block = BlockTraits::allocate(block_alloc, 1);
+    std::construct_at(block, std::move(data));
+    return block;
+}
+
+template<typename T, typename Alloc, typename Growth>
+void CowVector<T, Alloc, Growth>::Release(Block* block) noexcept {
+    /// последний владелец должен видеть все записи остальных владельцев в блок до их отказа от него
+    if (block != nullptr && block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        BlockAlloc block_alloc(alloc_);
+        std::destroy_at(block);
+        BlockTraits::deallocate(block_alloc, block, 1);
+    }
+}
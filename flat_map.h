@@ -0,0 +1,919 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace flat_map_detail {
+
+/// Компаратор с is_transparent позволяет искать по значению, сравнимому с ключом (например, string_view)
+template <typename Compare>
+concept Transparent = requires { typename Compare::is_transparent; };
+
+/// Индекс первого элемента [data, data + size), для которого pred ложен; элементы разбиты по pred.
+/// Интервал поиска сокращается вдвое без условных переходов: выбор половины компилируется
+/// в cmov, поэтому время поиска не зависит от ошибок предсказания ветвлений
+template <typename T, typename Predicate>
+size_t PartitionPoint(const T* data, size_t size, Predicate pred) {
+    const T* base = data;
+    while (size > 1) {
+        const size_t half = size / 2;
+        base = pred(base[half - 1]) ? base + half : base;
+        size -= half;
+    }
+    return static_cast<size_t>(base - data) + (size == 1 && pred(*base));
+}
+
+template <typename T, typename K, typename Compare>
+size_t LowerBound(const T* data, size_t size, const K& key, const Compare& comp) {
+    return PartitionPoint(data, size, [&](const T& value) { return comp(value, key); });
+}
+
+template <typename T, typename K, typename Compare>
+size_t UpperBound(const T* data, size_t size, const K& key, const Compare& comp) {
+    return PartitionPoint(data, size, [&](const T& value) { return !comp(key, value); });
+}
+
+}  // namespace flat_map_detail
+
+/// Множество уникальных ключей, хранящихся по порядку в одном Vector.
+/// Поиск — двоичный без ветвлений по непрерывному массиву, вставка и удаление сдвигают хвост.
+/// Итераторы константны и становятся недействительными при любом изменении множества
+template <typename Key, typename Compare = std::less<Key>, typename Alloc = std::allocator<Key>>
+class FlatSet {
+public:
+    using key_type = Key;
+    using iterator = const Key*;
+    using const_iterator = const Key*;
+    using allocator_type = Alloc;
+
+    FlatSet() = default;
+
+    explicit FlatSet(const Compare& comp, const Alloc& alloc = Alloc());
+
+    /// Сортирует элементы диапазона и удаляет повторы; из равных остаётся первый
+    template <std::ranges::input_range Range>
+    explicit FlatSet(Range&& range, const Compare& comp = Compare(), const Alloc& alloc = Alloc());
+
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    [[nodiscard]] size_t Size() const noexcept;
+    [[nodiscard]] size_t Capacity() const noexcept;
+    [[nodiscard]] bool IsEmpty() const noexcept;
+    const Key& operator[](size_t index) const noexcept;
+
+    void Reserve(size_t new_capacity);
+    void ShrinkToFit();
+    void Clear() noexcept;
+
+    const_iterator Find(const Key& key) const;
+    [[nodiscard]] bool Contains(const Key& key) const;
+    const_iterator LowerBound(const Key& key) const;
+    const_iterator UpperBound(const Key& key) const;
+
+    template <typename K>
+        requires flat_map_detail::Transparent<Compare>
+    const_iterator Find(const K& key) const;
+    template <typename K>
+        requires flat_map_detail::Transparent<Compare>
+    [[nodiscard]] bool Contains(const K& key) const;
+    template <typename K>
+        requires flat_map_detail::Transparent<Compare>
+    const_iterator LowerBound(const K& key) const;
+    template <typename K>
+        requires flat_map_detail::Transparent<Compare>
+    const_iterator UpperBound(const K& key) const;
+
+    /// Возвращает позицию ключа и признак того, что он был вставлен
+    std::pair<const_iterator, bool> Insert(const Key& key);
+    std::pair<const_iterator, bool> Insert(Key&& key);
+
+    /// Вставляет отсортированный по Compare диапазон: элементы дописываются в конец
+    /// одной вставкой AppendRange и сливаются с прежними за один проход.
+    /// Ключи, которые уже есть в множестве, не вставляются
+    template <std::ranges::input_range Range>
+    void InsertSorted(Range&& range);
+
+    /// Удаляет ключ и возвращает количество удалённых элементов (0 или 1)
+    size_t Erase(const Key& key);
+    const_iterator Erase(const_iterator pos);
+
+    void Swap(FlatSet& other) noexcept;
+
+    [[nodiscard]] std::span<const Key> Keys() const noexcept;
+
+private:
+    [[no_unique_address]] Compare comp_;
+    Vector<Key, Alloc> keys_;
+
+    template <typename K>
+    const_iterator FindImpl(const K& key) const;
+
+    template <typename K>
+    std::pair<const_iterator, bool> InsertImpl(K&& key);
+
+    /// элементы начиная с old_size отсортированы: сливает их с предыдущими и удаляет повторы
+    void MergeTail(size_t old_size);
+
+}; // class FlatSet
+
+/// Отображение с ключами и значениями в двух отдельных Vector: поиск читает только массив ключей,
+/// поэтому в кэш не попадают значения. Итератор возвращает пару ссылок std::pair<const Key&, Value&>,
+/// итераторы становятся недействительными при вставке и удалении
+template <typename Key, typename Value, typename Compare = std::less<Key>,
+          typename KeyAlloc = std::allocator<Key>, typename ValueAlloc = std::allocator<Value>>
+class FlatMap {
+    template <bool IsConst>
+    class Iterator;
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    FlatMap() = default;
+
+    explicit FlatMap(const Compare& comp, const KeyAlloc& key_alloc = KeyAlloc(),
+                     const ValueAlloc& value_alloc = ValueAlloc());
+
+    iterator begin() noexcept;
+    iterator end() noexcept;
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    [[nodiscard]] size_t Size() const noexcept;
+    [[nodiscard]] size_t Capacity() const noexcept;
+    [[nodiscard]] bool IsEmpty() const noexcept;
+
+    /// Резервирует место под new_capacity элементов в обоих массивах
+    void Reserve(size_t new_capacity);
+    void ShrinkToFit();
+    void Clear() noexcept;
+
+    iterator Find(const Key& key);
+    const_iterator Find(const Key& key) const;
+    [[nodiscard]] bool Contains(const Key& key) const;
+    iterator LowerBound(const Key& key);
+    const_iterator LowerBound(const Key& key) const;
+
+    template <typename K>
+        requires flat_map_detail::Transparent<Compare>
+    iterator Find(const K& key);
+    template <typename K>
+        requires flat_map_detail::Transparent<Compare>
+    const_iterator Find(const K& key) const;
+    template <typename K>
+        requires flat_map_detail::Transparent<Compare>
+    [[nodiscard]] bool Contains(const K& key) const;
+    template <typename K>
+        requires flat_map_detail::Transparent<Compare>
+    iterator LowerBound(const K& key);
+    template <typename K>
+        requires flat_map_detail::Transparent<Compare>
+    const_iterator LowerBound(const K& key) const;
+
+    /// Значение по ключу; если ключа нет, выбрасывает std::out_of_range
+    Value& At(const Key& key);
+    const Value& At(const Key& key) const;
+
+    /// Значение по ключу; если ключа нет, вставляет значение по умолчанию
+    Value& operator[](const Key& key);
+    Value& operator[](Key&& key);
+
+    /// Если ключа нет, вставляет значение, созданное из args; иначе ничего не делает.
+    /// При исключении отображение не меняется
+    template <typename... Args>
+    std::pair<iterator, bool> TryEmplace(const Key& key, Args&&... args);
+    template <typename... Args>
+    std::pair<iterator, bool> TryEmplace(Key&& key, Args&&... args);
+
+    template <typename V>
+    std::pair<iterator, bool> InsertOrAssign(const Key& key, V&& value);
+
+    /// Вставляет отсортированный по ключу диапазон пар (ключ, значение): ключи и значения дописываются
+    /// в конец своих массивов одной вставкой AppendRange и сливаются с прежними за один проход.
+    /// Ключи, которые уже есть в отображении, не вставляются, а значения для них не меняются
+    template <std::ranges::forward_range Range>
+    void InsertSorted(Range&& range);
+
+    size_t Erase(const Key& key);
+    iterator Erase(const_iterator pos);
+
+    void Swap(FlatMap& other) noexcept;
+
+    [[nodiscard]] std::span<const Key> Keys() const noexcept;
+    [[nodiscard]] std::span<Value> Values() noexcept;
+    [[nodiscard]] std::span<const Value> Values() const noexcept;
+
+private:
+    [[no_unique_address]] Compare comp_;
+    Vector<Key, KeyAlloc> keys_;
+    Vector<Value, ValueAlloc> values_;
+
+    /// индекс ключа или Size(), если его нет
+    template <typename K>
+    size_t IndexOf(const K& key) const;
+
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> TryEmplaceImpl(K&& key, Args&&... args);
+
+    /// ключи и значения переставляются на месте, только если их перенос не бросает исключений
+    static constexpr bool NOTHROW_MOVE =
+            std::is_nothrow_move_constructible_v<Key> && std::is_nothrow_move_assignable_v<Key>
+            && std::is_nothrow_move_constructible_v<Value> && std::is_nothrow_move_assignable_v<Value>;
+
+    /// элементы начиная с old_size отсортированы: сливает их с предыдущими и удаляет повторы.
+    /// Если слияние не удалось, дописанный хвост удаляется и отображение остаётся прежним
+    void MergeTail(size_t old_size);
+
+    /// то же для элементов, перенос которых может бросить: результат собирается в новых массивах,
+    /// прежние элементы при этом копируются, если их перемещение может бросить (std::move_if_noexcept)
+    void MergeTailCopy(size_t old_size);
+
+}; // class FlatMap
+
+/// Итератор произвольного доступа: указатель на отображение и индекс элемента
+template <typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+template <bool IsConst>
+class FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::Iterator {
+    using Owner = std::conditional_t<IsConst, const FlatMap, FlatMap>;
+
+public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::pair<Key, Value>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = std::pair<const Key&, std::conditional_t<IsConst, const Value&, Value&>>;
+
+    Iterator() = default;
+
+    Iterator(Owner* owner, size_t index) noexcept
+            : owner_(owner)
+            , index_(index)  //
+    {
+    }
+
+    /// неконстантный итератор преобразуется в константный
+    operator Iterator<true>() const noexcept requires(!IsConst) {
+        return {owner_, index_};
+    }
+
+    reference operator*() const noexcept {
+        return {owner_->keys_[index_], owner_->values_[index_]};
+    }
+
+    reference operator[](difference_type n) const noexcept {
+        return *(*this + n);
+    }
+
+    /// индекс элемента в Keys() и Values()
+    [[nodiscard]] size_t Index() const noexcept {
+        return index_;
+    }
+
+    Iterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+
+    Iterator operator++(int) noexcept {
+        Iterator copy = *this;
+        ++index_;
+        return copy;
+    }
+
+    Iterator& operator--() noexcept {
+        --index_;
+        return *this;
+    }
+
+    Iterator operator--(int) noexcept {
+        Iterator copy = *this;
+        --index_;
+        return copy;
+    }
+
+    Iterator& operator+=(difference_type n) noexcept {
+        index_ += n;
+        return *this;
+    }
+
+    Iterator& operator-=(difference_type n) noexcept {
+        index_ -= n;
+        return *this;
+    }
+
+    friend Iterator operator+(Iterator it, difference_type n) noexcept {
+        return it += n;
+    }
+
+    friend Iterator operator+(difference_type n, Iterator it) noexcept {
+        return it += n;
+    }
+
+    friend Iterator operator-(Iterator it, difference_type n) noexcept {
+        return it -= n;
+    }
+
+    friend difference_type operator-(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+    }
+
+    friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return lhs.index_ == rhs.index_;
+    }
+
+    friend auto operator<=>(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return lhs.index_ <=> rhs.index_;
+    }
+
+private:
+    Owner* owner_ = nullptr;
+    size_t index_ = 0;
+};
+
+template<typename Key, typename Compare, typename Alloc>
+FlatSet<Key, Compare, Alloc>::FlatSet(const Compare& comp, const Alloc& alloc)
+        : comp_(comp)
+        , keys_(alloc)  //
+{
+}
+
+template<typename Key, typename Compare, typename Alloc>
+template<std::ranges::input_range Range>
+FlatSet<Key, Compare, Alloc>::FlatSet(Range&& range, const Compare& comp, const Alloc& alloc)
+        : FlatSet(comp, alloc)  //
+{
+    keys_.AppendRange(std::forward<Range>(range));
+    std::stable_sort(keys_.begin(), keys_.end(), comp_);
+    MergeTail(0);
+}
+
+template<typename Key, typename Compare, typename Alloc>
+typename FlatSet<Key, Compare, Alloc>::const_iterator FlatSet<Key, Compare, Alloc>::begin() const noexcept {
+    return keys_.begin();
+}
+
+template<typename Key, typename Compare, typename Alloc>
+typename FlatSet<Key, Compare, Alloc>::const_iterator FlatSet<Key, Compare, Alloc>::end() const noexcept {
+    return keys_.end();
+}
+
+template<typename Key, typename Compare, typename Alloc>
+typename FlatSet<Key, Compare, Alloc>::const_iterator FlatSet<Key, Compare, Alloc>::cbegin() const noexcept {
+    return keys_.begin();
+}
+
+template<typename Key, typename Compare, typename Alloc>
+typename FlatSet<Key, Compare, Alloc>::const_iterator FlatSet<Key, Compare, Alloc>::cend() const noexcept {
+    return keys_.end();
+}
+
+template<typename Key, typename Compare, typename Alloc>
+size_t FlatSet<Key, Compare, Alloc>::Size() const noexcept {
+    return keys_.Size();
+}
+
+template<typename Key, typename Compare, typename Alloc>
+size_t FlatSet<Key, Compare, Alloc>::Capacity() const noexcept {
+    return keys_.Capacity();
+}
+
+template<typename Key, typename Compare, typename Alloc>
+bool FlatSet<Key, Compare, Alloc>::IsEmpty() const noexcept {
+    return keys_.IsEmpty();
+}
+
+template<typename Key, typename Compare, typename Alloc>
+const Key& FlatSet<Key, Compare, Alloc>::operator[](size_t index) const noexcept {
+    return keys_[index];
+}
+
+template<typename Key, typename Compare, typename Alloc>
+void FlatSet<Key, Compare, Alloc>::Reserve(size_t new_capacity) {
+    keys_.Reserve(new_capacity);
+}
+
+template<typename Key, typename Compare, typename Alloc>
+void FlatSet<Key, Compare, Alloc>::ShrinkToFit() {
+    keys_.ShrinkToFit();
+}
+
+template<typename Key, typename Compare, typename Alloc>
+void FlatSet<Key, Compare, Alloc>::Clear() noexcept {
+    keys_.Erase(keys_.begin(), keys_.end());
+}
+
+template<typename Key, typename Compare, typename Alloc>
+typename FlatSet<Key, Compare, Alloc>::const_iterator FlatSet<Key, Compare, Alloc>::Find(const Key& key) const {
+    return FindImpl(key);
+}
+
+template<typename Key, typename Compare, typename Alloc>
+bool FlatSet<Key, Compare, Alloc>::Contains(const Key& key) const {
+    return FindImpl(key) != end();
+}
+
+template<typename Key, typename Compare, typename Alloc>
+typename FlatSet<Key, Compare, Alloc>::const_iterator FlatSet<Key, Compare, Alloc>::LowerBound(const Key& key) const {
+    return begin() + flat_map_detail::LowerBound(keys_.begin(), keys_.Size(), key, comp_);
+}
+
+template<typename Key, typename Compare, typename Alloc>
+typename FlatSet<Key, Compare, Alloc>::const_iterator FlatSet<Key, Compare, Alloc>::UpperBound(const Key& key) const {
+    return begin() + flat_map_detail::UpperBound(keys_.begin(), keys_.Size(), key, comp_);
+}
+
+template<typename Key, typename Compare, typename Alloc>
+template<typename K>
+    requires flat_map_detail::Transparent<Compare>
+typename FlatSet<Key, Compare, Alloc>::const_iterator FlatSet<Key, Compare, Alloc>::Find(const K& key) const {
+    return FindImpl(key);
+}
+
+template<typename Key, typename Compare, typename Alloc>
+template<typename K>
+    requires flat_map_detail::Transparent<Compare>
+bool FlatSet<Key, Compare, Alloc>::Contains(const K& key) const {
+    return FindImpl(key) != end();
+}
+
+template<typename Key, typename Compare, typename Alloc>
+template<typename K>
+    requires flat_map_detail::Transparent<Compare>
+typename FlatSet<Key, Compare, Alloc>::const_iterator FlatSet<Key, Compare, Alloc>::LowerBound(const K& key) const {
+    return begin() + flat_map_detail::LowerBound(keys_.begin(), keys_.Size(), key, comp_);
+}
+
+template<typename Key, typename Compare, typename Alloc>
+template<typename K>
+    requires flat_map_detail::Transparent<Compare>
+typename FlatSet<Key, Compare, Alloc>::const_iterator FlatSet<Key, Compare, Alloc>::UpperBound(const K& key) const {
+    return begin() + flat_map_detail::UpperBound(keys_.begin(), keys_.Size(), key, comp_);
+}
+
+template<typename Key, typename Compare, typename Alloc>
+std::pair<typename FlatSet<Key, Compare, Alloc>::const_iterator, bool> FlatSet<Key, Compare, Alloc>::Insert(const Key& key) {
+    return InsertImpl(key);
+}
+
+template<typename Key, typename Compare, typename Alloc>
+std::pair<typename FlatSet<Key, Compare, Alloc>::const_iterator, bool> FlatSet<Key, Compare, Alloc>::Insert(Key&& key) {
+    return InsertImpl(std::move(key));
+}
+
+template<typename Key, typename Compare, typename Alloc>
+template<std::ranges::input_range Range>
+void FlatSet<Key, Compare, Alloc>::InsertSorted(Range&& range) {
+    const size_t old_size = keys_.Size();
+    keys_.AppendRange(std::forward<Range>(range));
+    assert(std::is_sorted(keys_.begin() + old_size, keys_.end(), comp_));
+    MergeTail(old_size);
+}
+
+template<typename Key, typename Compare, typename Alloc>
+size_t FlatSet<Key, Compare, Alloc>::Erase(const Key& key) {
+    const_iterator pos = FindImpl(key);
+    if (pos == end()) {
+        return 0;
+    }
+    keys_.Erase(pos);
+    return 1;
+}
+
+template<typename Key, typename Compare, typename Alloc>
+typename FlatSet<Key, Compare, Alloc>::const_iterator FlatSet<Key, Compare, Alloc>::Erase(const_iterator pos) {
+    return keys_.Erase(pos);
+}
+
+template<typename Key, typename Compare, typename Alloc>
+void FlatSet<Key, Compare, Alloc>::Swap(FlatSet& other) noexcept {
+    using std::swap;
+    swap(comp_, other.comp_);
+    keys_.Swap(other.keys_);
+}
+
+template<typename Key, typename Compare, typename Alloc>
+std::span<const Key> FlatSet<Key, Compare, Alloc>::Keys() const noexcept {
+    return {keys_.begin(), keys_.Size()};
+}
+
+template<typename Key, typename Compare, typename Alloc>
+template<typename K>
+typename FlatSet<Key, Compare, Alloc>::const_iterator FlatSet<Key, Compare, Alloc>::FindImpl(const K& key) const {
+    const size_t index = flat_map_detail::LowerBound(keys_.begin(), keys_.Size(), key, comp_);
+    if (index != keys_.Size() && !comp_(key, keys_[index])) {
+        return begin() + index;
+    }
+    return end();
+}
+
+template<typename Key, typename Compare, typename Alloc>
+template<typename K>
+std::pair<typename FlatSet<Key, Compare, Alloc>::const_iterator, bool> FlatSet<Key, Compare, Alloc>::InsertImpl(K&& key) {
+    const size_t index = flat_map_detail::LowerBound(keys_.begin(), keys_.Size(), key, comp_);
+    if (index != keys_.Size() && !comp_(key, keys_[index])) {
+        return {begin() + index, false};
+    }
+    return {keys_.Insert(keys_.begin() + index, std::forward<K>(key)), true};
+}
+
+template<typename Key, typename Compare, typename Alloc>
+void FlatSet<Key, Compare, Alloc>::MergeTail(size_t old_size) {
+    Key* first = keys_.begin();
+    Key* middle = first + old_size;
+    Key* last = keys_.end();
+    if (middle == last) {
+        return;
+    }
+    /// если все новые ключи больше прежних, сливать нечего, и повторы ищутся только в хвосте
+    Key* unique_from = first;
+    if (middle == first || comp_(*(middle - 1), *middle)) {
+        unique_from = old_size == 0 ? first : middle - 1;
+    } else {
+        /// слияние устойчиво: из равных ключей прежний оказывается первым и остаётся
+        std::inplace_merge(first, middle, last, comp_);
+    }
+    Key* unique_end = std::unique(unique_from, last, [this](const Key& lhs, const Key& rhs) {
+        return !comp_(lhs, rhs);
+    });
+    keys_.Erase(unique_end, keys_.end());
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::FlatMap(const Compare& comp, const KeyAlloc& key_alloc,
+                                                            const ValueAlloc& value_alloc)
+        : comp_(comp)
+        , keys_(key_alloc)
+        , values_(value_alloc)  //
+{
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+typename FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::iterator FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::begin() noexcept {
+    return {this, 0};
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+typename FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::iterator FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::end() noexcept {
+    return {this, keys_.Size()};
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+typename FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::const_iterator FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::begin() const noexcept {
+    return {this, 0};
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+typename FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::const_iterator FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::end() const noexcept {
+    return {this, keys_.Size()};
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+typename FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::const_iterator FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::cbegin() const noexcept {
+    return begin();
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+typename FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::const_iterator FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::cend() const noexcept {
+    return end();
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+size_t FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::Size() const noexcept {
+    return keys_.Size();
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+size_t FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::Capacity() const noexcept {
+    return std::min(keys_.Capacity(), values_.Capacity());
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+bool FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::IsEmpty() const noexcept {
+    return keys_.IsEmpty();
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+void FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::Reserve(size_t new_capacity) {
+    keys_.Reserve(new_capacity);
+    values_.Reserve(new_capacity);
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+void FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::ShrinkToFit() {
+    keys_.ShrinkToFit();
+    values_.ShrinkToFit();
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+void FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::Clear() noexcept {
+    keys_.Erase(keys_.begin(), keys_.end());
+    values_.Erase(values_.begin(), values_.end());
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+typename FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::iterator FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::Find(const Key& key) {
+    return {this, IndexOf(key)};
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+typename FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::const_iterator FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::Find(const Key& key) const {
+    return {this, IndexOf(key)};
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+bool FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::Contains(const Key& key) const {
+    return IndexOf(key) != keys_.Size();
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+typename FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::iterator FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::LowerBound(const Key& key) {
+    return {this, flat_map_detail::LowerBound(keys_.begin(), keys_.Size(), key, comp_)};
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+typename FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::const_iterator FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::LowerBound(const Key& key) const {
+    return {this, flat_map_detail::LowerBound(keys_.begin(), keys_.Size(), key, comp_)};
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+template<typename K>
+    requires flat_map_detail::Transparent<Compare>
+typename FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::iterator FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::Find(const K& key) {
+    return {this, IndexOf(key)};
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+template<typename K>
+    requires flat_map_detail::Transparent<Compare>
+typename FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::const_iterator FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::Find(const K& key) const {
+    return {this, IndexOf(key)};
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+template<typename K>
+    requires flat_map_detail::Transparent<Compare>
+bool FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::Contains(const K& key) const {
+    return IndexOf(key) != keys_.Size();
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+template<typename K>
+    requires flat_map_detail::Transparent<Compare>
+typename FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::iterator FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::LowerBound(const K& key) {
+    return {this, flat_map_detail::LowerBound(keys_.begin(), keys_.Size(), key, comp_)};
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+template<typename K>
+    requires flat_map_detail::Transparent<Compare>
+typename FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::const_iterator FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::LowerBound(const K& key) const {
+    return {this, flat_map_detail::LowerBound(keys_.begin(), keys_.Size(), key, comp_)};
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+Value& FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::At(const Key& key) {
+    return const_cast<Value&>(std::as_const(*this).At(key));
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+const Value& FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::At(const Key& key) const {
+    const size_t index = IndexOf(key);
+    if (index == keys_.Size()) {
+        throw std::out_of_range("FlatMap::At: key not found");
+    }
+    return values_[index];
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+Value& FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::operator[](const Key& key) {
+    return (*TryEmplaceImpl(key).first).second;
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+Value& FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::operator[](Key&& key) {
+    return (*TryEmplaceImpl(std::move(key)).first).second;
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+template<typename... Args>
+std::pair<typename FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::iterator, bool>
+FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::TryEmplace(const Key& key, Args&&... args) {
+    return TryEmplaceImpl(key, std::forward<Args>(args)...);
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+template<typename... Args>
+std::pair<typename FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::iterator, bool>
+FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::TryEmplace(Key&& key, Args&&... args) {
+    return TryEmplaceImpl(std::move(key), std::forward<Args>(args)...);
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+template<typename V>
+std::pair<typename FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::iterator, bool>
+FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::InsertOrAssign(const Key& key, V&& value) {
+    auto result = TryEmplaceImpl(key, std::forward<V>(value));
+    if (!result.second) {
+        values_[result.first.Index()] = std::forward<V>(value);
+    }
+    return result;
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+template<std::ranges::forward_range Range>
+void FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::InsertSorted(Range&& range) {
+    const size_t old_size = keys_.Size();
+    keys_.AppendRange(range | std::views::keys);
+    try {
+        values_.AppendRange(range | std::views::values);
+    } catch (...) {
+        keys_.Erase(keys_.begin() + old_size, keys_.end());
+        throw;
+    }
+    assert(std::is_sorted(keys_.begin() + old_size, keys_.end(), comp_));
+    MergeTail(old_size);
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+size_t FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::Erase(const Key& key) {
+    const size_t index = IndexOf(key);
+    if (index == keys_.Size()) {
+        return 0;
+    }
+    Erase(const_iterator(this, index));
+    return 1;
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+typename FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::iterator FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::Erase(const_iterator pos) {
+    const size_t index = pos.Index();
+    assert(index < keys_.Size());
+    keys_.Erase(keys_.begin() + index);
+    values_.Erase(values_.begin() + index);
+    return {this, index};
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+void FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::Swap(FlatMap& other) noexcept {
+    using std::swap;
+    swap(comp_, other.comp_);
+    keys_.Swap(other.keys_);
+    values_.Swap(other.values_);
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+std::span<const Key> FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::Keys() const noexcept {
+    return {keys_.begin(), keys_.Size()};
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+std::span<Value> FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::Values() noexcept {
+    return {values_.begin(), values_.Size()};
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+std::span<const Value> FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::Values() const noexcept {
+    return {values_.begin(), values_.Size()};
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+template<typename K>
+size_t FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::IndexOf(const K& key) const {
+    const size_t index = flat_map_detail::LowerBound(keys_.begin(), keys_.Size(), key, comp_);
+    if (index != keys_.Size() && !comp_(key, keys_[index])) {
+        return index;
+    }
+    return keys_.Size();
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+template<typename K, typename... Args>
+std::pair<typename FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::iterator, bool>
+FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::TryEmplaceImpl(K&& key, Args&&... args) {
+    const size_t index = flat_map_detail::LowerBound(keys_.begin(), keys_.Size(), key, comp_);
+    if (index != keys_.Size() && !comp_(key, keys_[index])) {
+        return {iterator(this, index), false};
+    }
+    keys_.Emplace(keys_.begin() + index, std::forward<K>(key));
+    try {
+        values_.Emplace(values_.begin() + index, std::forward<Args>(args)...);
+    } catch (...) {
+        keys_.Erase(keys_.begin() + index);
+        throw;
+    }
+    return {iterator(this, index), true};
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+void FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::MergeTail(size_t old_size) {
+    const size_t size = keys_.Size();
+    if (old_size == size) {
+        return;
+    }
+    if constexpr (!NOTHROW_MOVE) {
+        MergeTailCopy(old_size);
+        return;
+    }
+    Key* keys = keys_.begin();
+    Value* values = values_.begin();
+    /// если все новые ключи больше прежних, сливать нечего, и повторы ищутся только в хвосте
+    const bool merge = old_size != 0 && !comp_(keys[old_size - 1], keys[old_size]);
+    if (merge) {
+        /* Новые элементы переносятся во временные массивы, и обе последовательности сливаются
+           с конца на свои места. Из равных ключей новый ставится правее прежнего.
+           Выделить память под временные массивы может не получиться: тогда прежние элементы
+           ещё не тронуты, и достаточно убрать дописанный хвост */
+        Vector<Key, KeyAlloc> new_keys(keys_.GetAllocator());
+        Vector<Value, ValueAlloc> new_values(values_.GetAllocator());
+        try {
+            new_keys.AppendRange(std::ranges::subrange(std::make_move_iterator(keys + old_size),
+                                                       std::make_move_iterator(keys + size)));
+            new_values.AppendRange(std::ranges::subrange(std::make_move_iterator(values + old_size),
+                                                         std::make_move_iterator(values + size)));
+        } catch (...) {
+            keys_.Erase(keys_.begin() + old_size, keys_.end());
+            values_.Erase(values_.begin() + old_size, values_.end());
+            throw;
+        }
+        size_t i = old_size;
+        size_t j = new_keys.Size();
+        size_t out = size;
+        while (j != 0) {
+            --out;
+            if (i != 0 && comp_(new_keys[j - 1], keys[i - 1])) {
+                --i;
+                keys[out] = std::move(keys[i]);
+                values[out] = std::move(values[i]);
+            } else {
+                --j;
+                keys[out] = std::move(new_keys[j]);
+                values[out] = std::move(new_values[j]);
+            }
+        }
+    }
+    /// из серии равных ключей остаётся первый: прежний или первый из вставленных
+    size_t unique_end = merge || old_size == 0 ? 1 : old_size;
+    for (size_t k = unique_end; k != size; ++k) {
+        if (comp_(keys[unique_end - 1], keys[k])) {
+            if (k != unique_end) {
+                keys[unique_end] = std::move(keys[k]);
+                values[unique_end] = std::move(values[k]);
+            }
+            ++unique_end;
+        }
+    }
+    keys_.Erase(keys_.begin() + unique_end, keys_.end());
+    values_.Erase(values_.begin() + unique_end, values_.end());
+}
+
+template<typename Key, typename Value, typename Compare, typename KeyAlloc, typename ValueAlloc>
+void FlatMap<Key, Value, Compare, KeyAlloc, ValueAlloc>::MergeTailCopy(size_t old_size) {
+    const size_t size = keys_.Size();
+    Key* keys = keys_.begin();
+    Value* values = values_.begin();
+    Vector<Key, KeyAlloc> merged_keys(keys_.GetAllocator());
+    Vector<Value, ValueAlloc> merged_values(values_.GetAllocator());
+    try {
+        merged_keys.Reserve(size);
+        merged_values.Reserve(size);
+        /// из серии равных ключей остаётся первый: прежний или первый из вставленных
+        auto take = [&](size_t k) {
+            if (merged_keys.IsEmpty() || comp_(merged_keys[merged_keys.Size() - 1], keys[k])) {
+                merged_keys.EmplaceBack(std::move_if_noexcept(keys[k]));
+                merged_values.EmplaceBack(std::move_if_noexcept(values[k]));
+            }
+        };
+        size_t i = 0;
+        size_t j = old_size;
+        while (i != old_size || j != size) {
+            if (j == size || (i != old_size && !comp_(keys[j], keys[i]))) {
+                take(i++);
+            } else {
+                take(j++);
+            }
+        }
+    } catch (...) {
+        keys_.Erase(keys_.begin() + old_size, keys_.end());
+        values_.Erase(values_.begin() + old_size, values_.end());
+        throw;
+    }
+    keys_.Swap(merged_keys);
+    values_.Swap(merged_values);
+}
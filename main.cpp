@@ -1,10 +1,44 @@
+#include "allocators.h"
+#include "mapped_vector.h"
+#include "serialization.h"
+#include "concurrent_vector.h"
+#include "segmented_vector.h"
+#include "soa_vector.h"
+#include "flat_map.h"
+#include "cow_vector.h"
+#include "parallel_algorithms.h"
+#include "packed_vector.h"
+#include "compact_vector.h"
 #include "vector.h"
+#include "small_vector.h"
 
 #include <iostream>
+#include <iterator>
+#include <ranges>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <list>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <filesystem>
+#include <system_error>
+#include <thread>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
 
 namespace {
 
@@ -117,8 +151,254 @@ namespace {
         static inline int num_move_assigned = 0;
     };
 
+    /// Владеющий указатель: перемещение не тривиально, но объект можно переносить побайтово
+    struct Handle {
+        explicit Handle(int value)
+                : ptr(new int(value))  //
+        {
+        }
+
+        Handle(Handle&& other) noexcept
+                : ptr(std::exchange(other.ptr, nullptr))  //
+        {
+            ++num_moved;
+        }
+
+        Handle& operator=(Handle&& other) noexcept {
+            std::swap(ptr, other.ptr);
+            ++num_moved;
+            return *this;
+        }
+
+        ~Handle() {
+            delete ptr;
+        }
+
+        int* ptr = nullptr;
+
+        static inline int num_moved = 0;
+    };
+
+    /// Аллокатор с состоянием: считает выделения и освобождения,
+    /// равны только экземпляры с одинаковым id
+    template <typename T>
+    struct CountingAllocator {
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        explicit CountingAllocator(int id)
+                : id(id)  //
+        {
+        }
+
+        template <typename U>
+        CountingAllocator(const CountingAllocator<U>& other) noexcept
+                : id(other.id)  //
+        {
+        }
+
+        T* allocate(size_t n) {
+            ++num_allocations;
+            return static_cast<T*>(operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T* p, size_t /*n*/) noexcept {
+            ++num_deallocations;
+            operator delete(p);
+        }
+
+        bool operator==(const CountingAllocator& other) const noexcept {
+            return id == other.id;
+        }
+
+        int id = 0;
+
+        static inline int num_allocations = 0;
+        static inline int num_deallocations = 0;
+    };
+
+    /// Счётчики RebindCountingAllocator, общие для всех типов элементов
+    struct RebindCounters {
+        static inline int num_allocations = 0;
+        static inline int num_deallocations = 0;
+    };
+
+    /// Аллокатор без состояния, который считает выделения и после переназначения на другой тип
+    template <typename T>
+    struct RebindCountingAllocator : RebindCounters {
+        using value_type = T;
+
+        RebindCountingAllocator() = default;
+
+        template <typename U>
+        RebindCountingAllocator(const RebindCountingAllocator<U>& /*other*/) noexcept {
+        }
+
+        T* allocate(size_t n) {
+            ++num_allocations;
+            return std::allocator<T>().allocate(n);
+        }
+
+        void deallocate(T* p, size_t n) noexcept {
+            ++num_deallocations;
+            std::allocator<T>().deallocate(p, n);
+        }
+
+        bool operator==(const RebindCountingAllocator& /*other*/) const noexcept {
+            return true;
+        }
+    };
+
+    /// То же для выделений из нескольких потоков
+    template <typename T>
+    struct ConcurrentCountingAllocator {
+        using value_type = T;
+
+        ConcurrentCountingAllocator() = default;
+
+        template <typename U>
+        ConcurrentCountingAllocator(const ConcurrentCountingAllocator<U>& /*other*/) noexcept {
+        }
+
+        T* allocate(size_t n) {
+            ConcurrentCountingAllocator<void>::num_allocations.fetch_add(1);
+            return std::allocator<T>().allocate(n);
+        }
+
+        void deallocate(T* p, size_t n) noexcept {
+            std::allocator<T>().deallocate(p, n);
+        }
+
+        bool operator==(const ConcurrentCountingAllocator& /*other*/) const noexcept {
+            return true;
+        }
+
+        static inline std::atomic<int> num_allocations = 0;
+    };
+
+    /// Объект со счётчиками, безопасными для параллельных массовых операций
+    struct SharedObj {
+        SharedObj() {
+            if (construction_limit.fetch_sub(1) <= 0) {
+                throw std::runtime_error("Oops");
+            }
+            ++num_alive;
+        }
+
+        SharedObj(const SharedObj& other)
+                : id(other.id)  //
+        {
+            if (other.throw_on_copy) {
+                throw std::runtime_error("Oops");
+            }
+            ++num_alive;
+            ++num_copied;
+        }
+
+        SharedObj& operator=(const SharedObj& other) = default;
+
+        ~SharedObj() {
+            --num_alive;
+        }
+
+        bool throw_on_copy = false;
+        int id = 0;
+
+        static inline std::atomic<int> construction_limit = INT_MAX;
+        static inline std::atomic<int> num_alive = 0;
+        static inline std::atomic<int> num_copied = 0;
+    };
+
+    /// Только копируемый объект: при переносе в вектор копируется, копия может выбросить исключение
+    struct CopyOnly {
+        explicit CopyOnly(int id)
+                : id(id)  //
+        {
+        }
+
+        CopyOnly(const CopyOnly& other)
+                : id(other.id)  //
+        {
+            if (other.id == throw_id) {
+                throw std::runtime_error("Oops");
+            }
+        }
+
+        CopyOnly& operator=(const CopyOnly& other) = default;
+
+        int id = 0;
+
+        static inline int throw_id = -1;
+    };
+
+    /// Obj, перемещение которого не объявлено noexcept и по счётчику выбрасывает исключение
+    struct MaybeThrowingMove : Obj {
+        using Obj::Obj;
+
+        MaybeThrowingMove() = default;
+        MaybeThrowingMove(const MaybeThrowingMove& other) = default;
+
+        MaybeThrowingMove(MaybeThrowingMove&& other) noexcept(false)
+                : Obj(std::move(other))  //
+        {
+            if (move_throw_countdown > 0 && --move_throw_countdown == 0) {
+                throw std::runtime_error("Oops");
+            }
+        }
+
+        MaybeThrowingMove& operator=(const MaybeThrowingMove& other) = default;
+        MaybeThrowingMove& operator=(MaybeThrowingMove&& other) = default;
+
+        static inline int move_throw_countdown = 0;
+    };
+
+    /// Obj, перемещающее присваивание которого не объявлено noexcept и по счётчику выбрасывает исключение
+    struct ThrowingMoveAssign : Obj {
+        using Obj::Obj;
+
+        ThrowingMoveAssign(const ThrowingMoveAssign& other) = default;
+        ThrowingMoveAssign(ThrowingMoveAssign&& other) = default;
+        ThrowingMoveAssign& operator=(const ThrowingMoveAssign& other) = default;
+
+        ThrowingMoveAssign& operator=(ThrowingMoveAssign&& other) noexcept(false) {
+            if (assign_throw_countdown > 0 && --assign_throw_countdown == 0) {
+                throw std::runtime_error("Oops");
+            }
+            Obj::operator=(std::move(other));
+            return *this;
+        }
+
+        static inline int assign_throw_countdown = 0;
+    };
+
+    /// Obj, конструктор которого из id бросает исключение на отрицательном id
+    struct ThrowingFromId : Obj {
+        explicit ThrowingFromId(int id)
+                : Obj(id)  //
+        {
+            if (id < 0) {
+                throw std::runtime_error("Oops");
+            }
+        }
+    };
+
+    /// То же, но вектору разрешено переносить его перемещением специализацией relocate_by_move
+    struct RelaxedMove : MaybeThrowingMove {
+        using MaybeThrowingMove::MaybeThrowingMove;
+    };
+
 }  // namespace
 
+template <>
+struct is_trivially_relocatable<Handle> : std::true_type {
+};
+
+template <>
+struct relocate_by_move<RelaxedMove> : std::true_type {
+};
+
 void Test1() {
     Obj::ResetCounters();
     const size_t SIZE = 100500;
@@ -559,85 +839,2194 @@ void Test6() {
     }
 }
 
-struct C {
-    C() noexcept {
-        ++def_ctor;
+void Test7() {
+    const size_t SIZE = 100;
+    static_assert(is_trivially_relocatable_v<int>);
+    static_assert(!is_trivially_relocatable_v<Obj>);
+    {
+        Vector<int> v;
+        for (int i = 0; i < static_cast<int>(SIZE); ++i) {
+            v.PushBack(i);
+        }
+        v.Insert(v.cbegin() + 1, -1);
+        v.Reserve(SIZE * 4);
+        assert(v.Size() == SIZE + 1);
+        assert(v[0] == 0 && v[1] == -1 && v[2] == 1);
+        assert(v[SIZE] == static_cast<int>(SIZE) - 1);
+    }
+    {
+        Handle::num_moved = 0;
+        Vector<Handle> v;
+        for (int i = 0; i < static_cast<int>(SIZE); ++i) {
+            v.EmplaceBack(i);
+        }
+        v.Emplace(v.cbegin() + v.Size(), -2);
+        v.Reserve(SIZE * 8);
+        // Рост вектора переносит элементы побайтово, не вызывая перемещающий конструктор
+        assert(Handle::num_moved == 0);
+        assert(v.Size() == SIZE + 1);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(*v[i].ptr == static_cast<int>(i));
+        }
+        assert(*v[SIZE].ptr == -2);
+    }
+}
+
+void Test8() {
+    const size_t SIZE = 100;
+#if !defined(VECTOR_WITH_SITE_TRACKING)
+    static_assert(sizeof(Vector<int>) == 3 * sizeof(void*));
+#endif
+    static_assert(sizeof(RawMemory<int>) == 2 * sizeof(void*));
+    {
+        // Вектор целиком размещается в арене на стеке, глобальная куча не используется
+        std::byte buffer[4096];
+        std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+        pmr::Vector<int> v(&arena);
+        for (int i = 0; i < static_cast<int>(SIZE); ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Size() == SIZE);
+        assert(v.GetAllocator().resource() == &arena);
+        const auto* first = reinterpret_cast<const std::byte*>(&v[0]);
+        assert(first >= buffer && first < buffer + sizeof(buffer));
+
+        // Копия получает ресурс по умолчанию, а при перемещении в вектор с другим ресурсом
+        // элементы переносятся в его память
+        pmr::Vector<int> copy(v);
+        assert(copy.GetAllocator().resource() == std::pmr::get_default_resource());
+        pmr::Vector<int> same_arena(&arena);
+        same_arena = std::move(v);
+        assert(reinterpret_cast<const std::byte*>(&same_arena[0]) == first);
+        copy = std::move(same_arena);
+        assert(copy.Size() == SIZE && copy[SIZE - 1] == static_cast<int>(SIZE) - 1);
+        assert(copy.GetAllocator().resource() == std::pmr::get_default_resource());
+    }
+    CountingAllocator<Obj>::num_allocations = 0;
+    CountingAllocator<Obj>::num_deallocations = 0;
+    Obj::ResetCounters();
+    {
+        using CountingVector = Vector<Obj, CountingAllocator<Obj>>;
+        CountingVector a(SIZE, CountingAllocator<Obj>{1});
+        CountingVector b(SIZE / 2, CountingAllocator<Obj>{2});
+        b = a;
+        assert(b.GetAllocator().id == 1);
+        assert(b.Size() == SIZE);
+        CountingVector c(CountingAllocator<Obj>{3});
+        c = std::move(b);
+        assert(c.GetAllocator().id == 1);
+        assert(Obj::num_moved == 0);
+        a.Swap(c);
+        assert(a.GetAllocator().id == 1 && c.GetAllocator().id == 1);
+        assert(Obj::GetAliveObjectCount() == 2 * SIZE);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    assert(CountingAllocator<Obj>::num_allocations == CountingAllocator<Obj>::num_deallocations);
+}
+
+void Test9() {
+    {
+        Vector<int, std::allocator<int>, OneAndHalfGrowth> v;
+        std::vector<size_t> capacities;
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(i);
+            if (capacities.empty() || capacities.back() != v.Capacity()) {
+                capacities.push_back(v.Capacity());
+            }
+        }
+        assert((capacities == std::vector<size_t>{1, 2, 3, 4, 6, 9, 13}));
+        // Reserve не применяет амортизированный рост
+        v.Reserve(100);
+        assert(v.Capacity() == 100);
     }
-    C(const C& /*other*/) noexcept {
-        ++copy_ctor;
+    {
+        Vector<int, std::allocator<int>, MinAllocationGrowth<>> v;
+        v.PushBack(1);
+        assert(v.Capacity() == 64 / sizeof(int));
+        Vector<int, std::allocator<int>, MinAllocationGrowth<>> w;
+        w.Insert(w.cbegin(), 1);
+        assert(w.Capacity() == 64 / sizeof(int));
     }
-    C(C&& /*other*/) noexcept {
-        ++move_ctor;
+#if defined(__GLIBC__)
+    {
+        Vector<char, std::allocator<char>, MallocSizeClassGrowth<>> v;
+        v.PushBack('a');
+        assert(v.Capacity() > 1);
+        assert(malloc_usable_size(&v[0]) >= v.Capacity());
+        v.Reserve(1000);
+        assert(v.Capacity() >= 1000);
+        assert(malloc_usable_size(&v[0]) >= v.Capacity());
+        v.Resize(300'000);
+        assert(v.Capacity() >= 300'000);
+        assert(malloc_usable_size(&v[0]) >= v.Capacity());
     }
-    C& operator=(const C& other) noexcept {
-        if (this != &other) {
-            ++copy_assign;
+#endif
+}
+
+void Test10() {
+    const size_t N = 4;
+    using CountingSmallVector = SmallVector<Obj, N, CountingAllocator<Obj>>;
+    CountingAllocator<Obj>::num_allocations = 0;
+    CountingAllocator<Obj>::num_deallocations = 0;
+    Obj::ResetCounters();
+    {
+        CountingSmallVector v(CountingAllocator<Obj>{1});
+        assert(v.Capacity() == N);
+        for (int i = 0; i < static_cast<int>(N); ++i) {
+            v.EmplaceBack(i);
+        }
+        v.Erase(v.cbegin());
+        v.Insert(v.cbegin(), Obj{0});
+        assert(v.IsInline());
+        assert(CountingAllocator<Obj>::num_allocations == 0);
+
+        // копия и перемещение внутреннего буфера не выделяют память
+        CountingSmallVector copy(v);
+        CountingSmallVector moved(std::move(copy));
+        assert(moved.IsInline() && moved.Size() == N && copy.IsEmpty());
+        assert(CountingAllocator<Obj>::num_allocations == 0);
+
+        v.Insert(v.cbegin() + 2, Obj{42});
+        assert(!v.IsInline());
+        assert(v.Capacity() == 2 * N);
+        assert(CountingAllocator<Obj>::num_allocations == 1);
+        assert(v.Size() == N + 1 && v[2].id == 42 && v[3].id == 2);
+
+        // обмен вектора в куче с вектором во внутреннем буфере
+        static_assert(noexcept(v.Swap(moved)));
+        v.Swap(moved);
+        assert(v.IsInline() && v.Size() == N);
+        assert(!moved.IsInline() && moved.Size() == N + 1 && moved[2].id == 42);
+        for (size_t i = 0; i < N; ++i) {
+            assert(v[i].id == static_cast<int>(i));
         }
-        return *this;
+
+        CountingSmallVector from_heap(std::move(moved));
+        assert(!from_heap.IsInline() && moved.IsEmpty());
+        assert(CountingAllocator<Obj>::num_allocations == 1);
+        v = from_heap;
+        assert(v.Size() == N + 1 && v[2].id == 42);
+        from_heap.Resize(1);
+        from_heap = std::move(v);
+        assert(from_heap.Size() == N + 1);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(N + 1 + v.Size()));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    assert(CountingAllocator<Obj>::num_allocations == CountingAllocator<Obj>::num_deallocations);
+    {
+        SmallVector<TestObj, 2> v(2);
+        v.PushBack(v[0]);
+        v.Insert(v.cbegin() + 1, v[2]);
+        assert(std::all_of(v.begin(), v.end(), [](const TestObj& obj) {
+            return obj.IsAlive();
+        }));
+        v.Reserve(100);
+        assert(v.Capacity() == 100 && v.Size() == 4);
+    }
+}
+
+void Test11() {
+    const size_t SIZE = 10;
+    {
+        // вставка в середину при достаточной вместимости сдвигает хвост один раз
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.Reserve(SIZE * 2);
+        const Obj items[] = {Obj{1}, Obj{2}, Obj{3}};
+        Obj::ResetCounters();
+        auto pos = v.Insert(v.cbegin() + 2, std::begin(items), std::end(items));
+        assert(pos == v.begin() + 2);
+        assert(v.Size() == SIZE + 3);
+        assert(v[2].id == 1 && v[3].id == 2 && v[4].id == 3 && v[5].id == 0);
+        assert(Obj::num_moved == 3);
+        assert(Obj::num_move_assigned == static_cast<int>(SIZE) - 2 - 3);
+        assert(Obj::num_assigned == 3);
+        assert(Obj::num_copied == 0);
+    }
+    {
+        // вставка в полный вектор выделяет память один раз
+        CountingAllocator<Obj>::num_allocations = 0;
+        Obj::ResetCounters();
+        Vector<Obj, CountingAllocator<Obj>> v(SIZE, CountingAllocator<Obj>{1});
+        const Obj value{7};
+        v.Insert(v.cbegin() + 1, 5, value);
+        assert(CountingAllocator<Obj>::num_allocations == 2);
+        assert(v.Size() == SIZE + 5);
+        assert(v.Capacity() == SIZE * 2);
+        assert(v[0].id == 0 && v[1].id == 7 && v[5].id == 7 && v[6].id == 0);
+        assert(Obj::num_copied == 5);
+        assert(Obj::num_moved == static_cast<int>(SIZE));
+
+        // value ссылается на элемент самого вектора
+        v[0].id = 9;
+        v.Insert(v.cbegin() + 1, 2, v[0]);
+        assert(v[1].id == 9 && v[2].id == 9 && v[3].id == 7);
+
+        Obj::ResetCounters();
+        auto pos = v.Erase(v.cbegin() + 1, v.cbegin() + 8);
+        assert(pos == v.begin() + 1);
+        assert(v.Size() == SIZE);
+        assert(Obj::num_destroyed == 7);
+        assert(Obj::num_move_assigned == static_cast<int>(SIZE) - 1);
+        assert(v.Erase(v.cbegin(), v.cbegin()) == v.begin());
     }
-    C& operator=(C&& /*other*/) noexcept {
-        ++move_assign;
-        return *this;
+    {
+        // исключение при реаллокации оставляет вектор нетронутым
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        Obj items[2];
+        items[1].throw_on_copy = true;
+        try {
+            v.Insert(v.cbegin() + 1, std::begin(items), std::end(items));
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE && v.Capacity() == SIZE);
+        assert(Obj::GetAliveObjectCount() == SIZE + 2);
     }
-    ~C() {
-        ++dtor;
+    {
+        Vector<int> v;
+        std::istringstream input("1 2 3 4");
+        v.Insert(v.cend(), std::istream_iterator<int>(input), std::istream_iterator<int>());
+        std::istringstream more("8 9");
+        v.Insert(v.cbegin() + 1, std::istream_iterator<int>(more), std::istream_iterator<int>());
+        const std::vector<int> tail{5, 6, 7};
+        v.AppendRange(tail);
+        v.AppendRange(std::views::iota(10, 12));
+        v.Insert(v.cbegin() + 2, 3, -1);
+        v.Erase(v.cbegin(), v.cbegin() + 1);
+        assert(v.Size() == 13);
+        const std::vector<int> expected{8, -1, -1, -1, 9, 2, 3, 4, 5, 6, 7, 10, 11};
+        assert(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
     }
+}
 
-    static void Reset() {
-        def_ctor = 0;
-        copy_ctor = 0;
-        move_ctor = 0;
-        copy_assign = 0;
-        move_assign = 0;
-        dtor = 0;
+void Test12() {
+    const size_t SIZE = 256;
+    using Buffer = pmr::Vector<unsigned char>;
+    {
+        // память арены заполнена маркером, который не должен быть затёрт нулями
+        unsigned char storage[4 * SIZE];
+        std::fill(std::begin(storage), std::end(storage), 0xAB);
+        std::pmr::monotonic_buffer_resource arena(storage, sizeof(storage), std::pmr::null_memory_resource());
+        Buffer v(SIZE, default_init, &arena);
+        assert(v.Size() == SIZE);
+        assert(std::all_of(v.begin(), v.end(), [](unsigned char c) {
+            return c == 0xAB;
+        }));
+        v.Resize(SIZE / 2);
+        v.ResizeForOverwrite(SIZE);
+        assert(v[SIZE - 1] == 0xAB);
+        Buffer zeroed(SIZE, &arena);
+        assert(zeroed[0] == 0 && zeroed[SIZE - 1] == 0);
+    }
+    {
+        Vector<char> v;
+        v.ResizeAndOverwrite(SIZE, [](char* data, size_t n) {
+            assert(n == SIZE);
+            const char text[] = "hello";
+            std::copy(std::begin(text), std::end(text) - 1, data);
+            return sizeof(text) - 1;
+        });
+        assert(v.Size() == 5 && v.Capacity() == SIZE);
+        assert(std::string(v.begin(), v.end()) == "hello");
+        try {
+            v.ResizeAndOverwrite(SIZE * 2, [](char*, size_t) -> size_t {
+                throw std::runtime_error("Oops");
+            });
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 5);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(3, default_init);
+        v.ResizeAndOverwrite(10, [](Obj* data, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                data[i].id = static_cast<int>(i);
+            }
+            return size_t{4};
+        });
+        assert(v.Size() == 4 && v[3].id == 3);
+        assert(Obj::num_default_constructed == 10);
+        assert(Obj::GetAliveObjectCount() == 4);
     }
+}
 
-    inline static size_t def_ctor = 0;
-    inline static size_t copy_ctor = 0;
-    inline static size_t move_ctor = 0;
-    inline static size_t copy_assign = 0;
-    inline static size_t move_assign = 0;
-    inline static size_t dtor = 0;
-};
+void Test13() {
+    const size_t SIZE = 1000;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.Resize(SIZE / 10);
+        const int old_moved = Obj::num_moved;
+        v.ShrinkToFit();
+        assert(v.Capacity() == SIZE / 10);
+        assert(Obj::num_moved - old_moved == static_cast<int>(SIZE / 10));
+        v.ShrinkTo(SIZE);
+        assert(v.Capacity() == SIZE / 10);
+        v.ShrinkTo(0);
+        assert(v.Capacity() == SIZE / 10);
+        v.Resize(0);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 0 && v.begin() == nullptr);
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        Vector<int> v(SIZE);
+        v[SIZE / 2 - 1] = 42;
+        v.Resize(SIZE / 2);
+        v.ShrinkTo(SIZE * 3 / 4);
+        assert(v.Capacity() == SIZE * 3 / 4);
+        assert(v.Size() == SIZE / 2 && v[SIZE / 2 - 1] == 42);
+    }
+    {
+        // буфер меняет размер через realloc, элементы не перемещаются поштучно
+        Handle::num_moved = 0;
+        Vector<Handle, MallocAllocator<Handle>> v;
+        for (int i = 0; i < static_cast<int>(SIZE); ++i) {
+            v.EmplaceBack(i);
+        }
+        v.PushBack(Handle{-1});
+        v.Reserve(SIZE * 1000);
+        assert(v.Capacity() == SIZE * 1000);
+        v.Erase(v.cbegin() + SIZE, v.cend());
+        v.ShrinkToFit();
+        assert(v.Capacity() == SIZE);
+        assert(Handle::num_moved == 1);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(*v[i].ptr == static_cast<int>(i));
+        }
+        // аргумент, ссылающийся на элемент вектора, переживает изменение буфера
+        Vector<int, MallocAllocator<int>> ints(1);
+        ints[0] = 7;
+        ints.PushBack(ints[0]);
+        assert(ints[1] == 7);
+    }
+}
 
-void Dump() {
-    using namespace std;
-    cerr << "Def ctors: "sv << C::def_ctor              //
-         << ", Copy ctors: "sv << C::copy_ctor          //
-         << ", Move ctors: "sv << C::move_ctor          //
-         << ", Copy assignments: "sv << C::copy_assign  //
-         << ", Move assignments: "sv << C::move_assign  //
-         << ", Dtors: "sv << C::dtor << endl;
+void Test14() {
+    const auto is_aligned = [](const void* ptr, size_t alignment) {
+        return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+    };
+    {
+        AlignedVector<float, 64> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(static_cast<float>(i));
+            assert(is_aligned(&v[0], 64));
+        }
+        v.Insert(v.cbegin() + 1, 3, -1.0f);
+        v.ShrinkToFit();
+        assert(is_aligned(&v[0], 64));
+        assert(v[0] == 0.0f && v[1] == -1.0f && v[4] == 1.0f);
+    }
+    {
+        const size_t SIZE = 1 << 20;
+        const size_t HUGE_PAGE = HugePageAllocator<float>::HUGE_PAGE_SIZE;
+        HugePageVector<float> v(SIZE);
+        assert(is_aligned(&v[0], HUGE_PAGE));
+        for (size_t i = 0; i < SIZE; ++i) {
+            v[i] = static_cast<float>(i);
+        }
+        // рост крупного буфера переносит отображение через mremap
+        v.Reserve(SIZE * 4);
+        assert(is_aligned(&v[0], HUGE_PAGE));
+        v.Resize(SIZE * 3);
+        v.Resize(SIZE + 1);
+        v.ShrinkToFit();
+        assert(v.Capacity() == SIZE + 1);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(v[i] == static_cast<float>(i));
+        }
+        // небольшие буферы выделяются как обычно
+        HugePageVector<int> small(10);
+        small.Reserve(1 << 20);
+        assert(small.Size() == 10 && small[9] == 0);
+        HugePageVector<int, HugePageMode::RESERVED> reserved(1 << 20);
+        reserved[(1 << 20) - 1] = 1;
+        reserved.Reserve(1 << 21);
+        assert(reserved[(1 << 20) - 1] == 1);
+    }
 }
 
-void Benchmark() {
-    using namespace std;
-    try {
-        const size_t NUM = 10;
-        C c;
-        {
-            cerr << "std::vector:"sv << endl;
-            C::Reset();
-            vector<C> v(NUM);
-            Dump();
-            v.push_back(c);
+void Test15() {
+    const size_t SIZE = 100'000;
+    SetParallelThreshold(1000);
+    {
+        Vector<int> v(SIZE);
+        assert(std::all_of(v.begin(), v.end(), [](int x) {
+            return x == 0;
+        }));
+        for (size_t i = 0; i < SIZE; ++i) {
+            v[i] = static_cast<int>(i);
+        }
+        Vector<int> copy(v);
+        Vector<int> assigned(SIZE / 2);
+        assigned = v;
+        copy.Reserve(SIZE * 3);
+        copy.Resize(SIZE * 2);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(copy[i] == static_cast<int>(i) && assigned[i] == static_cast<int>(i));
         }
-        Dump();
-    } catch (...) {
+        assert(copy[SIZE * 2 - 1] == 0);
     }
-    try {
-        const size_t NUM = 10;
-        C c;
-        {
-            cerr << "Vector:"sv << endl;
-            C::Reset();
-            Vector<C> v(NUM);
-            Dump();
-            v.PushBack(c);
+    {
+        // частично созданный вектор уничтожает все созданные элементы
+        SharedObj::construction_limit = SIZE / 2;
+        try {
+            Vector<SharedObj> v(SIZE);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
         }
-        Dump();
-    } catch (...) {
+        assert(SharedObj::num_alive == 0);
+        SharedObj::construction_limit = INT_MAX;
     }
+    {
+        Vector<SharedObj> v(SIZE);
+        v[SIZE / 3].throw_on_copy = true;
+        try {
+            Vector<SharedObj> copy(v);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(SharedObj::num_alive == static_cast<int>(SIZE));
+        // копирование при реаллокации откатывается, исходный вектор не меняется
+        try {
+            v.Reserve(SIZE * 2);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Capacity() == SIZE && v.Size() == SIZE);
+        assert(SharedObj::num_alive == static_cast<int>(SIZE));
+        v[SIZE / 3].throw_on_copy = false;
+        v.Reserve(SIZE * 2);
+        v.Resize(SIZE / 10);
+        assert(SharedObj::num_alive == static_cast<int>(SIZE / 10));
+    }
+    assert(SharedObj::num_alive == 0);
+    SetParallelThreshold(SIZE_MAX);
+}
+
+struct TelemetryPod {
+    int value = 0;
+};
+
+struct TelemetryCopyable {
+    TelemetryCopyable() = default;
+    TelemetryCopyable(const TelemetryCopyable& /*other*/) {
+    }
+};
+
+struct TelemetryMovable {
+    TelemetryMovable() = default;
+    TelemetryMovable(TelemetryMovable&& /*other*/) noexcept {
+    }
+    TelemetryMovable(const TelemetryMovable& /*other*/) {
+    }
+};
+
+void Test16() {
+#if defined(VECTOR_WITH_TELEMETRY)
+    const auto find = [](std::string_view name) {
+        for (const TelemetrySnapshot& s : CollectTelemetry()) {
+            if (std::string_view(s.type_name).find(name) != std::string_view::npos) {
+                return s;
+            }
+        }
+        assert(false && "telemetry for type is not registered");
+        return TelemetrySnapshot{};
+    };
+    ResetTelemetry();
+    {
+        Vector<TelemetryPod> v;
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(TelemetryPod{i});
+        }
+        // вместимости 1, 2, 4, 8, 16
+        const auto s = find("TelemetryPod");
+        assert(s.element_size == sizeof(TelemetryPod));
+        assert(s.allocations == 5 && s.allocated_bytes == 31 * sizeof(TelemetryPod));
+        assert(s.reallocations == 4 && s.relocated_bitwise == 1 + 2 + 4 + 8);
+        assert(s.relocated_by_move == 0 && s.relocated_by_copy == 0);
+        assert(s.peak_capacity == 16);
+        assert(s.destroyed == 0);
+    }
+    {
+        const auto s = find("TelemetryPod");
+        assert(s.destroyed == 1 && s.wasted_capacity == 6 && s.peak_wasted_capacity == 6);
+    }
+    {
+        Vector<TelemetryCopyable> copyable(4);
+        copyable.Reserve(8);
+        Vector<TelemetryMovable> movable(4);
+        movable.Reserve(8);
+        movable.ShrinkToFit();
+        assert(find("TelemetryCopyable").relocated_by_copy == 4);
+        const auto s = find("TelemetryMovable");
+        assert(s.reallocations == 2 && s.relocated_by_move == 8 && s.relocated_by_copy == 0);
+    }
+    {
+        Vector<int, MallocAllocator<int>> v(4);
+        v.Reserve(100);
+        const auto s = find("int");
+        assert(s.relocated_by_reallocate == 4 && s.peak_capacity == 100);
+    }
+    {
+        std::ostringstream out;
+        WriteTelemetry(out);
+        assert(out.str().find("TelemetryMovable element_size=1 allocations=3") != std::string::npos);
+    }
+#else
+    assert(CollectTelemetry().empty());
+#endif
+}
+
+struct Record {
+    uint64_t id;
+    double value;
+};
+
+void Test17() {
+    const std::string path = (std::filesystem::temp_directory_path() / "vector_test17.bin").string();
+    {
+        MappedVector<Record> v(path, MappedMode::CREATE);
+        assert(v.IsEmpty() && v.Capacity() == 0 && !v.IsReadOnly());
+        for (uint64_t i = 0; i < 1000; ++i) {
+            v.PushBack(Record{i, i * 0.5});
+        }
+        assert(v.Size() == 1000 && v.Capacity() == 1024);
+        // аргумент ссылается на элемент, а вставка переносит отображение
+        v.Reserve(v.Capacity());
+        v.ShrinkToFit();
+        v.EmplaceBack(v[0]);
+        assert(v.Size() == 1001 && v[1000].id == 0);
+        v.Erase(v.begin() + 1000);
+        v.Insert(v.begin(), Record{1000, -1.0});
+        v.Erase(v.begin());
+        v.Flush();
+    }
+    {
+        MappedVector<Record> v(path, MappedMode::READ_ONLY);
+        assert(v.IsReadOnly() && v.Size() == 1000);
+        for (uint64_t i = 0; i < 1000; ++i) {
+            assert(v[i].id == i && v[i].value == i * 0.5);
+        }
+        MappedVector<Record> moved(std::move(v));
+        assert(v.Size() == 0 && v.begin() == v.end());
+        assert(moved.Size() == 1000);
+    }
+    {
+        MappedVector<Record> v(path);
+        v.Resize(10);
+        v.Resize(20);
+        assert(v.Size() == 20 && v[9].id == 9 && v[10].id == 0 && v[19].value == 0.0);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 20);
+        assert(std::filesystem::file_size(path) == 64 + 20 * sizeof(Record));
+    }
+    {
+        // писатель растёт за пределы отображения читателя: читатель видит только свои элементы
+        MappedVector<Record> writer(path);
+        const MappedVector<Record> reader(path, MappedMode::READ_ONLY);
+        for (uint64_t i = 0; i < 100; ++i) {
+            writer.PushBack(Record{i, 1.0});
+        }
+        assert(writer.Size() == 120 && reader.Capacity() == 20 && reader.Size() == 20);
+        assert(reader.end() == reader.begin() + 20 && reader[19].value == 0.0);
+        writer.Resize(10);
+        assert(reader.Size() == 10);
+        writer.Resize(20);
+    }
+    try {
+        MappedVector<int> v(path, MappedMode::READ_ONLY);
+        assert(false && "Exception is expected");
+    } catch (const std::runtime_error&) {
+    }
+    try {
+        MappedVector<Record> v(path + ".missing", MappedMode::READ_ONLY);
+        assert(false && "Exception is expected");
+    } catch (const std::system_error& e) {
+        assert(e.code() == std::errc::no_such_file_or_directory);
+    }
+    std::filesystem::remove(path);
+}
+
+void Test18() {
+    const std::string path = (std::filesystem::temp_directory_path() / "vector_test18.bin").string();
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    assert(fd >= 0);
+
+    Vector<int> numbers;
+    for (int i = 0; i < 1000; ++i) {
+        numbers.PushBack(i * i);
+    }
+    assert(AsBytes(numbers).size() == 1000 * sizeof(int));
+    assert(AsBytes(numbers).data() == reinterpret_cast<const std::byte*>(numbers.begin()));
+
+    Vector<Vector<Record>> nested(3);
+    nested[0].PushBack(Record{1, 1.5});
+    nested[2].PushBack(Record{2, 2.5});
+    nested[2].PushBack(Record{3, 3.5});
+
+    IoVecList list;
+    list.Add(numbers);
+    list.Add(nested);
+    assert(list.TotalBytes() == 2 * sizeof(SerializedHeader) + 1000 * sizeof(int)
+                                + 3 * sizeof(SerializedHeader) + 3 * sizeof(Record));
+    // подряд идущие заголовки (внешнего и первого вложенного, пустого и следующего) склеиваются
+    assert(list.Iovecs().size() == 6);
+    list.WriteTo(fd);
+    WriteTo(fd, numbers);
+
+    assert(::lseek(fd, 0, SEEK_SET) == 0);
+    Vector<int> numbers_copy(5);
+    ReadFrom(fd, numbers_copy);
+    assert(numbers_copy.Size() == 1000 && std::equal(numbers.begin(), numbers.end(), numbers_copy.begin()));
+    Vector<Vector<Record>> nested_copy;
+    ReadFrom(fd, nested_copy);
+    assert(nested_copy.Size() == 3);
+    assert(nested_copy[0].Size() == 1 && nested_copy[0][0].id == 1);
+    assert(nested_copy[1].IsEmpty());
+    assert(nested_copy[2].Size() == 2 && nested_copy[2][1].value == 3.5);
+    // вектор другого типа не читается
+    try {
+        Vector<double> wrong;
+        ReadFrom(fd, wrong);
+        assert(false && "Exception is expected");
+    } catch (const std::runtime_error&) {
+    }
+    // обрыв потока
+    assert(::ftruncate(fd, static_cast<off_t>(list.TotalBytes()) + 100) == 0);
+    assert(::lseek(fd, static_cast<off_t>(list.TotalBytes()), SEEK_SET) == static_cast<off_t>(list.TotalBytes()));
+    try {
+        ReadFrom(fd, numbers_copy);
+        assert(false && "Exception is expected");
+    } catch (const std::runtime_error&) {
+    }
+    // при ошибке вектор не меняется
+    assert(numbers_copy.Size() == 1000 && std::equal(numbers.begin(), numbers.end(), numbers_copy.begin()));
+    // испорченное количество элементов: переполнение размера и поток короче заголовка
+    for (const uint64_t count : {uint64_t{1} << 62, uint64_t{1} << 40}) {
+        SerializedHeader header{};
+        std::memcpy(header.magic, SerializedHeader::MAGIC, sizeof(header.magic));
+        header.version = SerializedHeader::VERSION;
+        header.element_size = sizeof(int);
+        header.count = count;
+        assert(::ftruncate(fd, 0) == 0 && ::lseek(fd, 0, SEEK_SET) == 0);
+        assert(::write(fd, &header, sizeof(header)) == sizeof(header));
+        assert(::write(fd, numbers.begin(), 100 * sizeof(int)) == 100 * sizeof(int));
+        assert(::lseek(fd, 0, SEEK_SET) == 0);
+        try {
+            ReadFrom(fd, numbers_copy);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(numbers_copy.Size() == 1000);
+        header.nesting = 1;
+        header.element_size = sizeof(Record);
+        assert(::lseek(fd, 0, SEEK_SET) == 0 && ::write(fd, &header, sizeof(header)) == sizeof(header));
+        assert(::lseek(fd, 0, SEEK_SET) == 0);
+        try {
+            ReadFrom(fd, nested_copy);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(nested_copy.Size() == 3 && nested_copy[2].Size() == 2);
+    }
+    ::close(fd);
+    std::filesystem::remove(path);
+}
+
+void Test19() {
+    static_assert(SegmentLayout<4>::SegmentOf(3) == 0 && SegmentLayout<4>::SegmentOf(4) == 1);
+    static_assert(SegmentLayout<4>::SegmentOf(11) == 1 && SegmentLayout<4>::SegmentOf(12) == 2);
+    static_assert(SegmentLayout<4>::SegmentBase(2) == 12 && SegmentLayout<4>::SegmentsFor(13) == 3);
+    {
+        const size_t THREADS = 8;
+        const size_t PER_THREAD = 20'000;
+        ConcurrentVector<std::pair<size_t, size_t>> v;
+        const auto* first = &v.EmplaceBack(SIZE_MAX, SIZE_MAX);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&v, t] {
+                for (size_t i = 0; i < PER_THREAD; ++i) {
+                    if (i % 100 == 0) {
+                        const size_t index = v.GrowBy(10, {t, i});
+                        assert(v.IsPublished(index + 9) && v[index + 9].first == t);
+                    } else {
+                        auto& item = v.EmplaceBack(t, i);
+                        assert(item.first == t && item.second == i);
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        // рост не переносит элементы
+        assert(&v[0] == first);
+        const size_t expected = 1 + THREADS * (PER_THREAD + PER_THREAD / 100 * 9);
+        assert(v.Size() == expected && v.Capacity() >= expected);
+        // каждый поток добавлял свои элементы по возрастанию i
+        std::vector<size_t> last(THREADS, 0);
+        std::vector<size_t> counts(THREADS, 0);
+        for (size_t i = 1; i < v.Size(); ++i) {
+            assert(v.IsPublished(i));
+            const auto [t, n] = v[i];
+            assert(n >= last[t]);
+            last[t] = n;
+            ++counts[t];
+        }
+        assert(std::all_of(counts.begin(), counts.end(), [](size_t c) {
+            return c == PER_THREAD + PER_THREAD / 100 * 9;
+        }));
+    }
+    {
+        // каждый сегмент и его признаки выделяются ровно один раз, как бы потоки ни соревновались
+        using Counting = ConcurrentCountingAllocator<void>;
+        Counting::num_allocations = 0;
+        const size_t THREADS = 8;
+        ConcurrentVector<int, ConcurrentCountingAllocator<int>, 1> v;
+        std::atomic<bool> start = false;
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&v, &start] {
+                while (!start.load()) {
+                }
+                for (int i = 0; i < 1000; ++i) {
+                    v.EmplaceBack(i);
+                }
+            });
+        }
+        start = true;
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        const size_t segments = SegmentLayout<1>::SegmentsFor(v.Size());
+        assert(Counting::num_allocations == static_cast<int>(2 * segments));
+    }
+    {
+        SharedObj::num_alive = 0;
+        SharedObj::construction_limit = 3;
+        {
+            ConcurrentVector<SharedObj, std::allocator<SharedObj>, 2> v;
+            v.Reserve(5);
+            assert(v.Capacity() == 6);
+            v.GrowBy(2);
+            try {
+                v.GrowBy(2);
+                assert(false && "Exception is expected");
+            } catch (const std::runtime_error&) {
+            }
+            // индекс, на котором конструктор выбросил исключение, остаётся неопубликованным
+            assert(v.Size() == 4 && v.IsPublished(2) && !v.IsPublished(3));
+            SharedObj::construction_limit = INT_MAX;
+            v.EmplaceBack();
+            assert(v.IsPublished(4) && SharedObj::num_alive == 4);
+            v.Clear();
+            assert(v.IsEmpty() && SharedObj::num_alive == 0 && v.Capacity() == 6);
+            v.EmplaceBack();
+        }
+        assert(SharedObj::num_alive == 0);
+    }
+}
+
+void Test20() {
+    static_assert(std::random_access_iterator<SegmentedVector<int>::iterator>);
+    static_assert(std::random_access_iterator<SegmentedVector<int>::const_iterator>);
+    {
+        SegmentedVector<std::string, std::allocator<std::string>, 4> v;
+        const std::string* first = &v.EmplaceBack("first");
+        for (int i = 1; i < 100; ++i) {
+            v.PushBack(std::to_string(i));
+        }
+        // рост не переносит элементы
+        assert(&v[0] == first && v[0] == "first");
+        assert(v.Size() == 100 && v.Capacity() == 124);
+        assert(v[99] == "99" && *(v.begin() + 50) == "50" && v.end() - v.begin() == 100);
+        std::sort(v.begin() + 1, v.end());
+        assert(std::is_sorted(v.begin() + 1, v.end()) && v[1] == "1" && v[2] == "10");
+
+        SegmentedVector<std::string, std::allocator<std::string>, 4> copy(v);
+        assert(copy.Size() == 100 && std::equal(copy.begin(), copy.end(), v.begin()));
+        v.Resize(3);
+        copy = v;
+        assert(copy.Size() == 3 && copy[2] == "10");
+        v = std::move(copy);
+        assert(v.Size() == 3 && copy.IsEmpty());
+        v.Resize(40);
+        assert(v.Size() == 40 && v[39].empty());
+        v.PopBack();
+        v.ShrinkToFit();
+        // блоки на 4, 8, 16 и 32 элемента
+        assert(v.Size() == 39 && v.Capacity() == 60);
+        v.Reserve(61);
+        assert(v.Capacity() == 124);
+        v.Clear();
+        assert(v.IsEmpty() && v.Capacity() == 124);
+    }
+    {
+        SharedObj::num_alive = 0;
+        SharedObj::construction_limit = 30;
+        {
+            SegmentedVector<SharedObj> v(10);
+            try {
+                v.Resize(40);
+                assert(false && "Exception is expected");
+            } catch (const std::runtime_error&) {
+            }
+            // строгая гарантия: вектор не изменился
+            assert(v.Size() == 10 && SharedObj::num_alive == 10);
+            SharedObj::construction_limit = INT_MAX;
+            v.Resize(40);
+            assert(SharedObj::num_alive == 40);
+        }
+        assert(SharedObj::num_alive == 0);
+    }
+    {
+        std::pmr::monotonic_buffer_resource resource;
+        SegmentedVector<int, std::pmr::polymorphic_allocator<int>> v(&resource);
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.GetAllocator().resource() == &resource);
+        SegmentedVector<int, std::pmr::polymorphic_allocator<int>> other(std::move(v));
+        assert(other.Size() == 1000 && other[999] == 999);
+    }
+}
+
+template <typename T>
+void CheckSimdKernels() {
+    for (size_t size : {0, 1, 7, 16, 33, 64, 100, 1000, 5000}) {
+        Vector<T> v(size);
+        for (size_t i = 0; i < size; ++i) {
+            v[i] = static_cast<T>((i * 7) % 100);
+        }
+        for (T value : {T(0), T(42), T(99), T(100)}) {
+            const size_t expected = std::find(v.begin(), v.end(), value) - v.begin();
+            assert(simd::Find(v, value) == expected);
+            assert(simd::Count(v, value) == static_cast<size_t>(std::count(v.begin(), v.end(), value)));
+        }
+        Vector<T> copy(v);
+        assert(v == copy && simd::Equal(v, copy));
+        if (size != 0) {
+            copy[size - 1] = T(1);
+            assert(!(v == copy));
+            copy[size - 1] = v[size - 1];
+            copy[size / 2] = T(101);
+            assert(v != copy);
+            // первое значение минимально, последнее максимально
+            copy[0] = std::numeric_limits<T>::lowest();
+            copy[size - 1] = std::numeric_limits<T>::max();
+            const auto [min, max] = simd::MinMax(copy);
+            assert(max == std::numeric_limits<T>::max());
+            assert(size == 1 || min == std::numeric_limits<T>::lowest());
+            const auto [first_min, first_max] = simd::MinMax(v);
+            assert(first_min == *std::min_element(v.begin(), v.end()));
+            assert(first_max == *std::max_element(v.begin(), v.end()));
+        }
+        using Lane = std::conditional_t<std::is_integral_v<T>, std::make_unsigned<T>, std::type_identity<T>>::type;
+        Lane sum{};
+        for (const T& x : v) {
+            sum += static_cast<Lane>(x);
+        }
+        // все слагаемые целые и малы, поэтому сумма float точна независимо от порядка
+        assert(simd::Sum(v) == static_cast<T>(sum));
+        simd::Fill(v, T(5));
+        assert(simd::Count(v, T(5)) == size);
+    }
+}
+
+void Test21() {
+    const simd::SimdLevel detected = simd::GetSimdLevel();
+    for (simd::SimdLevel level : {simd::SimdLevel::SCALAR, simd::SimdLevel::VECTOR_128, simd::SimdLevel::AVX2,
+                                  simd::SimdLevel::AVX512}) {
+        simd::SetSimdLevel(level);
+        assert(simd::GetSimdLevel() <= level);
+        CheckSimdKernels<int8_t>();
+        CheckSimdKernels<uint8_t>();
+        CheckSimdKernels<int16_t>();
+        CheckSimdKernels<int32_t>();
+        CheckSimdKernels<uint64_t>();
+        CheckSimdKernels<float>();
+        CheckSimdKernels<double>();
+
+        // NaN не равен себе, -0.0 равен 0.0
+        Vector<double> lhs(40);
+        Vector<double> rhs(40);
+        rhs[20] = -0.0;
+        assert(lhs == rhs);
+        lhs[30] = rhs[30] = std::numeric_limits<double>::quiet_NaN();
+        assert(lhs != rhs);
+        assert(simd::Find(lhs, lhs[30]) == lhs.Size());
+
+        // из равных -0.0 и 0.0 MinMax, как и скалярный проход, оставляет первый
+        for (double first_zero : {0.0, -0.0}) {
+            Vector<double> zeros(40);
+            for (size_t i = 0; i != zeros.Size(); ++i) {
+                zeros[i] = i < 5 ? 1.0 : (i == 5 ? first_zero : -first_zero);
+            }
+            assert(std::signbit(simd::MinMax(zeros).first) == std::signbit(first_zero));
+            for (double& x : zeros) {
+                x = -x;
+            }
+            assert(std::signbit(simd::MinMax(zeros).second) != std::signbit(first_zero));
+        }
+    }
+    simd::SetSimdLevel(detected);
+    assert(simd::GetSimdLevel() == detected);
+
+    Vector<std::string> strings(3);
+    Vector<std::string> other(strings);
+    assert(strings == other);
+    other[1] = "x";
+    assert(strings != other);
+}
+
+void Test22() {
+    {
+        SoAVector<int, double, std::string> v;
+        for (int i = 0; i != 100; ++i) {
+            auto [id, weight, name] = v.EmplaceBack(i, i * 0.5, std::to_string(i));
+            assert(id == i && weight == i * 0.5 && name == std::to_string(i));
+        }
+        assert(v.Size() == 100);
+        assert(v.Capacity() == 128);
+        assert(v.Column<0>().size() == 100 && v.Column<2>().size() == 100);
+        assert(v.Column<1>().data() + 100 <= v.Column<1>().data() + v.Capacity());
+
+        // прокси-ссылка записывает поля строки
+        v[10] = std::make_tuple(-1, 2.5, std::string("ten"));
+        assert(std::get<0>(v[10]) == -1 && v.Column<2>()[10] == "ten");
+        std::get<1>(v[11]) = 7.0;
+        assert(v.Column<1>()[11] == 7.0);
+
+        // аргументы могут ссылаться на строки самого вектора
+        v.ShrinkToFit();
+        assert(v.Capacity() == 100);
+        std::string& first_name = std::get<2>(v[0]);
+        v.EmplaceBack(std::get<0>(v[0]), 0.0, first_name);
+        assert(v.Column<2>()[100] == "0");
+
+        SoAVector<int, double, std::string> copy(v);
+        assert(copy.Size() == v.Size() && copy[10] == v[10]);
+        SoAVector<int, double, std::string> moved(std::move(copy));
+        assert(copy.IsEmpty() && copy.Capacity() == 0 && moved.Column<2>()[50] == "50");
+        moved.PopBack();
+        moved.Resize(3);
+        assert(moved.Size() == 3 && std::get<2>(moved[2]) == "2");
+        moved.Resize(5);
+        assert(std::get<0>(moved[4]) == 0 && std::get<2>(moved[4]).empty());
+        v.Swap(moved);
+        assert(v.Size() == 5 && moved.Size() == 101);
+        moved = v;
+        assert(moved.Size() == 5);
+    }
+    {
+        // копирование при переносе выбрасывает исключение: вектор остаётся прежним
+        Obj::ResetCounters();
+        SoAVector<Obj, CopyOnly> v;
+        v.Reserve(4);
+        for (int i = 0; i != 4; ++i) {
+            v.EmplaceBack(i, CopyOnly(i));
+        }
+        const Obj* obj_column = v.Column<0>().data();
+        CopyOnly::throw_id = 2;
+        try {
+            v.EmplaceBack(4, CopyOnly(4));
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 4 && v.Capacity() == 4 && v.Column<0>().data() == obj_column);
+        assert(std::get<0>(v[3]).id == 3 && std::get<1>(v[3]).id == 3);
+        assert(Obj::GetAliveObjectCount() == 4);
+        CopyOnly::throw_id = -1;
+        v.EmplaceBack(4, CopyOnly(4));
+        assert(v.Size() == 5 && std::get<0>(v[4]).id == 4 && Obj::GetAliveObjectCount() == 5);
+        // столбец Obj перенесён перемещением, без копий
+        assert(Obj::num_copied == 0);
+    }
+    {
+        // исключение в конструкторах: уже созданные строки уничтожаются
+        Obj::ResetCounters();
+        SoAVector<Obj, CopyOnly> v;
+        for (int i = 0; i != 4; ++i) {
+            v.EmplaceBack(i, CopyOnly(i));
+        }
+        CopyOnly::throw_id = 2;
+        try {
+            SoAVector<Obj, CopyOnly> copy(v);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        CopyOnly::throw_id = -1;
+        assert(Obj::GetAliveObjectCount() == 4);
+        Obj::default_construction_throw_countdown = 3;
+        try {
+            SoAVector<Obj, int> sized(5);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(Obj::GetAliveObjectCount() == 4);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test23() {
+    const int SIZE = 10;
+    auto is_odd = [](const Obj& obj) {
+        return obj.id % 2 != 0;
+    };
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        v.Reserve(SIZE);
+        for (int i = 0; i != SIZE; ++i) {
+            v.EmplaceBack(i);
+        }
+        // удаление из середины стоит одного перемещения вместо сдвига хвоста
+        auto pos = v.SwapErase(v.begin() + 2);
+        assert(pos == v.begin() + 2 && pos->id == SIZE - 1);
+        assert(Obj::num_move_assigned == 1 && Obj::num_destroyed == 1);
+        assert(v.SwapErase(v.end() - 1) == v.end());
+        assert(v.Size() == SIZE - 2 && Obj::GetAliveObjectCount() == SIZE - 2);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        for (int i = 0; i != SIZE; ++i) {
+            v.EmplaceBack(i);
+        }
+        const int moved = Obj::num_moved;
+        // каждый оставшийся элемент после первого удалённого перемещается ровно один раз
+        assert(v.EraseIf(is_odd) == SIZE / 2);
+        assert(Obj::num_move_assigned == SIZE / 2 - 1 && Obj::num_moved == moved);
+        assert(v.Size() == SIZE / 2 && Obj::GetAliveObjectCount() == SIZE / 2);
+        for (int i = 0; i != SIZE / 2; ++i) {
+            assert(v[i].id == 2 * i);
+        }
+        assert(v.EraseIf(is_odd) == 0);
+
+        Obj::num_move_assigned = 0;
+        for (int i = 0; i != SIZE / 2; ++i) {
+            v.EmplaceBack(2 * i + 1);
+        }
+        // на места удалённых переносятся элементы с конца, порядок не сохраняется;
+        // последний удалённый сам оказался в конце и перемещения не потребовал
+        assert(v.RemoveIf([](const Obj& obj) {
+            return obj.id < 4;
+        }) == 4);
+        assert(Obj::num_move_assigned == 3);
+        assert(v.Size() == SIZE - 4 && Obj::GetAliveObjectCount() == SIZE - 4);
+        assert(std::none_of(v.begin(), v.end(), [](const Obj& obj) {
+            return obj.id < 4;
+        }));
+    }
+    {
+        // побайтово переносимые элементы при сжатии не перемещаются конструктором
+        Vector<Handle> v;
+        for (int i = 0; i != SIZE; ++i) {
+            v.EmplaceBack(i);
+        }
+        Handle::num_moved = 0;
+        auto is_even = [](const Handle& handle) {
+            return *handle.ptr % 2 == 0;
+        };
+        assert(v.EraseIf(is_even) == SIZE / 2);
+        assert(v.RemoveIf([](const Handle& handle) {
+            return *handle.ptr == 1;
+        }) == 1);
+        v.SwapErase(v.begin());
+        assert(Handle::num_moved == 0 && v.Size() == SIZE / 2 - 2);
+        assert(*v[0].ptr == 7 && *v[1].ptr == 3 && *v[2].ptr == 5);
+    }
+    {
+        // исключение из предиката: проверенные и отброшенные элементы удалены, остальные сохранены
+        Vector<int> v;
+        for (int i = 0; i != SIZE; ++i) {
+            v.PushBack(i);
+        }
+        try {
+            v.EraseIf([](int x) {
+                if (x == 6) {
+                    throw std::runtime_error("Oops");
+                }
+                return x % 3 == 0;
+            });
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(std::ranges::equal(v, std::vector<int>{1, 2, 4, 5, 6, 7, 8, 9}));
+        try {
+            v.RemoveIf([](int x) {
+                if (x == 9) {
+                    throw std::runtime_error("Oops");
+                }
+                return x == 1;
+            });
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 7 && v[0] == 9);
+    }
+    {
+        // исключение из сдвига после исключения из предиката выходит из EraseIf, а не завершает программу
+        Obj::ResetCounters();
+        Vector<ThrowingMoveAssign> v;
+        v.Reserve(SIZE);
+        for (int i = 0; i != SIZE; ++i) {
+            v.EmplaceBack(i);
+        }
+        ThrowingMoveAssign::assign_throw_countdown = 2;
+        try {
+            v.EraseIf([](const Obj& obj) {
+                if (obj.id == 3) {
+                    throw std::logic_error("predicate");
+                }
+                return obj.id == 1;
+            });
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == static_cast<size_t>(SIZE) && Obj::GetAliveObjectCount() == SIZE);
+        assert(v[1].id == 2);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+/// Таблица, построенная на этапе компиляции: квадраты чисел 0..count-1 без чисел, кратных трём,
+/// и с вставленной в начало меткой -1
+constexpr Vector<int> MakeSquaresTable(int count) {
+    Vector<int> v;
+    for (int i = 0; i != count; ++i) {
+        v.PushBack(i * i);
+    }
+    v.EraseIf([](int x) {
+        return x % 3 == 0;
+    });
+    v.Insert(v.begin(), -1);
+    v.Insert(v.end(), 2, 0);
+    v.Erase(v.end() - 2);
+    return v;
+}
+
+template <size_t N>
+constexpr std::array<int, N> ToArray(const Vector<int>& v) {
+    std::array<int, N> result{};
+    std::copy(v.begin(), v.end(), result.begin());
+    return result;
+}
+
+constexpr bool CheckConstexprVector() {
+    Vector<std::string> strings(2);
+    strings[0] = "first";
+    strings.EmplaceBack(5, 'x');
+    strings.Insert(strings.begin() + 1, std::string("inserted"));
+    strings.Reserve(16);
+    Vector<std::string> copy(strings);
+    copy.SwapErase(copy.begin());
+    copy.RemoveIf([](const std::string& str) {
+        return str.empty();
+    });
+    Vector<std::string> moved;
+    moved = std::move(copy);
+    moved.Resize(4);
+    moved.ShrinkToFit();
+    return strings.Size() == 4 && strings[1] == "inserted" && strings[3] == "xxxxx" && strings != moved
+           && moved.Size() == 4 && moved.Capacity() == 4 && moved[0] == "xxxxx" && moved[1] == "inserted";
+}
+
+void Test24() {
+    constexpr size_t SIZE = MakeSquaresTable(10).Size();
+    static_assert(SIZE == 8);
+    // значения переносятся в массив со статическим временем жизни
+    static constexpr std::array<int, SIZE> TABLE = ToArray<SIZE>(MakeSquaresTable(10));
+    static_assert(TABLE[0] == -1 && TABLE[1] == 1 && TABLE[2] == 4 && TABLE[3] == 16 && TABLE[6] == 64);
+    static_assert(TABLE[7] == 0);
+    static_assert(CheckConstexprVector());
+    static_assert(MakeSquaresTable(10) == MakeSquaresTable(10));
+
+    // те же функции во время выполнения используют побайтовые и векторизованные пути
+    assert(CheckConstexprVector());
+    const Vector<int> runtime_table = MakeSquaresTable(10);
+    assert(std::equal(runtime_table.begin(), runtime_table.end(), TABLE.begin(), TABLE.end()));
+}
+
+void Test25() {
+    using namespace std::literals;
+    {
+        // поиск без ветвлений совпадает с std::lower_bound и std::upper_bound
+        std::vector<int> data;
+        for (int size = 0; size != 40; ++size) {
+            for (int key = -1; key <= size + 1; ++key) {
+                const size_t lower = std::lower_bound(data.begin(), data.end(), key) - data.begin();
+                const size_t upper = std::upper_bound(data.begin(), data.end(), key) - data.begin();
+                assert(flat_map_detail::LowerBound(data.data(), data.size(), key, std::less<>()) == lower);
+                assert(flat_map_detail::UpperBound(data.data(), data.size(), key, std::less<>()) == upper);
+            }
+            data.push_back(size / 3 * 2);
+        }
+    }
+    {
+        FlatSet<int> set(std::vector<int>{5, 1, 5, 3, 9, 1});
+        assert(std::ranges::equal(set, std::vector<int>{1, 3, 5, 9}));
+        assert(set.Insert(4).second && !set.Insert(4).second);
+        assert(*set.Insert(7).first == 7);
+        assert(set.Contains(9) && !set.Contains(2) && set.Find(2) == set.end());
+        assert(*set.LowerBound(6) == 7 && set.UpperBound(9) == set.end());
+        assert(set.Erase(3) == 1 && set.Erase(3) == 0);
+
+        // вставка отсортированного диапазона с пересечениями и повторами
+        set.InsertSorted(std::vector<int>{0, 1, 2, 2, 8, 10});
+        assert(std::ranges::equal(set, std::vector<int>{0, 1, 2, 4, 5, 7, 8, 9, 10}));
+        // все новые ключи больше прежних: сливать не нужно
+        set.InsertSorted(std::vector<int>{10, 11, 11, 12});
+        assert(std::ranges::equal(set, std::vector<int>{0, 1, 2, 4, 5, 7, 8, 9, 10, 11, 12}));
+        set.Clear();
+        assert(set.IsEmpty());
+    }
+    {
+        FlatSet<std::string, std::less<>> names;
+        names.Reserve(3);
+        names.Insert("beta"s);
+        names.Insert("alpha"s);
+        assert(names.Capacity() >= 3);
+        // поиск по string_view без создания std::string
+        assert(names.Contains("alpha"sv) && names.Find("gamma"sv) == names.end());
+        assert(names.LowerBound("b"sv) - names.begin() == 1);
+    }
+    {
+        FlatMap<std::string, int, std::less<>> config;
+        config["timeout"] = 30;
+        config["retries"] = 3;
+        assert(config.TryEmplace("retries"s, 5).second == false && config.At("retries") == 3);
+        assert(config.InsertOrAssign("retries", 4).second == false && config.At("retries") == 4);
+        assert(config.Size() == 2 && config.Keys()[0] == "retries");
+        auto it = config.Find("timeout"sv);
+        assert(it != config.end() && (*it).second == 30);
+        (*it).second = 60;
+        assert(config.Values()[1] == 60);
+        assert(config.Contains("timeout"sv) && !config.Contains("port"sv));
+        try {
+            config.At("port");
+            assert(false);
+        } catch (const std::out_of_range&) {
+        }
+
+        std::vector<std::pair<std::string, int>> batch{{"host", 1}, {"port", 2}, {"timeout", 3}, {"zone", 4}};
+        config.InsertSorted(batch);
+        assert(config.Size() == 5);
+        assert(config.At("timeout") == 60 && config.At("port") == 2 && config.At("zone") == 4);
+        for (auto [key, value] : config) {
+            assert(config.At(key) == value);
+        }
+        auto erased = config.Erase(config.Find("host"));
+        assert((*erased).first == "port" && config.Erase("host") == 0 && config.Size() == 4);
+        assert(std::is_sorted(config.Keys().begin(), config.Keys().end()));
+    }
+    {
+        // сравнение со std::map на псевдослучайных данных
+        FlatMap<int, int> map;
+        std::map<int, int> expected;
+        uint32_t seed = 12345;
+        auto next = [&seed] {
+            seed = seed * 1664525 + 1013904223;
+            return static_cast<int>(seed >> 24);
+        };
+        for (int round = 0; round != 20; ++round) {
+            std::vector<std::pair<int, int>> batch;
+            for (int i = 0; i != 16; ++i) {
+                batch.emplace_back(next(), round);
+            }
+            std::ranges::stable_sort(batch, {}, &std::pair<int, int>::first);
+            map.InsertSorted(batch);
+            expected.insert(batch.begin(), batch.end());
+            map.TryEmplace(next(), -1);
+            expected.try_emplace(static_cast<int>(seed >> 24), -1);
+            map.Erase(next());
+            expected.erase(static_cast<int>(seed >> 24));
+        }
+        assert(map.Size() == expected.size());
+        assert(std::equal(map.begin(), map.end(), expected.begin(), expected.end(),
+                          [](const auto& lhs, const auto& rhs) {
+                              return lhs.first == rhs.first && lhs.second == rhs.second;
+                          }));
+        static_assert(std::random_access_iterator<FlatMap<int, int>::iterator>);
+    }
+    {
+        // слияние, которое бросает исключение, не оставляет в отображении дописанного хвоста
+        FlatMap<int, CopyOnly> map;
+        std::vector<std::pair<int, CopyOnly>> batch{{1, CopyOnly(1)}, {5, CopyOnly(5)}, {9, CopyOnly(9)}};
+        map.InsertSorted(batch);
+        batch = {{0, CopyOnly(0)}, {5, CopyOnly(50)}, {7, CopyOnly(7)}};
+        CopyOnly::throw_id = 9;
+        try {
+            map.InsertSorted(batch);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        CopyOnly::throw_id = -1;
+        assert(map.Size() == 3 && map.Keys()[0] == 1 && map.Keys()[2] == 9 && map.At(9).id == 9);
+        map.InsertSorted(batch);
+        assert(map.Size() == 5 && std::is_sorted(map.Keys().begin(), map.Keys().end()));
+        assert(map.At(0).id == 0 && map.At(5).id == 5 && map.At(7).id == 7);
+    }
+    {
+        // значения, перемещение которых бросает, при слиянии копируются
+        FlatMap<int, MaybeThrowingMove> map;
+        std::vector<std::pair<int, MaybeThrowingMove>> batch;
+        batch.emplace_back(2, MaybeThrowingMove(2));
+        batch.emplace_back(4, MaybeThrowingMove(4));
+        map.InsertSorted(batch);
+        batch[0] = {1, MaybeThrowingMove(1)};
+        batch[1] = {3, MaybeThrowingMove(3)};
+        MaybeThrowingMove::move_throw_countdown = 1;
+        map.InsertSorted(batch);
+        MaybeThrowingMove::move_throw_countdown = 0;
+        assert(map.Size() == 4 && map.Keys()[0] == 1 && map.Keys()[3] == 4);
+        assert(map.At(1).id == 1 && map.At(2).id == 2 && map.At(3).id == 3 && map.At(4).id == 4);
+    }
+}
+
+void Test26() {
+    {
+        CowVector<int> v;
+        assert(v.IsEmpty() && v.UseCount() == 0 && v.begin() == v.end());
+        for (int i = 0; i != 10; ++i) {
+            v.PushBack(i);
+        }
+        // копия разделяет блок
+        CowVector<int> snapshot(v);
+        assert(v.UseCount() == 2 && snapshot.Get().begin() == v.Get().begin());
+        const int* shared = std::as_const(v).begin();
+        // первое изменение клонирует элементы, снимок остаётся прежним
+        v[0] = 100;
+        assert(v.UseCount() == 1 && snapshot.UseCount() == 1);
+        assert(std::as_const(v).begin() != shared && std::as_const(snapshot).begin() == shared);
+        assert(std::as_const(v)[0] == 100 && std::as_const(snapshot)[0] == 0);
+        // следующие изменения выполняются на месте
+        const int* own = std::as_const(v).begin();
+        v.Erase(std::as_const(v).begin() + 1);
+        v.EmplaceBack(10);
+        assert(std::as_const(v).begin() == own);
+        assert(v.Size() == 10 && std::as_const(v)[1] == 2 && std::as_const(v)[9] == 10);
+
+        CowVector<int> other;
+        other = snapshot;
+        assert(other.UseCount() == 2);
+        // вставка в разделённый блок клонирует его с запасом под новый элемент
+        other.EmplaceBack(std::as_const(other)[9]);
+        assert(other.Size() == 11 && other.Capacity() > 11 && std::as_const(other)[10] == 9);
+        assert(snapshot.Size() == 10 && snapshot.UseCount() == 1);
+
+        snapshot.Modify([](Vector<int>& data) {
+            data.EraseIf([](int x) {
+                return x % 2 == 0;
+            });
+        });
+        assert(snapshot.Size() == 5 && std::as_const(snapshot)[0] == 1);
+        CowVector<int> moved(std::move(snapshot));
+        assert(snapshot.UseCount() == 0 && moved.UseCount() == 1 && moved.Size() == 5);
+        moved.Clear();
+        assert(moved.IsEmpty());
+    }
+    {
+        // после выдачи изменяемой ссылки копия получает собственные элементы
+        CowVector<int> v(Vector<int>(4));
+        int& first = v[0];
+        CowVector<int> snapshot = v;
+        assert(snapshot.UseCount() == 1 && v.UseCount() == 1);
+        first = 1;
+        assert(std::as_const(snapshot)[0] == 0 && std::as_const(v)[0] == 1);
+        int& last = v.EmplaceBack(5);
+        CowVector<int> other;
+        other = v;
+        last = 6;
+        assert(std::as_const(other)[4] == 5 && std::as_const(v)[4] == 6 && other.UseCount() == 1);
+        // PushBack ссылку не отдаёт, и копии снова разделяют блок
+        snapshot.PushBack(7);
+        CowVector<int> shared = snapshot;
+        assert(shared.UseCount() == 2 && shared.Get().begin() == snapshot.Get().begin());
+    }
+    {
+        // исключение при изменении разделённого блока сохраняет разделение
+        Obj::ResetCounters();
+        CowVector<Obj> v(Vector<Obj>(3));
+        CowVector<Obj> copy(v);
+        Obj bad;
+        bad.throw_on_copy = true;
+        try {
+            copy.PushBack(bad);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(copy.UseCount() == 2 && copy.Size() == 3);
+        assert(Obj::GetAliveObjectCount() == 4);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // снимки публикуются читателям, пока писатель продолжает изменять свою копию
+        CowVector<int> config(Vector<int>(100));
+        std::atomic<bool> stop = false;
+        std::vector<std::thread> readers;
+        std::atomic<int> published_version = 0;
+        std::mutex mutex;
+        CowVector<int> published = config;
+        for (int r = 0; r != 3; ++r) {
+            readers.emplace_back([&] {
+                while (!stop.load()) {
+                    CowVector<int> local;
+                    {
+                        std::lock_guard lock(mutex);
+                        local = published;
+                    }
+                    const int first = std::as_const(local)[0];
+                    assert(std::all_of(local.begin(), local.end(), [first](int x) {
+                        return x == first;
+                    }));
+                }
+            });
+        }
+        for (int version = 1; version != 50; ++version) {
+            config.Modify([version](Vector<int>& data) {
+                std::fill(data.begin(), data.end(), version);
+            });
+            std::lock_guard lock(mutex);
+            published = config;
+            published_version = version;
+        }
+        stop = true;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        assert(published_version == 49 && std::as_const(config)[99] == 49);
+    }
+}
+
+void Test27() {
+    {
+        const RecyclingStats before = GetRecyclingStats();
+        {
+            RecyclingVector<int> v;
+            for (int i = 0; i != 1000; ++i) {
+                v.PushBack(i);
+            }
+            // вместимость округлена до размера блока
+            assert(v.Capacity() * sizeof(int) == std::bit_ceil(v.Capacity() * sizeof(int)));
+        }
+        const RecyclingStats filled = GetRecyclingStats();
+        assert(filled.misses > before.misses);
+        // повторное заполнение проходит по тем же классам размера и не обращается к operator new
+        {
+            RecyclingVector<int> v;
+            for (int i = 0; i != 1000; ++i) {
+                v.PushBack(i);
+            }
+            assert(v[999] == 999);
+        }
+        const RecyclingStats refilled = GetRecyclingStats();
+        assert(refilled.misses == filled.misses);
+        assert(refilled.hits - filled.hits == filled.misses - before.misses);
+
+        // освобождённый в другом потоке буфер возвращается в кеш владельца
+        auto* moved = new RecyclingVector<int>(1000);
+        const int* buffer = moved->begin();
+        std::thread([moved] {
+            delete moved;
+        }).join();
+        const RecyclingStats returned = GetRecyclingStats();
+        assert(returned.remote_returns == refilled.remote_returns + 1);
+        RecyclingVector<int> reused(1000);
+        assert(reused.begin() == buffer);
+        assert(GetRecyclingStats().misses == returned.misses);
+    }
+    {
+        // кеш держит не больше заданного объёма на класс, но хотя бы один блок
+        SetRecyclingRetention(0);
+        const RecyclingStats before = GetRecyclingStats();
+        {
+            RecyclingVector<int> a(100);
+            RecyclingVector<int> b(100);
+            RecyclingVector<int> c(100);
+        }
+        const RecyclingStats after = GetRecyclingStats();
+        assert(after.trimmed >= before.trimmed + 2);
+        SetRecyclingRetention(256 * 1024);
+    }
+    {
+        // кеш завершившегося потока освобождается, а блоки, возвращённые ему позже, удаляются
+        RecyclingVector<std::string>* orphan = nullptr;
+        std::thread([&orphan] {
+            orphan = new RecyclingVector<std::string>(10);
+            (*orphan)[9].assign(100, 'x');
+            RecyclingVector<std::string> local(10);
+        }).join();
+        assert((*orphan)[9].size() == 100);
+        delete orphan;
+
+        Vector<std::thread> workers;
+        std::atomic<size_t> total = 0;
+        for (int t = 0; t != 4; ++t) {
+            workers.EmplaceBack([&total] {
+                for (int round = 0; round != 100; ++round) {
+                    RecyclingVector<size_t> v;
+                    for (size_t i = 0; i != 100; ++i) {
+                        v.PushBack(i);
+                    }
+                    total += v[99];
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        assert(total == 4 * 100 * 99);
+    }
+}
+
+void Test28() {
+    const std::span<const int> nodes = NumaNodes();
+    assert(!nodes.empty() && std::ranges::is_sorted(nodes));
+    constexpr size_t SIZE = 3 * 1024 * 1024 / sizeof(int) + 5;
+    {
+        // участки узлов не пересекаются и по порядку покрывают весь вектор
+        NumaVector<int> v(SIZE, NumaAllocator<int>(NumaPlacement::PARTITIONED));
+        assert(v[SIZE - 1] == 0 && v.GetAllocator().Placement() == NumaPlacement::PARTITIONED);
+        size_t next = 0;
+        for (int node : nodes) {
+            const auto [first, last] = LocalRange(v, node);
+            assert(first == next && first <= last);
+            if (first != last) {
+                const int placed = NodeOf(v, first);
+                assert(placed == -1 || placed == node || nodes.size() > 1);
+            }
+            next = last;
+        }
+        assert(next == SIZE);
+        assert(LocalRange(v, -1) == std::make_pair(size_t{0}, size_t{0}));
+    }
+    {
+        NumaVector<int> bound(SIZE, NumaAllocator<int>(NumaPlacement::BIND, nodes.front()));
+        const int placed = NodeOf(bound, SIZE / 2);
+        assert(placed == -1 || placed == nodes.front());
+        assert(LocalRange(bound, nodes.front()) == std::make_pair(size_t{0}, SIZE));
+
+        // перемещение в вектор с другим размещением переносит элементы
+        NumaVector<int> interleaved(NumaAllocator<int>(NumaPlacement::INTERLEAVE));
+        bound[7] = 7;
+        const int* buffer = bound.begin();
+        interleaved = std::move(bound);
+        assert(interleaved.Size() == SIZE && interleaved[7] == 7 && interleaved.begin() != buffer);
+        const int node = NodeOf(interleaved, SIZE - 1);
+        assert(node == -1 || std::ranges::binary_search(nodes, node));
+    }
+    {
+        // небольшой буфер выделяется operator new и целиком принадлежит узлу своей первой страницы
+        NumaVector<int> small(10, NumaAllocator<int>(NumaPlacement::PARTITIONED));
+        small.PushBack(1);
+        const int owner = NodeOf(small, 0);
+        assert(LocalRange(small, owner) == std::make_pair(size_t{0}, size_t{11}));
+
+        bool thrown = false;
+        try {
+            NumaAllocator<int> unavailable(NumaPlacement::BIND, -1);
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+}
+
+void Test29() {
+    constexpr size_t SIZE = 200000;
+    const ParallelPartitioner partitioners[] = {ParallelPartitioner::AUTO, ParallelPartitioner::SIMPLE,
+                                                ParallelPartitioner::STATIC};
+    {
+        Vector<int> v(SIZE);
+        for (ParallelPartitioner partitioner : partitioners) {
+            ParallelForEach(v, [](int& x) {
+                ++x;
+            }, partitioner);
+        }
+        assert(std::ranges::all_of(v, [](int x) {
+            return x == 3;
+        }));
+        std::atomic<size_t> visited = 0;
+        ParallelForEach(std::as_const(v), [&visited](const int& x) {
+            visited += x;
+        });
+        assert(visited == 3 * SIZE);
+    }
+    {
+        Vector<int> src(SIZE);
+        std::iota(src.begin(), src.end(), 0);
+        // результат создаётся сразу в памяти dst и добавляется после имеющихся элементов
+        Vector<std::string> dst;
+        dst.PushBack("head");
+        ParallelTransform(src, dst, [](int x) {
+            return std::to_string(x);
+        }, ParallelPartitioner::SIMPLE);
+        assert(dst.Size() == SIZE + 1 && dst[0] == "head" && dst[1] == "0" && dst[SIZE] == std::to_string(SIZE - 1));
+
+        // при исключении dst не меняется, а уже созданные строки уничтожаются
+        const std::string* buffer = dst.begin();
+        bool thrown = false;
+        try {
+            ParallelTransform(src, dst, [](int x) {
+                if (x == static_cast<int>(SIZE / 2)) {
+                    throw std::runtime_error("transform");
+                }
+                return std::string(32, 'x');
+            });
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown && dst.Size() == SIZE + 1 && dst.begin() == buffer);
+
+        Vector<double> halves;
+        ParallelTransform(src, halves, [](int x) {
+            return x / 2.0;
+        });
+        assert(halves.Size() == SIZE && halves[SIZE - 1] == (SIZE - 1) / 2.0);
+    }
+    {
+        Vector<uint32_t> v(SIZE);
+        uint32_t state = 12345;
+        for (auto& x : v) {
+            state = state * 1664525 + 1013904223;
+            x = state >> 8;
+        }
+        std::vector<uint32_t> expected(v.begin(), v.end());
+        std::sort(expected.begin(), expected.end());
+        ParallelSort(v);
+        assert(std::ranges::equal(v, expected));
+        ParallelSort(v, std::greater<>());
+        assert(std::ranges::equal(v, expected | std::views::reverse));
+    }
+    {
+        Vector<uint64_t> v(SIZE);
+        std::iota(v.begin(), v.end(), uint64_t{0});
+        for (ParallelPartitioner partitioner : partitioners) {
+            assert(ParallelReduce(v, uint64_t{0}, std::plus<>(), partitioner) == uint64_t{SIZE} * (SIZE - 1) / 2);
+        }
+        assert(ParallelReduce(Vector<int>(), 7) == 7);
+        // операция не обязана быть коммутативной: участки объединяются по порядку
+        Vector<std::string> letters(5000);
+        for (size_t i = 0; i != letters.Size(); ++i) {
+            letters[i] = static_cast<char>('a' + i % 26);
+        }
+        const std::string joined = ParallelReduce(letters, std::string(), [](std::string lhs, const std::string& rhs) {
+            return lhs += rhs;
+        }, ParallelPartitioner::SIMPLE);
+        assert(joined.size() == 5000 && joined.substr(0, 27) == "abcdefghijklmnopqrstuvwxyza");
+    }
+    {
+        for (ParallelPartitioner partitioner : partitioners) {
+            Vector<int> v(SIZE);
+            uint32_t state = 42;
+            for (auto& x : v) {
+                state = state * 1664525 + 1013904223;
+                x = static_cast<int>(state >> 16);
+            }
+            const int64_t sum = std::accumulate(v.begin(), v.end(), int64_t{0});
+            const auto evens = static_cast<size_t>(std::ranges::count_if(v, [](int x) {
+                return x % 2 == 0;
+            }));
+            std::atomic<size_t> calls = 0;
+            const size_t boundary = ParallelPartition(v, [&calls](int x) {
+                ++calls;
+                return x % 2 == 0;
+            }, partitioner);
+            assert(boundary == evens && calls == SIZE);
+            assert(std::all_of(v.begin(), v.begin() + boundary, [](int x) {
+                return x % 2 == 0;
+            }));
+            assert(std::none_of(v.begin() + boundary, v.end(), [](int x) {
+                return x % 2 == 0;
+            }));
+            assert(std::accumulate(v.begin(), v.end(), int64_t{0}) == sum);
+        }
+        Vector<std::string> words(3);
+        words[0] = "b";
+        words[1] = "a";
+        words[2] = "c";
+        assert(ParallelPartition(words, [](const std::string& w) {
+            return w == "a";
+        }) == 1);
+        assert(words[0] == "a");
+    }
+}
+
+void Test30() {
+    static_assert(std::random_access_iterator<PackedIntVector<>::Iterator>);
+    {
+        PackedIntVector<> v(10);
+        assert(v.Width() == 10 && v.IsEmpty());
+        for (uint64_t i = 0; i != 1000; ++i) {
+            v.PushBack(i * 7 % 1024);
+        }
+        assert(v.Size() == 1000 && v.Width() == 10 && v.MemoryUsage() < 1000 * sizeof(uint32_t));
+        for (uint64_t i = 0; i != 1000; ++i) {
+            assert(v.Get(i) == i * 7 % 1024);
+        }
+        // значение шире текущей ширины перепаковывает массив
+        v[500] = 5000;
+        assert(v.Width() == 13 && v[500] == 5000 && v[499] == 499 * 7 % 1024 && v[501] == 501 * 7 % 1024);
+        v.PushBack(uint64_t{1} << 40);
+        assert(v.Width() == 41 && v.Get(1000) == uint64_t{1} << 40 && v.Get(999) == 999 * 7 % 1024);
+        v.PopBack();
+        bool thrown = false;
+        try {
+            Vector<uint32_t> out;
+            v.UnpackTo(out);
+        } catch (const std::overflow_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+        v.Repack(13);
+        assert(v.Width() == 13 && v[500] == 5000);
+        thrown = false;
+        try {
+            v.Repack(4);
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown && v.Width() == 13 && v[999] == 999 * 7 % 1024);
+
+        // итераторы подходят к алгоритмам std::ranges
+        assert(std::ranges::max(v) == 5000);
+        assert(std::ranges::count(v, 7) == 1 && *std::ranges::find(v, 1023) == 1023);
+        v.Resize(10);
+        v.Resize(20);
+        assert(v[9] == 63 && v[10] == 0 && v[19] == 0);
+        v.Clear();
+        assert(v.IsEmpty() && v.begin() == v.end());
+    }
+    {
+        // пакетная распаковка совпадает с поштучным чтением при любой ширине и смещении
+        const simd::SimdLevel level = simd::GetSimdLevel();
+        for (unsigned width : {1U, 3U, 7U, 8U, 13U, 17U, 31U, 32U}) {
+            Vector<uint32_t> values(1000);
+            uint64_t state = width;
+            for (auto& x : values) {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                x = static_cast<uint32_t>((state >> 20) & packed_detail::LowMask(width));
+            }
+            values[0] = static_cast<uint32_t>(packed_detail::LowMask(width));
+            const auto packed = PackedIntVector<>::Pack(values);
+            assert(packed.Width() == width && std::ranges::equal(packed, values));
+            for (simd::SimdLevel l : {simd::SimdLevel::SCALAR, simd::SimdLevel::VECTOR_128, simd::SimdLevel::AVX2,
+                                      simd::SimdLevel::AVX512}) {
+                simd::SetSimdLevel(l);
+                Vector<uint32_t> out;
+                out.PushBack(42);
+                packed.UnpackTo(out);
+                assert(out.Size() == 1001 && out[0] == 42 && std::equal(values.begin(), values.end(), out.begin() + 1));
+                uint32_t part[37];
+                packed.Unpack(501, 37, part);
+                assert(std::equal(part, part + 37, values.begin() + 501));
+            }
+            simd::SetSimdLevel(level);
+        }
+        assert(PackedIntVector<>::Pack(Vector<uint64_t>()).Width() == 1);
+    }
+    {
+        BitVector<> bits;
+        std::vector<bool> expected;
+        uint32_t state = 7;
+        for (size_t i = 0; i != 5000; ++i) {
+            state = state * 1664525 + 1013904223;
+            const bool bit = (state >> 28) < 5;
+            bits.PushBack(bit);
+            expected.push_back(bit);
+        }
+        const auto ones = static_cast<size_t>(std::ranges::count(expected, true));
+        assert(bits.Count() == ones);
+        bits.BuildIndex();
+        size_t rank = 0;
+        for (size_t i = 0; i != expected.size(); ++i) {
+            assert(bits.Rank(i) == rank);
+            if (expected[i]) {
+                assert(bits.Select(rank) == i);
+                ++rank;
+            }
+            assert(bits[i] == expected[i]);
+        }
+        assert(bits.Rank(bits.Size()) == ones && bits.Select(ones) == bits.Size());
+        bits.Set(0, !expected[0]);
+        assert(!bits.HasIndex());
+        bits.Resize(70);
+        bits.Resize(200, true);
+        assert(bits.Count() == static_cast<size_t>(std::count(expected.begin() + 1, expected.begin() + 70, true))
+                                   + (expected[0] ? 0 : 1) + 130);
+        bits.PopBack();
+        assert(bits.Size() == 199 && bits.Words().size() == 4 && bits.Words()[3] >> 7 == 0);
+        BitVector<> all(129, true);
+        all.BuildIndex();
+        assert(all.Count() == 129 && all.Rank(100) == 100 && all.Select(128) == 128);
+    }
+    {
+        // рост в пределах одного слова не должен затирать биты до старого размера
+        BitVector<> bits(3, false);
+        bits.Resize(10, true);
+        assert(bits.Count() == 7 && !bits[0] && !bits[2] && bits[3] && bits[9]);
+        bits.Resize(64, true);
+        assert(bits.Count() == 61 && !bits[1]);
+    }
+    {
+        PackedIntVector<> source(100, 12);
+        source[99] = 4000;
+        PackedIntVector<> moved(std::move(source));
+        assert(moved.Size() == 100 && moved[99] == 4000);
+        assert(source.IsEmpty() && source.Capacity() == 0);
+        source.Clear();
+        source.PushBack(7);
+        source.PushBack(uint64_t{1} << 20);
+        assert(source.Size() == 2 && source[0] == 7 && source[1] == uint64_t{1} << 20);
+        source = std::move(moved);
+        assert(source.Size() == 100 && source[99] == 4000 && moved.IsEmpty());
+        moved.PushBack(1);
+        assert(moved.Size() == 1 && moved[0] == 1);
+
+        BitVector<> bits(100, true);
+        bits.BuildIndex();
+        BitVector<> moved_bits(std::move(bits));
+        assert(moved_bits.HasIndex() && moved_bits.Rank(100) == 100);
+        assert(bits.IsEmpty() && !bits.HasIndex() && bits.Count() == 0);
+        bits.PushBack(true);
+        bits.BuildIndex();
+        assert(bits.Size() == 1 && bits.Rank(1) == 1);
+        bits = std::move(moved_bits);
+        assert(bits.Size() == 100 && moved_bits.IsEmpty() && !moved_bits.HasIndex());
+    }
+}
+
+void Test31() {
+    static_assert(sizeof(CompactVector<int>) == 16 && sizeof(ThinVector<int>) == sizeof(void*));
+    static_assert(sizeof(CompactVector<Obj>) == 16 && sizeof(ThinVector<Obj>) == sizeof(void*));
+    static_assert(std::contiguous_iterator<CompactVector<int>::iterator>);
+    const size_t SIZE = 100;
+    auto check = [SIZE]<typename V>(V& v) {
+        assert(v.IsEmpty() && v.Capacity() == 0 && v.begin() == v.end());
+        for (size_t i = 0; i != SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        assert(v.Size() == SIZE && v.Capacity() >= SIZE);
+        // вставка ссылки на собственный элемент при реаллокации и при сдвиге
+        v.ShrinkToFit();
+        assert(v.Capacity() == SIZE);
+        v.Insert(v.begin() + 10, v[SIZE - 1]);
+        assert(v.Size() == SIZE + 1 && v[10].id == static_cast<int>(SIZE - 1) && v[11].id == 10);
+        v.Insert(v.begin(), v[SIZE]);
+        assert(v[0].id == static_cast<int>(SIZE - 1) && v[1].id == 0);
+        v.Erase(v.begin(), v.begin() + 1);
+        v.Erase(v.begin() + 10);
+        for (size_t i = 0; i != SIZE; ++i) {
+            assert(v[i].id == static_cast<int>(i));
+        }
+        V copy(v);
+        V moved(std::move(copy));
+        assert(copy.IsEmpty() && moved.Size() == SIZE && moved[SIZE - 1].id == static_cast<int>(SIZE - 1));
+        moved.Resize(3);
+        v = moved;
+        assert(v.Size() == 3 && v[2].id == 2);
+        v.Resize(5);
+        assert(v.Size() == 5 && v[4].id == 0);
+        // сильная гарантия: при ошибке копирования во время реаллокации вектор не меняется
+        v.ShrinkToFit();
+        Obj bad(7);
+        bad.throw_on_copy = true;
+        try {
+            v.PushBack(bad);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 5 && v.Capacity() == 5 && v[2].id == 2);
+        const std::vector<Obj> extra(4);
+        v.AppendRange(extra);
+        assert(v.Size() == 9);
+        // добавление собственных элементов при реаллокации
+        v.ShrinkToFit();
+        v.AppendRange(std::ranges::subrange(v.begin(), v.end()));
+        assert(v.Size() == 18 && v[11].id == 2 && v[17].id == 0);
+        v.Resize(9);
+        v.Clear();
+        assert(v.IsEmpty() && v.Capacity() >= 9);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 0);
+    };
+    Obj::ResetCounters();
+    {
+        CompactVector<Obj> compact;
+        check(compact);
+        ThinVector<Obj> thin;
+        check(thin);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    auto check_api = []<typename V>(V& v) {
+        v.Assign({5, 1, 4, 2, 3});
+        V other;
+        other.AssignRange(std::views::iota(1, 6));
+        assert(!(v == other));
+        other.Assign(v.begin(), v.end());
+        assert(v == other && v.Capacity() == 5);
+        // вставка нескольких копий собственного элемента со сдвигом и с реаллокацией
+        v.Reserve(8);
+        v.Insert(v.begin() + 1, 2, v[4]);
+        assert(std::ranges::equal(v, std::vector{5, 3, 3, 1, 4, 2, 3}));
+        v.Insert(v.end(), 3, v[0]);
+        assert(v.Size() == 10 && v[9] == 5);
+        const std::vector<int> middle{7, 8};
+        v.Insert(v.begin() + 2, middle.begin(), middle.end());
+        std::istringstream in("9 9");
+        v.Insert(v.begin(), std::istream_iterator<int>(in), std::istream_iterator<int>());
+        assert(std::ranges::equal(v, std::vector{9, 9, 5, 3, 7, 8, 3, 1, 4, 2, 3, 5, 5, 5}));
+        assert(v.EraseIf([](int x) { return x == 5; }) == 4);
+        assert(std::ranges::equal(v, std::vector{9, 9, 3, 7, 8, 3, 1, 4, 2, 3}));
+        assert(*v.SwapErase(v.begin()) == 3 && v.Size() == 9);
+        assert(v.RemoveIf([](int x) { return x == 3; }) == 3);
+        assert(v.Size() == 6 && std::ranges::count(v, 3) == 0);
+        v.Assign(3, v[1]);
+        assert(std::ranges::equal(v, std::vector{9, 9, 9}));
+        v.ResizeForOverwrite(4);
+        v[3] = 1;
+        v.ResizeForOverwrite(2);
+        assert(v.Size() == 2 && v[1] == 9);
+    };
+    {
+        CompactVector<int> compact;
+        check_api(compact);
+        ThinVector<int> thin;
+        check_api(thin);
+    }
+    {
+        // пустой ThinVector не выделяет памяти даже под заголовок
+        RebindCounters::num_allocations = 0;
+        RebindCounters::num_deallocations = 0;
+        {
+            ThinVector<int, RebindCountingAllocator<int>> v;
+            ThinVector<int, RebindCountingAllocator<int>> empty_copy(v);
+            assert(RebindCounters::num_allocations == 0);
+            v.PushBack(1);
+            v.PopBack();
+            assert(v.IsEmpty() && v.Capacity() == 1 && RebindCounters::num_allocations == 1);
+            v.ShrinkToFit();
+            assert(RebindCounters::num_deallocations == 1);
+        }
+        assert(RebindCounters::num_allocations == RebindCounters::num_deallocations);
+    }
+    {
+        // выравнивание элементов после заголовка
+        struct alignas(64) Wide {
+            int value = 0;
+        };
+        ThinVector<Wide> v(3);
+        assert(reinterpret_cast<uintptr_t>(v.begin()) % 64 == 0 && v.Size() == 3);
+    }
+    {
+        CompactVector<char> v;
+        try {
+            v.Reserve(size_t{UINT32_MAX} + 1);
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        assert(v.Capacity() == 0);
+    }
+}
+
+void Test32() {
+    static_assert(!std::is_nothrow_move_constructible_v<MaybeThrowingMove>);
+    static_assert(!std::is_nothrow_move_constructible_v<RelaxedMove>);
+    const size_t SIZE = 100;
+    // возвращает количество копирований и перемещений при трёх реаллокациях;
+    // по умолчанию элементы с бросающим перемещением копируются ради строгой гарантии
+    auto grow = [SIZE]<typename V>(V& v) {
+        for (size_t i = 0; i != SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        v.ShrinkToFit();
+        const int copied = Obj::num_copied;
+        const int moved = Obj::num_moved;
+        v.Reserve(SIZE * 2);
+        v.EmplaceBack(-1);
+        v.ShrinkToFit();
+        v.Emplace(v.begin() + 1, -2);
+        assert(v.Size() == SIZE + 2 && v[0].id == 0 && v[1].id == -2 && v[SIZE + 1].id == -1);
+        return std::pair{Obj::num_copied - copied, Obj::num_moved - moved};
+    };
+    const auto RELOCATED = static_cast<int>(3 * SIZE + 2);
+    Obj::ResetCounters();
+    {
+        Vector<MaybeThrowingMove> v;
+        const auto relocations = grow(v);
+        assert(relocations == std::pair(RELOCATED, 0));
+    }
+    {
+        // политика роста разрешает перемещение для одного вектора
+        Vector<MaybeThrowingMove, std::allocator<MaybeThrowingMove>, RelaxedGrowth<>> v;
+        const auto relocations = grow(v);
+        assert(relocations == std::pair(0, RELOCATED));
+    }
+    {
+        // специализация relocate_by_move разрешает перемещение для всех векторов
+        Vector<RelaxedMove> v;
+        const auto relocations = grow(v);
+        assert(relocations == std::pair(0, RELOCATED));
+        SmallVector<RelaxedMove, 4> small;
+        const int copied = Obj::num_copied;
+        for (size_t i = 0; i != SIZE; ++i) {
+            small.EmplaceBack(static_cast<int>(i));
+        }
+        assert(Obj::num_copied == copied && !small.IsInline());
+        CompactVector<MaybeThrowingMove, std::allocator<MaybeThrowingMove>, RelaxedGrowth<>> compact;
+        const auto compact_relocations = grow(compact);
+        assert(compact_relocations == std::pair(0, RELOCATED));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // базовая гарантия: после исключения при перемещении размер и буфер прежние,
+        // все элементы живы, но часть из них перемещена
+        Vector<RelaxedMove> v;
+        for (size_t i = 0; i != SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        v.ShrinkToFit();
+        const RelaxedMove* data = v.begin();
+        const int alive = Obj::GetAliveObjectCount();
+        RelaxedMove::move_throw_countdown = SIZE / 2;
+        try {
+            v.Reserve(SIZE * 2);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        RelaxedMove::move_throw_countdown = 0;
+        assert(v.Size() == SIZE && v.Capacity() == SIZE && v.begin() == data);
+        assert(Obj::GetAliveObjectCount() == alive);
+        assert(v[SIZE - 1].id == static_cast<int>(SIZE - 1));
+        v.Reserve(SIZE * 2);
+        assert(v.Capacity() == SIZE * 2 && v[SIZE - 1].id == static_cast<int>(SIZE - 1));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test33() {
+    using CountedVector = Vector<int, RebindCountingAllocator<int>>;
+    const int SIZE = 1'000'000;
+    std::string text;
+    for (int i = 0; i != SIZE; ++i) {
+        text += std::to_string(i) + ' ';
+    }
+    RebindCounters::num_allocations = 0;
+    RebindCounters::num_deallocations = 0;
+    {
+        // диапазон известного размера: одно выделение под точный размер
+        const CountedVector v(from_range, std::views::iota(0, SIZE));
+        assert(RebindCounters::num_allocations == 1);
+        assert(v.Size() == static_cast<size_t>(SIZE) && v.Capacity() == v.Size());
+        assert(v[0] == 0 && v[SIZE - 1] == SIZE - 1);
+    }
+    {
+        // однопроходный диапазон без подсказки растёт геометрически
+        std::istringstream in(text);
+        const CountedVector v(from_range, std::views::istream<int>(in));
+        assert(v.Size() == static_cast<size_t>(SIZE) && RebindCounters::num_allocations > 20);
+    }
+    RebindCounters::num_allocations = 0;
+    RebindCounters::num_deallocations = 0;
+    {
+        // с подсказкой размера память выделяется один раз
+        std::istringstream in(text);
+        CountedVector v(from_range, std::views::istream<int>(in), SIZE);
+        assert(v.Size() == static_cast<size_t>(SIZE) && v.Capacity() == v.Size());
+        assert(RebindCounters::num_allocations == 1 && v[SIZE - 1] == SIZE - 1);
+        // подсказка к диапазону известного размера не используется
+        v.AppendRange(std::views::iota(0, 10), SIZE);
+        assert(v.Size() == static_cast<size_t>(SIZE) + 10 && v.Capacity() < static_cast<size_t>(SIZE) * 2 + 10);
+        std::istringstream tail("1 2 3");
+        v.ShrinkToFit();
+        v.AppendRange(std::views::istream<int>(tail), 100);
+        assert(v.Size() == static_cast<size_t>(SIZE) + 13 && v.Capacity() == v.Size() + 97);
+    }
+    assert(RebindCounters::num_allocations == RebindCounters::num_deallocations);
+    {
+        const std::list<int> values = {1, 2, 3, 4, 5};
+        const Vector<int> from_list(values.begin(), values.end());
+        assert(from_list.Size() == 5 && from_list.Capacity() == 5 && from_list[4] == 5);
+        Vector<int> v = {9, 8, 7};
+        assert(v.Size() == 3 && v[0] == 9 && v[2] == 7);
+        CountedVector counted(SIZE / 2);
+        const int allocations = RebindCounters::num_allocations;
+        // присваивание в пределах вместимости не выделяет память
+        counted.AssignRange(std::vector<int>{4, 5, 6});
+        counted.Assign(values.begin(), values.end());
+        assert(counted.Size() == 5 && counted[0] == 1 && counted.Capacity() == static_cast<size_t>(SIZE / 2));
+        counted.AssignRange(std::views::iota(10, 12));
+        assert(counted.Size() == 2 && counted[1] == 11);
+        assert(RebindCounters::num_allocations == allocations);
+        v.Assign(5, v[1]);
+        assert(v.Size() == 5 && std::ranges::count(v, 8) == 5);
+        v.Assign(2, v[4]);
+        assert(v.Size() == 2 && v[1] == 8);
+        v = {1, 2};
+        assert(v.Size() == 2 && v[0] == 1 && v[1] == 2);
+        v.AssignRange(std::views::iota(0, 100));
+        assert(v.Size() == 100 && v[99] == 99);
+    }
+    Obj::ResetCounters();
+    {
+        // ошибка копирования не меняет вектор
+        std::list<Obj> source(3);
+        source.back().throw_on_copy = true;
+        Vector<Obj> v(2);
+        v[0].id = 1;
+        try {
+            v.AssignRange(source);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 2 && v[0].id == 1);
+        try {
+            v.Assign(source.begin(), source.end());
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 2 && v[0].id == 1);
+        v.Assign(4, v[0]);
+        assert(v.Size() == 4 && v[3].id == 1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // однопроходный источник: уже созданные элементы уничтожаются при исключении
+        const auto throws_on_input = [](auto&& construct, int alive = 0) {
+            std::istringstream in("1 2 3 -1 5");
+            try {
+                construct(in);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(Obj::GetAliveObjectCount() == alive);
+        };
+        throws_on_input([](std::istream& in) {
+            Vector<ThrowingFromId> v{std::istream_iterator<int>(in), std::istream_iterator<int>()};
+        });
+        throws_on_input([](std::istream& in) {
+            Vector<ThrowingFromId> v(from_range, std::views::istream<int>(in));
+        });
+        throws_on_input([](std::istream& in) {
+            Vector<ThrowingFromId> v(from_range, std::views::istream<int>(in), 2);
+        });
+        Vector<ThrowingFromId> v;
+        v.EmplaceBack(7);
+        throws_on_input([&v](std::istream& in) {
+            v.Assign(std::istream_iterator<int>(in), std::istream_iterator<int>());
+        }, 1);
+        throws_on_input([&v](std::istream& in) {
+            v.AssignRange(std::views::istream<int>(in));
+        }, 1);
+        assert(v.Size() == 1 && v[0].id == 7);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
 }
 
 int main() {
@@ -648,8 +3037,35 @@ int main() {
         Test4();
         Test5();
         Test6();
-        Benchmark();
+        Test7();
+        Test8();
+        Test9();
+        Test10();
+        Test11();
+        Test12();
+        Test13();
+        Test14();
+        Test15();
+        Test16();
+        Test17();
+        Test18();
+        Test19();
+        Test20();
+        Test21();
+        Test22();
+        Test23();
+        Test24();
+        Test25();
+        Test26();
+        Test27();
+        Test28();
+        Test29();
+        Test30();
+        Test31();
+        Test32();
+        Test33();
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
+        return 1;
     }
 }
\ No newline at end of file
@@ -0,0 +1,462 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+/// Режим открытия файла MappedVector
+enum class MappedMode {
+    /// только чтение: элементы читаются прямо из страничного кеша без копирования,
+    /// изменять вектор нельзя
+    READ_ONLY,
+    /// чтение и запись существующего файла; файл создаётся, если его нет
+    READ_WRITE,
+    /// новый пустой вектор: существующий файл усекается
+    CREATE,
+};
+
+/// Вектор тривиально копируемых элементов, хранящий их в отображённом в память файле (mmap, MAP_SHARED).
+/// Файл состоит из заголовка (сигнатура, размер элемента, количество элементов) и массива элементов.
+/// Вместимость равна количеству элементов, помещающихся в файл; рост выполняется через
+/// ftruncate и mremap по политике Growth. Размер хранится в заголовке внутри отображения,
+/// поэтому данные переживают процесс без отдельного сохранения, а Flush лишь дожидается записи на диск.
+/// Несколько процессов, открывших файл, разделяют одни и те же страницы кеша.
+/// Size читает размер из общего заголовка, но не больше собственной вместимости: элементы,
+/// которые другой процесс дописал за пределы отображения этого объекта, не видны до повторного
+/// открытия файла. Усекать файл (ShrinkToFit), пока его читают другие процессы, нельзя.
+/// Файл переносим только между процессами с одинаковым представлением T
+template <typename T, typename Growth = DoublingGrowth>
+class MappedVector {
+    static_assert(std::is_trivially_copyable_v<T>, "MappedVector requires trivially copyable elements");
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    /// Отображает файл path. При READ_ONLY и READ_WRITE проверяет заголовок существующего файла
+    /// и выбрасывает std::runtime_error, если файл создан для другого типа или повреждён.
+    /// Ошибки системных вызовов выбрасываются как std::system_error
+    explicit MappedVector(const std::string& path, MappedMode mode = MappedMode::READ_WRITE);
+
+    MappedVector(const MappedVector&) = delete;
+    MappedVector& operator=(const MappedVector&) = delete;
+
+    MappedVector(MappedVector&& other) noexcept;
+    MappedVector& operator=(MappedVector&& rhs) noexcept;
+
+    /// Снимает отображение; изменения уже находятся в страничном кеше и будут записаны ядром
+    ~MappedVector();
+
+    iterator begin() noexcept;
+    iterator end() noexcept;
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args);
+    iterator Erase(const_iterator pos) noexcept;
+    iterator Erase(const_iterator first, const_iterator last) noexcept;
+    iterator Insert(const_iterator pos, const T& value);
+
+    [[nodiscard]] size_t Size() const noexcept;
+    [[nodiscard]] size_t Capacity() const noexcept;
+    const T& operator[](size_t index) const noexcept;
+    /// В режиме READ_ONLY запись через возвращённую ссылку недопустима
+    T& operator[](size_t index) noexcept;
+    /// Увеличивает файл так, чтобы в нём поместилось new_capacity элементов
+    void Reserve(size_t new_capacity);
+    /// Усекает файл до размера вектора
+    void ShrinkToFit();
+    void Swap(MappedVector& other) noexcept;
+    /// Новые элементы обнуляются
+    void Resize(size_t new_size);
+
+    template <typename Type>
+    void PushBack(Type&& value);
+
+    void PopBack() noexcept;
+    [[nodiscard]] bool IsEmpty() const noexcept;
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args);
+
+    /// Синхронно записывает изменённые страницы и заголовок на диск (msync)
+    void Flush();
+
+    [[nodiscard]] bool IsReadOnly() const noexcept;
+
+private:
+    /// Заголовок файла; элементы начинаются сразу за ним
+    struct alignas(64) Header {
+        char magic[8];
+        uint64_t element_size;
+        uint64_t size;
+    };
+
+    static_assert(alignof(T) <= alignof(Header), "element alignment exceeds the file header alignment");
+
+    static constexpr char MAGIC[8] = {'V', 'E', 'C', 'T', 'O', 'R', 'M', '1'};
+
+    int fd_ = -1;
+    /// отображение всего файла: заголовок и capacity_ элементов
+    void* mapping_ = nullptr;
+    size_t capacity_ = 0;
+    bool read_only_ = false;
+
+    [[nodiscard]] Header* GetHeader() const noexcept;
+    [[nodiscard]] T* Data() const noexcept;
+
+    static size_t FileSize(size_t capacity) noexcept;
+
+    /// вместимость для required элементов при росте по политике Growth
+    [[nodiscard]] size_t NextCapacity(size_t required) const noexcept;
+
+    /// меняет размер файла и отображения под new_capacity элементов
+    void Remap(size_t new_capacity);
+
+    /// освобождает отображение и дескриптор
+    void Close() noexcept;
+
+    [[noreturn]] static void ThrowSystemError(const std::string& what);
+
+}; // class MappedVector
+
+template<typename T, typename Growth>
+MappedVector<T, Growth>::MappedVector(const std::string& path, MappedMode mode)
+        : read_only_(mode == MappedMode::READ_ONLY)  //
+{
+    int flags = read_only_ ? O_RDONLY : O_RDWR | O_CREAT;
+    if (mode == MappedMode::CREATE) {
+        flags |= O_TRUNC;
+    }
+    fd_ = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        ThrowSystemError("open " + path);
+    }
+    try {
+        struct stat st{};
+        if (::fstat(fd_, &st) != 0) {
+            ThrowSystemError("fstat " + path);
+        }
+        auto file_size = static_cast<size_t>(st.st_size);
+        const bool is_new = file_size == 0 && !read_only_;
+        if (is_new && ::ftruncate(fd_, static_cast<off_t>(FileSize(0))) != 0) {
+            ThrowSystemError("ftruncate " + path);
+        }
+        if (is_new) {
+            file_size = FileSize(0);
+        }
+        if (file_size < sizeof(Header)) {
+            throw std::runtime_error("MappedVector: " + path + " is too small to contain a header");
+        }
+        const int prot = read_only_ ? PROT_READ : PROT_READ | PROT_WRITE;
+        mapping_ = ::mmap(nullptr, file_size, prot, MAP_SHARED, fd_, 0);
+        if (mapping_ == MAP_FAILED) {
+            mapping_ = nullptr;
+            ThrowSystemError("mmap " + path);
+        }
+        capacity_ = (file_size - sizeof(Header)) / sizeof(T);
+        Header* header = GetHeader();
+        if (is_new) {
+            std::memcpy(header->magic, MAGIC, sizeof(MAGIC));
+            header->element_size = sizeof(T);
+            header->size = 0;
+        } else if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->element_size != sizeof(T)
+                   || header->size > capacity_) {
+            throw std::runtime_error("MappedVector: " + path + " does not contain a vector of this element type");
+        }
+        if (read_only_) {
+            // отображение остаётся действительным и после закрытия дескриптора
+            ::close(fd_);
+            fd_ = -1;
+        }
+    } catch (...) {
+        Close();
+        throw;
+    }
+}
+
+template<typename T, typename Growth>
+MappedVector<T, Growth>::MappedVector(MappedVector&& other) noexcept
+        : fd_(std::exchange(other.fd_, -1))
+        , mapping_(std::exchange(other.mapping_, nullptr))
+        , capacity_(std::exchange(other.capacity_, 0))
+        , read_only_(other.read_only_)  //
+{
+}
+
+template<typename T, typename Growth>
+MappedVector<T, Growth>& MappedVector<T, Growth>::operator=(MappedVector&& rhs) noexcept {
+    if (this != &rhs) {
+        Close();
+        fd_ = std::exchange(rhs.fd_, -1);
+        mapping_ = std::exchange(rhs.mapping_, nullptr);
+        capacity_ = std::exchange(rhs.capacity_, 0);
+        read_only_ = rhs.read_only_;
+    }
+    return *this;
+}
+
+template<typename T, typename Growth>
+MappedVector<T, Growth>::~MappedVector() {
+    Close();
+}
+
+template<typename T, typename Growth>
+typename MappedVector<T, Growth>::iterator MappedVector<T, Growth>::begin() noexcept {
+    return Data();
+}
+
+template<typename T, typename Growth>
+typename MappedVector<T, Growth>::iterator MappedVector<T, Growth>::end() noexcept {
+    return Data() + Size();
+}
+
+template<typename T, typename Growth>
+typename MappedVector<T, Growth>::const_iterator MappedVector<T, Growth>::begin() const noexcept {
+    return Data();
+}
+
+template<typename T, typename Growth>
+typename MappedVector<T, Growth>::const_iterator MappedVector<T, Growth>::end() const noexcept {
+    return Data() + Size();
+}
+
+template<typename T, typename Growth>
+typename MappedVector<T, Growth>::const_iterator MappedVector<T, Growth>::cbegin() const noexcept {
+    return begin();
+}
+
+template<typename T, typename Growth>
+typename MappedVector<T, Growth>::const_iterator MappedVector<T, Growth>::cend() const noexcept {
+    return end();
+}
+
+template<typename T, typename Growth>
+template<typename... Args>
+typename MappedVector<T, Growth>::iterator MappedVector<T, Growth>::Emplace(const_iterator pos, Args&&... args) {
+    assert(!read_only_);
+    const size_t index = pos - begin();
+    assert(index <= Size());
+    /// аргументы могут ссылаться на элементы вектора, а Remap может перенести отображение
+    T value(std::forward<Args>(args)...);
+    const size_t size = Size();
+    if (size == capacity_) {
+        Remap(NextCapacity(size + 1));
+    }
+    T* data = Data();
+    std::memmove(static_cast<void*>(data + index + 1), static_cast<const void*>(data + index), (size - index) * sizeof(T));
+    std::memcpy(static_cast<void*>(data + index), static_cast<const void*>(&value), sizeof(T));
+    GetHeader()->size = size + 1;
+    return data + index;
+}
+
+template<typename T, typename Growth>
+typename MappedVector<T, Growth>::iterator MappedVector<T, Growth>::Erase(const_iterator pos) noexcept {
+    return Erase(pos, pos + 1);
+}
+
+template<typename T, typename Growth>
+typename MappedVector<T, Growth>::iterator MappedVector<T, Growth>::Erase(const_iterator first,
+                                                                          const_iterator last) noexcept {
+    assert(!read_only_);
+    assert(begin() <= first && first <= last && last <= end());
+    const size_t index = first - begin();
+    const size_t count = last - first;
+    T* data = Data();
+    std::memmove(static_cast<void*>(data + index), static_cast<const void*>(data + index + count),
+                 (Size() - index - count) * sizeof(T));
+    GetHeader()->size = Size() - count;
+    return data + index;
+}
+
+template<typename T, typename Growth>
+typename MappedVector<T, Growth>::iterator MappedVector<T, Growth>::Insert(const_iterator pos, const T& value) {
+    return Emplace(pos, value);
+}
+
+template<typename T, typename Growth>
+size_t MappedVector<T, Growth>::Size() const noexcept {
+    // заголовок меняют и другие процессы: писатель, выросший за пределы нашего отображения,
+    // не должен уводить чтение за его конец
+    return mapping_ != nullptr ? std::min<size_t>(GetHeader()->size, capacity_) : 0;
+}
+
+template<typename T, typename Growth>
+size_t MappedVector<T, Growth>::Capacity() const noexcept {
+    return capacity_;
+}
+
+template<typename T, typename Growth>
+const T& MappedVector<T, Growth>::operator[](size_t index) const noexcept {
+    return const_cast<MappedVector&>(*this)[index];
+}
+
+template<typename T, typename Growth>
+T& MappedVector<T, Growth>::operator[](size_t index) noexcept {
+    assert(index < Size());
+    return Data()[index];
+}
+
+template<typename T, typename Growth>
+void MappedVector<T, Growth>::Reserve(size_t new_capacity) {
+    assert(!read_only_);
+    if (new_capacity <= capacity_) {
+        return;
+    }
+    Remap(Growth::Fit(new_capacity, sizeof(T)));
+}
+
+template<typename T, typename Growth>
+void MappedVector<T, Growth>::ShrinkToFit() {
+    assert(!read_only_);
+    if (Size() < capacity_) {
+        Remap(Size());
+    }
+}
+
+template<typename T, typename Growth>
+void MappedVector<T, Growth>::Swap(MappedVector& other) noexcept {
+    std::swap(fd_, other.fd_);
+    std::swap(mapping_, other.mapping_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(read_only_, other.read_only_);
+}
+
+template<typename T, typename Growth>
+void MappedVector<T, Growth>::Resize(size_t new_size) {
+    assert(!read_only_);
+    const size_t size = Size();
+    if (new_size > size) {
+        Reserve(new_size);
+        // хвост файла после ftruncate уже нулевой, но он мог остаться от удалённых элементов
+        std::memset(static_cast<void*>(Data() + size), 0, (new_size - size) * sizeof(T));
+    }
+    GetHeader()->size = new_size;
+}
+
+template<typename T, typename Growth>
+template<typename Type>
+void MappedVector<T, Growth>::PushBack(Type&& value) {
+    EmplaceBack(std::forward<Type>(value));
+}
+
+template<typename T, typename Growth>
+void MappedVector<T, Growth>::PopBack() noexcept {
+    assert(!read_only_);
+    assert(!IsEmpty());
+    --GetHeader()->size;
+}
+
+template<typename T, typename Growth>
+bool MappedVector<T, Growth>::IsEmpty() const noexcept {
+    return Size() == 0;
+}
+
+template<typename T, typename Growth>
+template<typename... Args>
+T& MappedVector<T, Growth>::EmplaceBack(Args&&... args) {
+    return *Emplace(cend(), std::forward<Args>(args)...);
+}
+
+template<typename T, typename Growth>
+void MappedVector<T, Growth>::Flush() {
+    if (mapping_ != nullptr && !read_only_ && ::msync(mapping_, FileSize(capacity_), MS_SYNC) != 0) {
+        ThrowSystemError("msync");
+    }
+}
+
+template<typename T, typename Growth>
+bool MappedVector<T, Growth>::IsReadOnly() const noexcept {
+    return read_only_;
+}
+
+template<typename T, typename Growth>
+typename MappedVector<T, Growth>::Header* MappedVector<T, Growth>::GetHeader() const noexcept {
+    assert(mapping_ != nullptr);
+    return static_cast<Header*>(mapping_);
+}
+
+template<typename T, typename Growth>
+T* MappedVector<T, Growth>::Data() const noexcept {
+    if (mapping_ == nullptr) {
+        return nullptr;
+    }
+    return reinterpret_cast<T*>(static_cast<std::byte*>(mapping_) + sizeof(Header));
+}
+
+template<typename T, typename Growth>
+size_t MappedVector<T, Growth>::FileSize(size_t capacity) noexcept {
+    return sizeof(Header) + capacity * sizeof(T);
+}
+
+template<typename T, typename Growth>
+size_t MappedVector<T, Growth>::NextCapacity(size_t required) const noexcept {
+    return Growth::Grow(capacity_, required, sizeof(T));
+}
+
+template<typename T, typename Growth>
+void MappedVector<T, Growth>::Remap(size_t new_capacity) {
+    assert(!read_only_ && mapping_ != nullptr);
+    assert(new_capacity >= Size());
+    if (new_capacity > (SIZE_MAX - sizeof(Header)) / sizeof(T)) {
+        throw std::length_error("MappedVector: capacity is too large");
+    }
+    const size_t old_size = FileSize(capacity_);
+    const size_t new_size = FileSize(new_capacity);
+    // при росте файл увеличивается до отображения, чтобы страницы за старым концом существовали;
+    // при сжатии — уменьшается после, чтобы не оставить в отображении страницы за концом файла
+    if (new_size > old_size && ::ftruncate(fd_, static_cast<off_t>(new_size)) != 0) {
+        ThrowSystemError("ftruncate");
+    }
+    void* moved = ::mremap(mapping_, old_size, new_size, MREMAP_MAYMOVE);
+    if (moved == MAP_FAILED) {
+        const int error = errno;
+        if (new_size > old_size) {
+            // возвращаем файлу прежний размер, вектор остаётся нетронутым
+            [[maybe_unused]] const int rc = ::ftruncate(fd_, static_cast<off_t>(old_size));
+        }
+        errno = error;
+        ThrowSystemError("mremap");
+    }
+    mapping_ = moved;
+    capacity_ = new_capacity;
+    if (new_size < old_size && ::ftruncate(fd_, static_cast<off_t>(new_size)) != 0) {
+        ThrowSystemError("ftruncate");
+    }
+}
+
+template<typename T, typename Growth>
+void MappedVector<T, Growth>::Close() noexcept {
+    if (mapping_ != nullptr) {
+        ::munmap(mapping_, FileSize(capacity_));
+        mapping_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    capacity_ = 0;
+}
+
+template<typename T, typename Growth>
+void MappedVector<T, Growth>::ThrowSystemError(const std::string& what) {
+    throw std::system_error(errno, std::generic_category(), "MappedVector: " + what);
+}
@@ -0,0 +1,870 @@
+#pragma once
+#include "simd.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+/// Компактные массивы целых: PackedIntVector хранит беззнаковые значения по Width() бит
+/// подряд, BitVector — биты с подсчётом, рангом и выбором. Оба лежат в Vector<uint64_t>,
+/// биты заполняют слова начиная с младших
+
+namespace packed_detail {
+
+inline constexpr size_t WORD_BITS = 64;
+
+/// маска младших width бит
+inline constexpr uint64_t LowMask(unsigned width) noexcept {
+    return width == WORD_BITS ? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+}
+
+/// Распаковывает count значений шириной width <= 32, начиная со значения first
+inline void UnpackScalar(const uint64_t* words, size_t first, size_t count, unsigned width, uint32_t* out) noexcept {
+    const uint64_t mask = LowMask(width);
+    for (size_t i = 0; i != count; ++i) {
+        const size_t pos = (first + i) * width;
+        const size_t offset = pos % WORD_BITS;
+        const uint64_t high = (words[pos / WORD_BITS + 1] << 1) << (WORD_BITS - 1 - offset);
+        out[i] = static_cast<uint32_t>(((words[pos / WORD_BITS] >> offset) | high) & mask);
+    }
+}
+
+inline size_t PopcountScalar(const uint64_t* words, size_t n) noexcept {
+    size_t count = 0;
+    for (size_t i = 0; i != n; ++i) {
+        count += static_cast<size_t>(std::popcount(words[i]));
+    }
+    return count;
+}
+
+#if defined(VECTOR_SIMD_EXTENSIONS)
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+/// Векторный вариант UnpackScalar для little-endian. Значение шириной до 32 бит целиком
+/// помещается в 8 байт, начинающихся с байта его первого бита, поэтому каждая дорожка
+/// читается одной невыровненной загрузкой, а сдвиги на разное число бит и маска
+/// применяются ко всем дорожкам сразу. За данными должно быть 8 байт запаса
+template <size_t Bytes>
+[[gnu::always_inline]] inline void UnpackImpl(const uint64_t* words, size_t first, size_t count, unsigned width,
+                                              uint32_t* out) noexcept {
+    using Words = simd_detail::Vec<uint64_t, Bytes>;
+    using Values = simd_detail::Vec<uint32_t, Bytes / 2>;
+    constexpr size_t LANES = Bytes / sizeof(uint64_t);
+    const auto* bytes = reinterpret_cast<const unsigned char*>(words);
+    const Words mask = simd_detail::Splat<uint64_t, Bytes>(LowMask(width));
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        Words loaded;
+        Words shifts;
+        for (size_t lane = 0; lane != LANES; ++lane) {
+            const size_t pos = (first + i + lane) * width;
+            uint64_t word;
+            std::memcpy(&word, bytes + pos / 8, sizeof(word));
+            loaded[lane] = word;
+            shifts[lane] = pos % 8;
+        }
+        const Values values = __builtin_convertvector((loaded >> shifts) & mask, Values);
+        std::memcpy(out + i, &values, sizeof(values));
+    }
+    UnpackScalar(words, first + i, count - i, width, out + i);
+}
+
+#if defined(__x86_64__)
+[[gnu::target("avx512f")]] inline void UnpackAvx512(const uint64_t* words, size_t first, size_t count,
+                                                    unsigned width, uint32_t* out) noexcept {
+    UnpackImpl<64>(words, first, count, width, out);
+}
+
+[[gnu::target("avx2")]] inline void UnpackAvx2(const uint64_t* words, size_t first, size_t count,
+                                               unsigned width, uint32_t* out) noexcept {
+    UnpackImpl<32>(words, first, count, width, out);
+}
+
+/// Цикл с std::popcount компилятор векторизует инструкцией vpopcntq
+[[gnu::target("avx512f,avx512vpopcntdq")]] inline size_t PopcountAvx512(const uint64_t* words, size_t n) noexcept {
+    return PopcountScalar(words, n);
+}
+
+/// без AVX-512 выгоднее всего скалярная инструкция popcnt
+[[gnu::target("popcnt")]] inline size_t PopcountNative(const uint64_t* words, size_t n) noexcept {
+    return PopcountScalar(words, n);
+}
+
+inline bool HasVectorPopcount() noexcept {
+    static const bool supported = __builtin_cpu_supports("avx512vpopcntdq");
+    return supported;
+}
+#endif
+
+#pragma GCC diagnostic pop
+
+#endif
+
+inline void Unpack(const uint64_t* words, size_t first, size_t count, unsigned width, uint32_t* out) noexcept {
+#if defined(VECTOR_SIMD_EXTENSIONS)
+    if constexpr (std::endian::native == std::endian::little) {
+        switch (simd_detail::Level().load(std::memory_order_relaxed)) {
+#if defined(__x86_64__)
+            case simd::SimdLevel::AVX512:
+                return UnpackAvx512(words, first, count, width, out);
+            case simd::SimdLevel::AVX2:
+                return UnpackAvx2(words, first, count, width, out);
+#else
+            case simd::SimdLevel::AVX512:
+            case simd::SimdLevel::AVX2:
+#endif
+            case simd::SimdLevel::VECTOR_128:
+                return UnpackImpl<16>(words, first, count, width, out);
+            case simd::SimdLevel::SCALAR:
+                break;
+        }
+    }
+#endif
+    UnpackScalar(words, first, count, width, out);
+}
+
+inline size_t Popcount(const uint64_t* words, size_t n) noexcept {
+#if defined(VECTOR_SIMD_EXTENSIONS) && defined(__x86_64__)
+    const simd::SimdLevel level = simd_detail::Level().load(std::memory_order_relaxed);
+    if (level == simd::SimdLevel::AVX512 && HasVectorPopcount()) {
+        return PopcountAvx512(words, n);
+    }
+    if (level != simd::SimdLevel::SCALAR && __builtin_cpu_supports("popcnt")) {
+        return PopcountNative(words, n);
+    }
+#endif
+    return PopcountScalar(words, n);
+}
+
+}  // namespace packed_detail
+
+/// Массив беззнаковых целых по Width() бит на значение (от 1 до 64).
+/// Ширина задаётся при создании и автоматически увеличивается, если PushBack или Set
+/// получают значение, которое в неё не помещается: массив перепаковывается за O(n),
+/// а так как ширина только растёт, таких перепаковок не больше 64.
+/// За данными всегда лежит одно нулевое слово, чтобы значение, пересекающее
+/// границу слов, и пакетная распаковка читались без проверок на конец буфера.
+/// Исключение — пустой массив, из которого переместили данные: слов у него нет вовсе
+template <typename Alloc = std::allocator<uint64_t>, typename Growth = DoublingGrowth>
+class PackedIntVector {
+public:
+    class Iterator;
+
+    using value_type = uint64_t;
+    using iterator = Iterator;
+    using const_iterator = Iterator;
+
+    /// Изменяемая ссылка на значение: присваивание вызывает Set
+    class Reference {
+    public:
+        Reference& operator=(uint64_t value) {
+            owner_->Set(index_, value);
+            return *this;
+        }
+
+        Reference& operator=(const Reference& other) {
+            return *this = static_cast<uint64_t>(other);
+        }
+
+        operator uint64_t() const noexcept {
+            return owner_->Get(index_);
+        }
+
+    private:
+        friend class PackedIntVector;
+
+        Reference(PackedIntVector* owner, size_t index) noexcept
+                : owner_(owner)
+                , index_(index)  //
+        {
+        }
+
+        PackedIntVector* owner_;
+        size_t index_;
+    };
+
+    /// Создаёт пустой массив значений шириной width бит
+    explicit PackedIntVector(unsigned width = 1, const Alloc& alloc = Alloc());
+
+    /// Создаёт size нулевых значений шириной width бит
+    PackedIntVector(size_t size, unsigned width, const Alloc& alloc = Alloc());
+
+    PackedIntVector(const PackedIntVector& other) = default;
+    PackedIntVector& operator=(const PackedIntVector& rhs) = default;
+    /// Перемещённый массив остаётся пустым с прежней шириной
+    PackedIntVector(PackedIntVector&& other) noexcept;
+    PackedIntVector& operator=(PackedIntVector&& rhs) noexcept;
+
+    /// Упаковывает значения с наименьшей шириной, в которую помещается наибольшее из них
+    template <std::ranges::contiguous_range Range>
+        requires std::unsigned_integral<std::ranges::range_value_t<Range>>
+    static PackedIntVector Pack(const Range& values, const Alloc& alloc = Alloc());
+
+    Iterator begin() const noexcept;
+    Iterator end() const noexcept;
+    Iterator cbegin() const noexcept;
+    Iterator cend() const noexcept;
+
+    [[nodiscard]] size_t Size() const noexcept;
+    [[nodiscard]] bool IsEmpty() const noexcept;
+    /// количество значений, которое поместится без выделения памяти при текущей ширине
+    [[nodiscard]] size_t Capacity() const noexcept;
+    [[nodiscard]] unsigned Width() const noexcept;
+    /// объём занятой памяти в байтах
+    [[nodiscard]] size_t MemoryUsage() const noexcept;
+
+    [[nodiscard]] uint64_t Get(size_t index) const noexcept;
+    /// Записывает value; если оно шире Width(), сначала расширяет массив
+    void Set(size_t index, uint64_t value);
+
+    uint64_t operator[](size_t index) const noexcept;
+    Reference operator[](size_t index) noexcept;
+
+    void PushBack(uint64_t value);
+    void PopBack() noexcept;
+    /// Новые значения равны нулю
+    void Resize(size_t new_size);
+    void Reserve(size_t new_capacity);
+    void Clear() noexcept;
+
+    /// Перепаковывает массив с шириной width. Если какое-либо значение в неё не помещается,
+    /// выбрасывает std::invalid_argument и оставляет массив прежним
+    void Repack(unsigned width);
+
+    /// Распаковывает count значений, начиная с first, в out
+    void Unpack(size_t first, size_t count, uint32_t* out) const;
+
+    /// Дописывает все значения в конец out. Если Width() больше 32, значения могут не поместиться
+    /// в uint32_t, и выбрасывается std::overflow_error
+    template <typename OutAlloc, typename OutGrowth>
+    void UnpackTo(Vector<uint32_t, OutAlloc, OutGrowth>& out) const;
+
+    void Swap(PackedIntVector& other) noexcept;
+
+private:
+    Vector<uint64_t, Alloc, Growth> words_;
+    size_t size_ = 0;
+    unsigned width_ = 1;
+    uint64_t mask_ = 1;
+
+    /// количество слов под size значений шириной width вместе с нулевым словом в конце
+    static size_t WordsFor(size_t size, unsigned width) noexcept;
+
+    static void CheckWidth(unsigned width);
+
+    /// записывает value в ячейку index, предполагая, что ячейка обнулена или будет перезаписана целиком
+    void Store(size_t index, uint64_t value) noexcept;
+};
+
+/// Итератор произвольного доступа по значениям; разыменование возвращает значение
+template <typename Alloc, typename Growth>
+class PackedIntVector<Alloc, Growth>::Iterator {
+public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = uint64_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = uint64_t;
+
+    Iterator() = default;
+
+    Iterator(const PackedIntVector* owner, size_t index) noexcept
+            : owner_(owner)
+            , index_(index)  //
+    {
+    }
+
+    reference operator*() const noexcept {
+        return owner_->Get(index_);
+    }
+
+    reference operator[](difference_type n) const noexcept {
+        return *(*this + n);
+    }
+
+    [[nodiscard]] size_t Index() const noexcept {
+        return index_;
+    }
+
+    Iterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+
+    Iterator operator++(int) noexcept {
+        Iterator copy = *this;
+        ++index_;
+        return copy;
+    }
+
+    Iterator& operator--() noexcept {
+        --index_;
+        return *this;
+    }
+
+    Iterator operator--(int) noexcept {
+        Iterator copy = *this;
+        --index_;
+        return copy;
+    }
+
+    Iterator& operator+=(difference_type n) noexcept {
+        index_ += n;
+        return *this;
+    }
+
+    Iterator& operator-=(difference_type n) noexcept {
+        index_ -= n;
+        return *this;
+    }
+
+    friend Iterator operator+(Iterator it, difference_type n) noexcept {
+        return it += n;
+    }
+
+    friend Iterator operator+(difference_type n, Iterator it) noexcept {
+        return it += n;
+    }
+
+    friend Iterator operator-(Iterator it, difference_type n) noexcept {
+        return it -= n;
+    }
+
+    friend difference_type operator-(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+    }
+
+    friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return lhs.index_ == rhs.index_;
+    }
+
+    friend auto operator<=>(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return lhs.index_ <=> rhs.index_;
+    }
+
+private:
+    const PackedIntVector* owner_ = nullptr;
+    size_t index_ = 0;
+};
+
+/// Массив битов. Count считает единицы векторной инструкцией popcount, где она есть.
+/// Rank и Select используют индекс с числом единиц перед каждым блоком из 512 бит;
+/// индекс строит BuildIndex, и после любого изменения его нужно построить заново.
+/// Биты последнего слова за Size() всегда нулевые
+template <typename Alloc = std::allocator<uint64_t>, typename Growth = DoublingGrowth>
+class BitVector {
+public:
+    /// слов в блоке индекса Rank/Select
+    static constexpr size_t BLOCK_WORDS = 8;
+
+    explicit BitVector(const Alloc& alloc = Alloc());
+    BitVector(size_t size, bool value, const Alloc& alloc = Alloc());
+
+    BitVector(const BitVector& other) = default;
+    BitVector& operator=(const BitVector& rhs) = default;
+    /// Перемещённый массив остаётся пустым и без индекса
+    BitVector(BitVector&& other) noexcept;
+    BitVector& operator=(BitVector&& rhs) noexcept;
+
+    [[nodiscard]] size_t Size() const noexcept;
+    [[nodiscard]] bool IsEmpty() const noexcept;
+
+    [[nodiscard]] bool Get(size_t index) const noexcept;
+    void Set(size_t index, bool value) noexcept;
+    bool operator[](size_t index) const noexcept;
+
+    void PushBack(bool value);
+    void PopBack() noexcept;
+    void Resize(size_t new_size, bool value = false);
+    void Reserve(size_t new_capacity);
+    void Clear() noexcept;
+
+    /// слова с битами; биты за Size() нулевые
+    [[nodiscard]] std::span<const uint64_t> Words() const noexcept;
+
+    /// количество единиц
+    [[nodiscard]] size_t Count() const noexcept;
+
+    /// Строит индекс для Rank и Select за один проход
+    void BuildIndex();
+    [[nodiscard]] bool HasIndex() const noexcept;
+
+    /// количество единиц среди первых index битов (index <= Size())
+    [[nodiscard]] size_t Rank(size_t index) const noexcept;
+    /// позиция единицы с номером k, считая с нуля, или Size(), если единиц не больше k
+    [[nodiscard]] size_t Select(size_t k) const noexcept;
+
+    void Swap(BitVector& other) noexcept;
+
+private:
+    Vector<uint64_t, Alloc, Growth> words_;
+    /// ranks_[b] — количество единиц перед блоком b; последний элемент — общее количество
+    Vector<uint64_t, Alloc> ranks_;
+    size_t size_ = 0;
+    bool indexed_ = false;
+};
+
+template<typename Alloc, typename Growth>
+PackedIntVector<Alloc, Growth>::PackedIntVector(unsigned width, const Alloc& alloc)
+        : words_(1, alloc)
+        , width_(width)
+        , mask_(packed_detail::LowMask(width))  //
+{
+    CheckWidth(width);
+}
+
+template<typename Alloc, typename Growth>
+PackedIntVector<Alloc, Growth>::PackedIntVector(size_t size, unsigned width, const Alloc& alloc)
+        : words_((CheckWidth(width), WordsFor(size, width)), alloc)
+        , size_(size)
+        , width_(width)
+        , mask_(packed_detail::LowMask(width))  //
+{
+}
+
+template<typename Alloc, typename Growth>
+PackedIntVector<Alloc, Growth>::PackedIntVector(PackedIntVector&& other) noexcept
+        : words_(std::move(other.words_))
+        , size_(std::exchange(other.size_, 0))
+        , width_(other.width_)
+        , mask_(other.mask_)  //
+{
+}
+
+template<typename Alloc, typename Growth>
+PackedIntVector<Alloc, Growth>& PackedIntVector<Alloc, Growth>::operator=(PackedIntVector&& rhs) noexcept {
+    if (this != &rhs) {
+        PackedIntVector moved(std::move(rhs));
+        Swap(moved);
+    }
+    return *this;
+}
+
+template<typename Alloc, typename Growth>
+template <std::ranges::contiguous_range Range>
+    requires std::unsigned_integral<std::ranges::range_value_t<Range>>
+PackedIntVector<Alloc, Growth> PackedIntVector<Alloc, Growth>::Pack(const Range& values, const Alloc& alloc) {
+    const size_t n = std::ranges::size(values);
+    unsigned width = 1;
+    if (n != 0) {
+        width = std::max(1U, static_cast<unsigned>(std::bit_width(static_cast<uint64_t>(simd::MinMax(values).second))));
+    }
+    PackedIntVector result(n, width, alloc);
+    const auto* data = std::ranges::data(values);
+    for (size_t i = 0; i != n; ++i) {
+        result.Store(i, data[i]);
+    }
+    return result;
+}
+
+template<typename Alloc, typename Growth>
+typename PackedIntVector<Alloc, Growth>::Iterator PackedIntVector<Alloc, Growth>::begin() const noexcept {
+    return {this, 0};
+}
+
+template<typename Alloc, typename Growth>
+typename PackedIntVector<Alloc, Growth>::Iterator PackedIntVector<Alloc, Growth>::end() const noexcept {
+    return {this, size_};
+}
+
+template<typename Alloc, typename Growth>
+typename PackedIntVector<Alloc, Growth>::Iterator PackedIntVector<Alloc, Growth>::cbegin() const noexcept {
+    return begin();
+}
+
+template<typename Alloc, typename Growth>
+typename PackedIntVector<Alloc, Growth>::Iterator PackedIntVector<Alloc, Growth>::cend() const noexcept {
+    return end();
+}
+
+template<typename Alloc, typename Growth>
+size_t PackedIntVector<Alloc, Growth>::Size() const noexcept {
+    return size_;
+}
+
+template<typename Alloc, typename Growth>
+bool PackedIntVector<Alloc, Growth>::IsEmpty() const noexcept {
+    return size_ == 0;
+}
+
+template<typename Alloc, typename Growth>
+size_t PackedIntVector<Alloc, Growth>::Capacity() const noexcept {
+    return words_.Capacity() == 0 ? 0 : (words_.Capacity() - 1) * packed_detail::WORD_BITS / width_;
+}
+
+template<typename Alloc, typename Growth>
+unsigned PackedIntVector<Alloc, Growth>::Width() const noexcept {
+    return width_;
+}
+
+template<typename Alloc, typename Growth>
+size_t PackedIntVector<Alloc, Growth>::MemoryUsage() const noexcept {
+    return words_.Capacity() * sizeof(uint64_t);
+}
+
+template<typename Alloc, typename Growth>
+uint64_t PackedIntVector<Alloc, Growth>::Get(size_t index) const noexcept {
+    assert(index < size_);
+    const size_t pos = index * width_;
+    const size_t word = pos / packed_detail::WORD_BITS;
+    const size_t offset = pos % packed_detail::WORD_BITS;
+    // сдвиг в два шага даёт ноль при offset == 0 вместо неопределённого сдвига на 64
+    const uint64_t high = (words_[word + 1] << 1) << (packed_detail::WORD_BITS - 1 - offset);
+    return ((words_[word] >> offset) | high) & mask_;
+}
+
+template<typename Alloc, typename Growth>
+void PackedIntVector<Alloc, Growth>::Set(size_t index, uint64_t value) {
+    assert(index < size_);
+    if ((value & ~mask_) != 0) {
+        Repack(static_cast<unsigned>(std::bit_width(value)));
+    }
+    Store(index, value);
+}
+
+template<typename Alloc, typename Growth>
+uint64_t PackedIntVector<Alloc, Growth>::operator[](size_t index) const noexcept {
+    return Get(index);
+}
+
+template<typename Alloc, typename Growth>
+typename PackedIntVector<Alloc, Growth>::Reference PackedIntVector<Alloc, Growth>::operator[](size_t index) noexcept {
+    assert(index < size_);
+    return {this, index};
+}
+
+template<typename Alloc, typename Growth>
+void PackedIntVector<Alloc, Growth>::PushBack(uint64_t value) {
+    if ((value & ~mask_) != 0) {
+        Repack(static_cast<unsigned>(std::bit_width(value)));
+    }
+    // значение добавляет не больше одного слова, кроме первого значения перемещённого массива,
+    // которому нужно и нулевое слово
+    const size_t words = WordsFor(size_ + 1, width_);
+    while (words > words_.Size()) {
+        words_.PushBack(0);
+    }
+    ++size_;
+    Store(size_ - 1, value);
+}
+
+template<typename Alloc, typename Growth>
+void PackedIntVector<Alloc, Growth>::PopBack() noexcept {
+    assert(size_ != 0);
+    Store(size_ - 1, 0);
+    --size_;
+}
+
+template<typename Alloc, typename Growth>
+void PackedIntVector<Alloc, Growth>::Resize(size_t new_size) {
+    if (new_size < size_) {
+        // освободившиеся биты обнуляются, чтобы новые значения снова были нулевыми
+        for (size_t i = new_size; i != size_; ++i) {
+            Store(i, 0);
+        }
+    }
+    words_.Resize(WordsFor(new_size, width_));
+    size_ = new_size;
+}
+
+template<typename Alloc, typename Growth>
+void PackedIntVector<Alloc, Growth>::Reserve(size_t new_capacity) {
+    words_.Reserve(WordsFor(new_capacity, width_));
+}
+
+template<typename Alloc, typename Growth>
+void PackedIntVector<Alloc, Growth>::Clear() noexcept {
+    // у перемещённого массива слов нет, и выделять нулевое слово здесь нельзя
+    if (!words_.IsEmpty()) {
+        words_.Resize(1);
+        words_[0] = 0;
+    }
+    size_ = 0;
+}
+
+template<typename Alloc, typename Growth>
+void PackedIntVector<Alloc, Growth>::Repack(unsigned width) {
+    CheckWidth(width);
+    if (width == width_) {
+        return;
+    }
+    const uint64_t mask = packed_detail::LowMask(width);
+    for (size_t i = 0; i != size_; ++i) {
+        if ((Get(i) & ~mask) != 0) {
+            throw std::invalid_argument("value does not fit into the requested width");
+        }
+    }
+    PackedIntVector repacked(size_, width, words_.GetAllocator());
+    repacked.words_.Reserve(std::max(WordsFor(size_, width), words_.Capacity() * width / width_));
+    for (size_t i = 0; i != size_; ++i) {
+        repacked.Store(i, Get(i));
+    }
+    Swap(repacked);
+}
+
+template<typename Alloc, typename Growth>
+void PackedIntVector<Alloc, Growth>::Unpack(size_t first, size_t count, uint32_t* out) const {
+    assert(first + count <= size_);
+    if (width_ > 32) {
+        throw std::overflow_error("packed values are wider than 32 bits");
+    }
+    packed_detail::Unpack(words_.begin(), first, count, width_, out);
+}
+
+template<typename Alloc, typename Growth>
+template <typename OutAlloc, typename OutGrowth>
+void PackedIntVector<Alloc, Growth>::UnpackTo(Vector<uint32_t, OutAlloc, OutGrowth>& out) const {
+    const size_t old_size = out.Size();
+    out.ResizeForOverwrite(old_size + size_);
+    try {
+        Unpack(0, size_, out.begin() + old_size);
+    } catch (...) {
+        out.Resize(old_size);
+        throw;
+    }
+}
+
+template<typename Alloc, typename Growth>
+void PackedIntVector<Alloc, Growth>::Swap(PackedIntVector& other) noexcept {
+    words_.Swap(other.words_);
+    std::swap(size_, other.size_);
+    std::swap(width_, other.width_);
+    std::swap(mask_, other.mask_);
+}
+
+template<typename Alloc, typename Growth>
+size_t PackedIntVector<Alloc, Growth>::WordsFor(size_t size, unsigned width) noexcept {
+    return (size * width + packed_detail::WORD_BITS - 1) / packed_detail::WORD_BITS + 1;
+}
+
+template<typename Alloc, typename Growth>
+void PackedIntVector<Alloc, Growth>::CheckWidth(unsigned width) {
+    if (width == 0 || width > packed_detail::WORD_BITS) {
+        throw std::invalid_argument("width must be between 1 and 64 bits");
+    }
+}
+
+template<typename Alloc, typename Growth>
+void PackedIntVector<Alloc, Growth>::Store(size_t index, uint64_t value) noexcept {
+    assert((value & ~mask_) == 0);
+    const size_t pos = index * width_;
+    const size_t word = pos / packed_detail::WORD_BITS;
+    const size_t offset = pos % packed_detail::WORD_BITS;
+    words_[word] = (words_[word] & ~(mask_ << offset)) | (value << offset);
+    if (offset + width_ > packed_detail::WORD_BITS) {
+        const size_t shift = packed_detail::WORD_BITS - offset;
+        words_[word + 1] = (words_[word + 1] & ~(mask_ >> shift)) | (value >> shift);
+    }
+}
+
+template<typename Alloc, typename Growth>
+BitVector<Alloc, Growth>::BitVector(const Alloc& alloc)
+        : words_(alloc)
+        , ranks_(alloc)  //
+{
+}
+
+template<typename Alloc, typename Growth>
+BitVector<Alloc, Growth>::BitVector(size_t size, bool value, const Alloc& alloc)
+        : BitVector(alloc)  //
+{
+    Resize(size, value);
+}
+
+template<typename Alloc, typename Growth>
+BitVector<Alloc, Growth>::BitVector(BitVector&& other) noexcept
+        : words_(std::move(other.words_))
+        , ranks_(std::move(other.ranks_))
+        , size_(std::exchange(other.size_, 0))
+        , indexed_(std::exchange(other.indexed_, false))  //
+{
+}
+
+template<typename Alloc, typename Growth>
+BitVector<Alloc, Growth>& BitVector<Alloc, Growth>::operator=(BitVector&& rhs) noexcept {
+    if (this != &rhs) {
+        BitVector moved(std::move(rhs));
+        Swap(moved);
+    }
+    return *this;
+}
+
+template<typename Alloc, typename Growth>
+size_t BitVector<Alloc, Growth>::Size() const noexcept {
+    return size_;
+}
+
+template<typename Alloc, typename Growth>
+bool BitVector<Alloc, Growth>::IsEmpty() const noexcept {
+    return size_ == 0;
+}
+
+template<typename Alloc, typename Growth>
+bool BitVector<Alloc, Growth>::Get(size_t index) const noexcept {
+    assert(index < size_);
+    return (words_[index / packed_detail::WORD_BITS] >> (index % packed_detail::WORD_BITS)) & 1;
+}
+
+template<typename Alloc, typename Growth>
+void BitVector<Alloc, Growth>::Set(size_t index, bool value) noexcept {
+    assert(index < size_);
+    const uint64_t bit = uint64_t{1} << (index % packed_detail::WORD_BITS);
+    uint64_t& word = words_[index / packed_detail::WORD_BITS];
+    word = value ? word | bit : word & ~bit;
+    indexed_ = false;
+}
+
+template<typename Alloc, typename Growth>
+bool BitVector<Alloc, Growth>::operator[](size_t index) const noexcept {
+    return Get(index);
+}
+
+template<typename Alloc, typename Growth>
+void BitVector<Alloc, Growth>::PushBack(bool value) {
+    if (size_ % packed_detail::WORD_BITS == 0) {
+        words_.PushBack(0);
+    }
+    ++size_;
+    Set(size_ - 1, value);
+}
+
+template<typename Alloc, typename Growth>
+void BitVector<Alloc, Growth>::PopBack() noexcept {
+    assert(size_ != 0);
+    Set(size_ - 1, false);
+    --size_;
+    if (size_ % packed_detail::WORD_BITS == 0) {
+        words_.PopBack();
+    }
+}
+
+template<typename Alloc, typename Growth>
+void BitVector<Alloc, Growth>::Resize(size_t new_size, bool value) {
+    const size_t old_size = size_;
+    words_.Resize((new_size + packed_detail::WORD_BITS - 1) / packed_detail::WORD_BITS);
+    size_ = new_size;
+    indexed_ = false;
+    const size_t tail = new_size % packed_detail::WORD_BITS;
+    if (new_size <= old_size) {
+        if (tail != 0) {
+            words_[words_.Size() - 1] &= packed_detail::LowMask(static_cast<unsigned>(tail));
+        }
+        return;
+    }
+    if (value) {
+        // доводим до границы слова по битам, дальше заполняем целыми словами
+        size_t i = old_size;
+        for (; i != new_size && i % packed_detail::WORD_BITS != 0; ++i) {
+            Set(i, true);
+        }
+        // если new_size в том же слове, что и old_size, целых слов нет: fill затёр бы биты до old_size
+        if (i != new_size) {
+            std::fill(words_.begin() + i / packed_detail::WORD_BITS, words_.end(), ~uint64_t{0});
+        }
+        if (tail != 0) {
+            words_[words_.Size() - 1] &= packed_detail::LowMask(static_cast<unsigned>(tail));
+        }
+    }
+}
+
+template<typename Alloc, typename Growth>
+void BitVector<Alloc, Growth>::Reserve(size_t new_capacity) {
+    words_.Reserve((new_capacity + packed_detail::WORD_BITS - 1) / packed_detail::WORD_BITS);
+}
+
+template<typename Alloc, typename Growth>
+void BitVector<Alloc, Growth>::Clear() noexcept {
+    words_.Resize(0);
+    size_ = 0;
+    indexed_ = false;
+}
+
+template<typename Alloc, typename Growth>
+std::span<const uint64_t> BitVector<Alloc, Growth>::Words() const noexcept {
+    return {words_.begin(), words_.Size()};
+}
+
+template<typename Alloc, typename Growth>
+size_t BitVector<Alloc, Growth>::Count() const noexcept {
+    return packed_detail::Popcount(words_.begin(), words_.Size());
+}
+
+template<typename Alloc, typename Growth>
+void BitVector<Alloc, Growth>::BuildIndex() {
+    const size_t blocks = (words_.Size() + BLOCK_WORDS - 1) / BLOCK_WORDS;
+    ranks_.Resize(blocks + 1);
+    uint64_t ones = 0;
+    for (size_t b = 0; b != blocks; ++b) {
+        ranks_[b] = ones;
+        const size_t first = b * BLOCK_WORDS;
+        ones += packed_detail::PopcountScalar(words_.begin() + first, std::min(BLOCK_WORDS, words_.Size() - first));
+    }
+    ranks_[blocks] = ones;
+    indexed_ = true;
+}
+
+template<typename Alloc, typename Growth>
+bool BitVector<Alloc, Growth>::HasIndex() const noexcept {
+    return indexed_;
+}
+
+template<typename Alloc, typename Growth>
+size_t BitVector<Alloc, Growth>::Rank(size_t index) const noexcept {
+    assert(indexed_ && index <= size_);
+    const size_t word = index / packed_detail::WORD_BITS;
+    const size_t block = word / BLOCK_WORDS;
+    size_t ones = ranks_[block];
+    for (size_t w = block * BLOCK_WORDS; w != word; ++w) {
+        ones += static_cast<size_t>(std::popcount(words_[w]));
+    }
+    const size_t bits = index % packed_detail::WORD_BITS;
+    if (bits != 0) {
+        ones += static_cast<size_t>(std::popcount(words_[word] & packed_detail::LowMask(static_cast<unsigned>(bits))));
+    }
+    return ones;
+}
+
+template<typename Alloc, typename Growth>
+size_t BitVector<Alloc, Growth>::Select(size_t k) const noexcept {
+    assert(indexed_);
+    if (k >= ranks_[ranks_.Size() - 1]) {
+        return size_;
+    }
+    // последний блок, перед которым не больше k единиц
+    const size_t block = static_cast<size_t>(std::upper_bound(ranks_.begin(), ranks_.end(), k) - ranks_.begin()) - 1;
+    size_t rest = k - ranks_[block];
+    for (size_t w = block * BLOCK_WORDS;; ++w) {
+        uint64_t word = words_[w];
+        const auto ones = static_cast<size_t>(std::popcount(word));
+        if (rest < ones) {
+            for (; rest != 0; --rest) {
+                // сбрасываем младшую единицу
+                word &= word - 1;
+            }
+            return w * packed_detail::WORD_BITS + static_cast<size_t>(std::countr_zero(word));
+        }
+        rest -= ones;
+    }
+}
+
+template<typename Alloc, typename Growth>
+void BitVector<Alloc, Growth>::Swap(BitVector& other) noexcept {
+    words_.Swap(other.words_);
+    ranks_.Swap(other.ranks_);
+    std::swap(size_, other.size_);
+    std::swap(indexed_, other.indexed_);
+}
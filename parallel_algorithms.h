@@ -0,0 +1,257 @@
+#pragma once
+#include "parallel_memory.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+
+#if defined(VECTOR_WITH_TBB)
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/partitioner.h>
+#endif
+
+/// Параллельные алгоритмы над элементами Vector. С VECTOR_WITH_TBB диапазон делится
+/// на участки около 16 КиБ данных (не меньше одного элемента), которые распределяются
+/// по ядрам выбранным разделителем TBB; без TBB вызывается последовательный алгоритм std::.
+/// В отличие от массовых операций parallel_memory.h порог SetParallelThreshold
+/// здесь не действует: вызывающий сам решает, что диапазон стоит обрабатывать параллельно
+
+/// Способ распределения участков по потокам
+enum class ParallelPartitioner {
+    /// tbb::auto_partitioner: участки дробятся, пока потоки простаивают
+    AUTO,
+    /// tbb::simple_partitioner: диапазон дробится до участков размера зерна
+    SIMPLE,
+    /// tbb::static_partitioner: каждый поток получает равную долю без перераспределения,
+    /// что подходит для равномерной работы и сохраняет привязку данных к потокам
+    STATIC,
+};
+
+namespace parallel_algorithms_detail {
+
+/// Зерно разбиения в элементах
+inline size_t GrainSize(size_t elem_size) noexcept {
+    return std::max<size_t>(1, 16 * 1024 / elem_size);
+}
+
+#if defined(VECTOR_WITH_TBB)
+
+/// Вызывает body(partitioner) с разделителем TBB, соответствующим partitioner
+template <typename Body>
+decltype(auto) WithPartitioner(ParallelPartitioner partitioner, Body body) {
+    switch (partitioner) {
+        case ParallelPartitioner::SIMPLE:
+            return body(tbb::simple_partitioner());
+        case ParallelPartitioner::STATIC:
+            return body(tbb::static_partitioner());
+        case ParallelPartitioner::AUTO:
+            break;
+    }
+    return body(tbb::auto_partitioner());
+}
+
+/// Вызывает op(first, count) для участков [0, n) по grain элементов
+template <typename Op>
+void ForEachRange(size_t n, size_t grain, ParallelPartitioner partitioner, Op op) {
+    WithPartitioner(partitioner, [&](const auto& tbb_partitioner) {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, n, grain), [&op](const tbb::blocked_range<size_t>& range) {
+            op(range.begin(), range.size());
+        }, tbb_partitioner);
+    });
+}
+
+#endif
+
+/// Вызывает op для элементов [data, data + n)
+template <typename T, typename Op>
+void ForEachElement(T* data, size_t n, Op& op, ParallelPartitioner partitioner) {
+#if defined(VECTOR_WITH_TBB)
+    ForEachRange(n, GrainSize(sizeof(T)), partitioner, [data, &op](size_t first, size_t count) {
+        std::for_each(data + first, data + first + count, op);
+    });
+#else
+    static_cast<void>(partitioner);
+    std::for_each(data, data + n, op);
+#endif
+}
+
+/// Переставляет элементы [first, first + n) так, что элементы с flags[i] != 0 предшествуют
+/// остальным, и возвращает количество первых. Каждый первый элемент, оказавшийся правее
+/// границы, обменивается с сопоставленным ему вторым элементом левее границы
+template <typename T>
+size_t PartitionByFlags(T* first, size_t n, const unsigned char* flags, ParallelPartitioner partitioner) {
+    const size_t boundary = static_cast<size_t>(std::count(flags, flags + n, 1));
+#if defined(VECTOR_WITH_TBB)
+    const size_t grain = GrainSize(sizeof(T));
+    const size_t left_chunks = (boundary + grain - 1) / grain;
+    const size_t right_chunks = (n - boundary + grain - 1) / grain;
+    // offsets[c] — номер первого неуместного элемента участка c среди неуместных элементов своей половины
+    Vector<size_t> left_offsets(left_chunks + 1);
+    Vector<size_t> right_offsets(right_chunks + 1);
+    auto chunk_at = [&](size_t c) {
+        return c < left_chunks ? std::pair{c * grain, std::min(boundary, (c + 1) * grain)}
+                               : std::pair{boundary + (c - left_chunks) * grain,
+                                           std::min(n, boundary + (c - left_chunks + 1) * grain)};
+    };
+    ForEachRange(left_chunks + right_chunks, 1, partitioner, [&](size_t begin, size_t count) {
+        for (size_t c = begin; c != begin + count; ++c) {
+            const auto [lo, hi] = chunk_at(c);
+            const unsigned char misplaced = c < left_chunks ? 0 : 1;
+            const auto found = static_cast<size_t>(std::count(flags + lo, flags + hi, misplaced));
+            (c < left_chunks ? left_offsets[c + 1] : right_offsets[c - left_chunks + 1]) = found;
+        }
+    });
+    std::partial_sum(left_offsets.begin(), left_offsets.end(), left_offsets.begin());
+    std::partial_sum(right_offsets.begin(), right_offsets.end(), right_offsets.begin());
+    assert(left_offsets[left_chunks] == right_offsets[right_chunks]);
+
+    // позиции первых элементов, оказавшихся правее границы
+    Vector<size_t> positions(right_offsets[right_chunks], DefaultInitTag{});
+    ForEachRange(right_chunks, 1, partitioner, [&](size_t begin, size_t count) {
+        for (size_t c = begin; c != begin + count; ++c) {
+            const auto [lo, hi] = chunk_at(left_chunks + c);
+            size_t next = right_offsets[c];
+            for (size_t i = lo; i != hi; ++i) {
+                if (flags[i] != 0) {
+                    positions[next++] = i;
+                }
+            }
+        }
+    });
+    ForEachRange(left_chunks, 1, partitioner, [&](size_t begin, size_t count) {
+        for (size_t c = begin; c != begin + count; ++c) {
+            const auto [lo, hi] = chunk_at(c);
+            size_t next = left_offsets[c];
+            for (size_t i = lo; i != hi; ++i) {
+                if (flags[i] == 0) {
+                    std::ranges::swap(first[i], first[positions[next++]]);
+                }
+            }
+        }
+    });
+#else
+    static_cast<void>(partitioner);
+    size_t right = boundary;
+    for (size_t i = 0; i != boundary; ++i) {
+        if (flags[i] == 0) {
+            while (flags[right] == 0) {
+                ++right;
+            }
+            std::ranges::swap(first[i], first[right++]);
+        }
+    }
+#endif
+    return boundary;
+}
+
+}  // namespace parallel_algorithms_detail
+
+/// Вызывает op для каждого элемента v. Порядок вызовов не определён, каждый участок получает свою копию op
+template <typename T, typename Alloc, typename Growth, typename Op>
+void ParallelForEach(Vector<T, Alloc, Growth>& v, Op op,
+                     ParallelPartitioner partitioner = ParallelPartitioner::AUTO) {
+    parallel_algorithms_detail::ForEachElement(v.begin(), v.Size(), op, partitioner);
+}
+
+template <typename T, typename Alloc, typename Growth, typename Op>
+void ParallelForEach(const Vector<T, Alloc, Growth>& v, Op op,
+                     ParallelPartitioner partitioner = ParallelPartitioner::AUTO) {
+    parallel_algorithms_detail::ForEachElement(v.begin(), v.Size(), op, partitioner);
+}
+
+/// Добавляет в конец dst значения op(x) для каждого x из src, создавая их сразу в
+/// неинициализированной памяти dst без предварительного конструирования по умолчанию.
+/// Память dst выделяется не более одного раза. Если op выбрасывает исключение,
+/// dst остаётся в исходном состоянии, а исключение одного из участков выбрасывается дальше
+template <typename T, typename AllocT, typename GrowthT, typename U, typename AllocU, typename GrowthU, typename Op>
+void ParallelTransform(const Vector<T, AllocT, GrowthT>& src, Vector<U, AllocU, GrowthU>& dst, Op op,
+                       ParallelPartitioner partitioner = ParallelPartitioner::AUTO) {
+    const T* source = src.begin();
+    const size_t n = src.Size();
+    dst.AppendWith(n, [source, n, &op, partitioner](U* out, size_t /*count*/) {
+#if defined(VECTOR_WITH_TBB)
+        auto construct = [source, out, &op](size_t first, size_t count) {
+            parallel_memory_detail::ConstructEach(out + first, count, [source, first, &op](U* place, size_t i) {
+                std::construct_at(place, std::invoke(op, source[first + i]));
+            });
+        };
+        const size_t grain = parallel_algorithms_detail::GrainSize(std::max(sizeof(T), sizeof(U)));
+        parallel_algorithms_detail::WithPartitioner(partitioner, [&](const auto& tbb_partitioner) {
+            parallel_memory_detail::ParallelConstruct(out, n, grain, tbb_partitioner, construct);
+        });
+#else
+        static_cast<void>(partitioner);
+        parallel_memory_detail::ConstructEach(out, n, [source, &op](U* place, size_t i) {
+            std::construct_at(place, std::invoke(op, source[i]));
+        });
+#endif
+    });
+}
+
+/// Сортирует v по comp. Порядок равных элементов не сохраняется. tbb::parallel_sort
+/// сам выбирает разбиение, поэтому разделитель здесь не задаётся
+template <typename T, typename Alloc, typename Growth, typename Compare = std::less<>>
+void ParallelSort(Vector<T, Alloc, Growth>& v, Compare comp = Compare()) {
+#if defined(VECTOR_WITH_TBB)
+    tbb::parallel_sort(v.begin(), v.end(), comp);
+#else
+    std::sort(v.begin(), v.end(), comp);
+#endif
+}
+
+/// Сворачивает элементы v операцией op, начиная с identity. op должна быть ассоциативной,
+/// а identity — её нейтральным элементом: каждый участок сворачивается от identity,
+/// и результаты соседних участков объединяются той же op в порядке следования
+template <typename T, typename Alloc, typename Growth, typename R, typename BinaryOp = std::plus<>>
+[[nodiscard]] R ParallelReduce(const Vector<T, Alloc, Growth>& v, R identity, BinaryOp op = BinaryOp(),
+                               ParallelPartitioner partitioner = ParallelPartitioner::AUTO) {
+    const T* data = v.begin();
+#if defined(VECTOR_WITH_TBB)
+    const tbb::blocked_range<size_t> whole(0, v.Size(), parallel_algorithms_detail::GrainSize(sizeof(T)));
+    return parallel_algorithms_detail::WithPartitioner(partitioner, [&](const auto& tbb_partitioner) {
+        return tbb::parallel_reduce(whole, identity, [data, &op](const tbb::blocked_range<size_t>& range, R acc) {
+            for (size_t i = range.begin(); i != range.end(); ++i) {
+                acc = std::invoke(op, std::move(acc), data[i]);
+            }
+            return acc;
+        }, [&op](R lhs, R rhs) {
+            return std::invoke(op, std::move(lhs), std::move(rhs));
+        }, tbb_partitioner);
+    });
+#else
+    static_cast<void>(partitioner);
+    return std::accumulate(data, data + v.Size(), std::move(identity), op);
+#endif
+}
+
+/// Переставляет элементы v так, что удовлетворяющие pred предшествуют остальным,
+/// и возвращает количество первых. pred вычисляется ровно один раз для каждого элемента;
+/// порядок элементов внутри групп не сохраняется. Требует дополнительной памяти
+/// по одному байту на элемент и по одному индексу на каждый элемент не на своём месте
+template <typename T, typename Alloc, typename Growth, typename Predicate>
+size_t ParallelPartition(Vector<T, Alloc, Growth>& v, Predicate pred,
+                         ParallelPartitioner partitioner = ParallelPartitioner::AUTO) {
+    T* data = v.begin();
+    const size_t n = v.Size();
+    Vector<unsigned char> flags(n, DefaultInitTag{});
+    unsigned char* marks = flags.begin();
+    auto mark = [data, marks, &pred](size_t first, size_t count) {
+        for (size_t i = first; i != first + count; ++i) {
+            marks[i] = std::invoke(pred, std::as_const(data[i])) ? 1 : 0;
+        }
+    };
+#if defined(VECTOR_WITH_TBB)
+    parallel_algorithms_detail::ForEachRange(n, parallel_algorithms_detail::GrainSize(sizeof(T)), partitioner, mark);
+#else
+    mark(0, n);
+#endif
+    return parallel_algorithms_detail::PartitionByFlags(data, n, marks, partitioner);
+}
@@ -0,0 +1,304 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if defined(VECTOR_WITH_TBB)
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
+/// Массовые операции над неинициализированной памятью, которые Vector использует
+/// при конструировании, копировании, изменении размера, реаллокации и разрушении.
+/// Если проект собран с VECTOR_WITH_TBB и количество элементов не меньше порога
+/// SetParallelThreshold, операция делится на участки и выполняется на всех ядрах.
+/// Иначе вызывается соответствующий последовательный алгоритм std::.
+/// При вычислении на этапе компиляции элементы создаются по одному через std::construct_at
+
+namespace parallel_memory_detail {
+
+inline std::atomic<size_t>& Threshold() noexcept {
+    static std::atomic<size_t> threshold{SIZE_MAX};
+    return threshold;
+}
+
+}  // namespace parallel_memory_detail
+
+/// Устанавливает минимальное количество элементов, начиная с которого массовые операции
+/// выполняются параллельно. SIZE_MAX (значение по умолчанию) отключает параллельный режим
+inline void SetParallelThreshold(size_t elements) noexcept {
+    parallel_memory_detail::Threshold().store(elements, std::memory_order_relaxed);
+}
+
+[[nodiscard]] inline size_t GetParallelThreshold() noexcept {
+    return parallel_memory_detail::Threshold().load(std::memory_order_relaxed);
+}
+
+namespace parallel_memory_detail {
+
+#if defined(VECTOR_WITH_TBB)
+
+inline bool IsParallel(size_t n) noexcept {
+    return n >= GetParallelThreshold() && n > 1;
+}
+
+/// Размер участка: не больше 256 КиБ, чтобы задачи равномерно распределялись по ядрам,
+/// и не меньше 1/64 всей операции, чтобы накладные расходы на задачи оставались малыми
+inline size_t ChunkSize(size_t n, size_t elem_size) noexcept {
+    const size_t max_chunk = std::max<size_t>(1, 256 * 1024 / elem_size);
+    return std::max<size_t>(1, std::min(n / 64, max_chunk));
+}
+
+/// Вызывает op(first, count) для участков [0, n) параллельно
+template <typename Op>
+void ForEachChunk(size_t n, size_t elem_size, Op op) {
+    const size_t chunk = ChunkSize(n, elem_size);
+    const size_t chunks = (n + chunk - 1) / chunk;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, chunks, 1), [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i != range.end(); ++i) {
+            const size_t first = i * chunk;
+            op(first, std::min(chunk, n - first));
+        }
+    }, tbb::simple_partitioner());
+}
+
+/// То же для операций, которые не бросают исключений, но вызываются из noexcept-функций.
+/// Сам parallel_for может выбросить исключение (например, если не удалось выделить задачи),
+/// поэтому участки раздаются атомарным счётчиком, а те, до которых задачи не дошли,
+/// обрабатываются в текущем потоке: каждый участок обрабатывается ровно один раз
+template <typename Op>
+void ForEachChunkNoexcept(size_t n, size_t elem_size, Op op) noexcept {
+    const size_t chunk = ChunkSize(n, elem_size);
+    const size_t chunks = (n + chunk - 1) / chunk;
+    std::atomic<size_t> next{0};
+    auto run_next = [&] {
+        const size_t i = next.fetch_add(1, std::memory_order_relaxed);
+        if (i >= chunks) {
+            return false;
+        }
+        const size_t first = i * chunk;
+        op(first, std::min(chunk, n - first));
+        return true;
+    };
+    try {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, chunks, 1), [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i != range.end(); ++i) {
+                run_next();
+            }
+        }, tbb::simple_partitioner());
+    } catch (...) {
+        // parallel_for дожидается запущенных задач, прежде чем выбросить исключение
+    }
+    while (run_next()) {
+    }
+}
+
+/// Создаёт n элементов в dst параллельно участками по chunk элементов: construct(first, count) создаёт элементы участка
+/// и при исключении сама уничтожает уже созданные в нём. Если какой-либо участок завершился
+/// исключением, полностью созданные участки уничтожаются, а исключение выбрасывается дальше
+template <typename T, typename Construct, typename Partitioner>
+void ParallelConstruct(T* dst, size_t n, size_t chunk, const Partitioner& partitioner, Construct construct) {
+    const size_t chunks = (n + chunk - 1) / chunk;
+    // каждый флаг пишет только задача своего участка, а читаются они после завершения parallel_for
+    std::unique_ptr<bool[]> done(new bool[chunks]());
+    try {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, chunks, 1), [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i != range.end(); ++i) {
+                const size_t first = i * chunk;
+                construct(first, std::min(chunk, n - first));
+                done[i] = true;
+            }
+        }, partitioner);
+    } catch (...) {
+        for (size_t i = 0; i != chunks; ++i) {
+            if (done[i]) {
+                const size_t first = i * chunk;
+                std::destroy_n(dst + first, std::min(chunk, n - first));
+            }
+        }
+        throw;
+    }
+}
+
+template <typename T, typename Construct>
+void ParallelConstruct(T* dst, size_t n, Construct construct) {
+    ParallelConstruct(dst, n, ChunkSize(n, sizeof(T)), tbb::simple_partitioner(), std::move(construct));
+}
+
+#endif
+
+/// Создаёт n элементов в dst вызовом make(place, i) по одному; при исключении
+/// созданные элементы уничтожаются. Используется при вычислении на этапе компиляции,
+/// где std::uninitialized_* недоступны
+template <typename T, typename Make>
+constexpr void ConstructEach(T* dst, size_t n, Make make) {
+    size_t i = 0;
+    try {
+        for (; i != n; ++i) {
+            make(dst + i, i);
+        }
+    } catch (...) {
+        std::destroy_n(dst, i);
+        throw;
+    }
+}
+
+}  // namespace parallel_memory_detail
+
+/// Аналог std::uninitialized_value_construct_n
+template <typename T>
+constexpr void BulkValueConstruct(T* dst, size_t n) {
+    if (std::is_constant_evaluated()) {
+        parallel_memory_detail::ConstructEach(dst, n, [](T* place, size_t) { std::construct_at(place); });
+        return;
+    }
+#if defined(VECTOR_WITH_TBB)
+    if (parallel_memory_detail::IsParallel(n)) {
+        parallel_memory_detail::ParallelConstruct(dst, n, [dst](size_t first, size_t count) {
+            std::uninitialized_value_construct_n(dst + first, count);
+        });
+        return;
+    }
+#endif
+    std::uninitialized_value_construct_n(dst, n);
+}
+
+/// Аналог std::uninitialized_default_construct_n. На этапе компиляции неинициализированные
+/// значения недопустимы, поэтому там элементы инициализируются значением
+template <typename T>
+constexpr void BulkDefaultConstruct(T* dst, size_t n) {
+    if (std::is_constant_evaluated()) {
+        BulkValueConstruct(dst, n);
+        return;
+    }
+    if constexpr (std::is_trivially_default_constructible_v<T>) {
+        return;
+    }
+#if defined(VECTOR_WITH_TBB)
+    if (parallel_memory_detail::IsParallel(n)) {
+        parallel_memory_detail::ParallelConstruct(dst, n, [dst](size_t first, size_t count) {
+            std::uninitialized_default_construct_n(dst + first, count);
+        });
+        return;
+    }
+#endif
+    std::uninitialized_default_construct_n(dst, n);
+}
+
+/// Аналог std::uninitialized_copy_n для итераторов произвольного доступа
+template <typename RandomIt, typename T>
+constexpr void BulkCopyConstruct(RandomIt src, size_t n, T* dst) {
+    if (std::is_constant_evaluated()) {
+        parallel_memory_detail::ConstructEach(dst, n, [src](T* place, size_t i) { std::construct_at(place, src[i]); });
+        return;
+    }
+#if defined(VECTOR_WITH_TBB)
+    if (parallel_memory_detail::IsParallel(n)) {
+        parallel_memory_detail::ParallelConstruct(dst, n, [src, dst](size_t first, size_t count) {
+            std::uninitialized_copy_n(src + first, count, dst + first);
+        });
+        return;
+    }
+#endif
+    std::uninitialized_copy_n(src, n, dst);
+}
+
+/// Аналог std::uninitialized_move_n
+template <typename T>
+constexpr void BulkMoveConstruct(T* src, size_t n, T* dst) {
+    if (std::is_constant_evaluated()) {
+        parallel_memory_detail::ConstructEach(dst, n, [src](T* place, size_t i) {
+            std::construct_at(place, std::move(src[i]));
+        });
+        return;
+    }
+#if defined(VECTOR_WITH_TBB)
+    if (parallel_memory_detail::IsParallel(n)) {
+        parallel_memory_detail::ParallelConstruct(dst, n, [src, dst](size_t first, size_t count) {
+            std::uninitialized_move_n(src + first, count, dst + first);
+        });
+        return;
+    }
+#endif
+    std::uninitialized_move_n(src, n, dst);
+}
+
+/// Аналог std::uninitialized_fill_n
+template <typename T>
+constexpr void BulkFillConstruct(T* dst, size_t n, const T& value) {
+    if (std::is_constant_evaluated()) {
+        parallel_memory_detail::ConstructEach(dst, n, [&value](T* place, size_t) { std::construct_at(place, value); });
+        return;
+    }
+#if defined(VECTOR_WITH_TBB)
+    if (parallel_memory_detail::IsParallel(n)) {
+        parallel_memory_detail::ParallelConstruct(dst, n, [dst, &value](size_t first, size_t count) {
+            std::uninitialized_fill_n(dst + first, count, value);
+        });
+        return;
+    }
+#endif
+    std::uninitialized_fill_n(dst, n, value);
+}
+
+/// Аналог std::copy_n в уже созданные элементы.
+/// При исключении часть элементов может остаться перезаписанной
+template <typename RandomIt, typename T>
+constexpr void BulkCopyAssign(RandomIt src, size_t n, T* dst) {
+    if (std::is_constant_evaluated()) {
+        std::copy_n(src, n, dst);
+        return;
+    }
+#if defined(VECTOR_WITH_TBB)
+    if (parallel_memory_detail::IsParallel(n)) {
+        parallel_memory_detail::ForEachChunk(n, sizeof(T), [src, dst](size_t first, size_t count) {
+            std::copy_n(src + first, count, dst + first);
+        });
+        return;
+    }
+#endif
+    std::copy_n(src, n, dst);
+}
+
+/// Аналог std::destroy_n
+template <typename T>
+constexpr void BulkDestroy(T* dst, size_t n) noexcept {
+    if constexpr (std::is_trivially_destructible_v<T>) {
+        return;
+    }
+    if (std::is_constant_evaluated()) {
+        std::destroy_n(dst, n);
+        return;
+    }
+#if defined(VECTOR_WITH_TBB)
+    if (parallel_memory_detail::IsParallel(n)) {
+        parallel_memory_detail::ForEachChunkNoexcept(n, sizeof(T), [dst](size_t first, size_t count) {
+            std::destroy_n(dst + first, count);
+        });
+        return;
+    }
+#endif
+    std::destroy_n(dst, n);
+}
+
+/// Побайтовое копирование n элементов, например при переносе тривиально перемещаемых типов
+template <typename T>
+void BulkMemcpy(T* dst, const T* src, size_t n) noexcept {
+    if (n == 0) {
+        return;
+    }
+#if defined(VECTOR_WITH_TBB)
+    if (parallel_memory_detail::IsParallel(n)) {
+        parallel_memory_detail::ForEachChunkNoexcept(n, sizeof(T), [src, dst](size_t first, size_t count) {
+            std::memcpy(static_cast<void*>(dst + first), static_cast<const void*>(src + first), count * sizeof(T));
+        });
+        return;
+    }
+#endif
+    std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+}
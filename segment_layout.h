@@ -0,0 +1,37 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <limits>
+
+/// Разбиение индексов на сегменты геометрически растущего размера:
+/// сегмент 0 содержит FIRST элементов, сегмент k — FIRST * 2^k элементов,
+/// так что k первых сегментов вмещают FIRST * (2^k - 1) элементов.
+/// Номер сегмента и смещение в нём вычисляются несколькими битовыми операциями,
+/// а добавление сегмента не требует переноса уже размещённых элементов
+template <size_t FIRST>
+struct SegmentLayout {
+    static_assert(std::has_single_bit(FIRST), "the first segment size must be a power of two");
+
+    static constexpr size_t FIRST_SHIFT = std::countr_zero(FIRST);
+    /// количество сегментов, достаточное для любого индекса size_t
+    static constexpr size_t MAX_SEGMENTS = std::numeric_limits<size_t>::digits - FIRST_SHIFT;
+
+    /// номер сегмента, в котором лежит элемент index
+    static constexpr size_t SegmentOf(size_t index) noexcept {
+        return std::bit_width((index >> FIRST_SHIFT) + 1) - 1;
+    }
+
+    /// индекс первого элемента сегмента, он же суммарная вместимость предыдущих сегментов
+    static constexpr size_t SegmentBase(size_t segment) noexcept {
+        return ((size_t{1} << segment) - 1) << FIRST_SHIFT;
+    }
+
+    static constexpr size_t SegmentSize(size_t segment) noexcept {
+        return FIRST << segment;
+    }
+
+    /// количество сегментов, необходимое для count элементов
+    static constexpr size_t SegmentsFor(size_t count) noexcept {
+        return count == 0 ? 0 : SegmentOf(count - 1) + 1;
+    }
+};
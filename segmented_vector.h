@@ -0,0 +1,479 @@
+#pragma once
+#include "segment_layout.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+
+/// Вектор из блоков RawMemory, размеры которых растут степенями двойки (SegmentLayout).
+/// Рост добавляет новый блок и никогда не переносит существующие элементы, поэтому
+/// EmplaceBack выполняется за O(1) без пиков задержки, а ссылки и указатели на элементы
+/// остаются действительными до удаления самих элементов (PopBack, Resize, Clear).
+/// Индекс переводится в номер блока и смещение несколькими битовыми операциями
+template <typename T, typename Alloc = std::allocator<T>, size_t FirstSegmentSize = 16>
+class SegmentedVector {
+    using Layout = SegmentLayout<FirstSegmentSize>;
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using Segment = RawMemory<T, Alloc>;
+    using SegmentAlloc = typename AllocTraits::template rebind_alloc<Segment>;
+
+    template <bool IsConst>
+    class Iterator;
+
+public:
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using allocator_type = Alloc;
+
+    SegmentedVector() = default;
+
+    explicit SegmentedVector(const Alloc& alloc) noexcept;
+
+    /// Создаёт вектор из size элементов со значением по умолчанию
+    explicit SegmentedVector(size_t size, const Alloc& alloc = Alloc());
+
+    /// Аллокатор получается через select_on_container_copy_construction
+    SegmentedVector(const SegmentedVector& other);
+    SegmentedVector(const SegmentedVector& other, const Alloc& alloc);
+
+    /// Копирует аллокатор rhs, только если этого требует propagate_on_container_copy_assignment
+    SegmentedVector& operator=(const SegmentedVector& rhs);
+
+    SegmentedVector(SegmentedVector&& other) noexcept;
+
+    /// Если аллокатор не распространяется при перемещении и не равен аллокатору rhs,
+    /// элементы перемещаются поштучно
+    SegmentedVector& operator=(SegmentedVector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                                               || AllocTraits::is_always_equal::value);
+
+    ~SegmentedVector();
+
+    iterator begin() noexcept;
+    iterator end() noexcept;
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    [[nodiscard]] size_t Size() const noexcept;
+    /// Суммарная вместимость выделенных блоков
+    [[nodiscard]] size_t Capacity() const noexcept;
+    [[nodiscard]] bool IsEmpty() const noexcept;
+    const T& operator[](size_t index) const noexcept;
+    T& operator[](size_t index) noexcept;
+
+    /// Выделяет блоки, чтобы вместить new_capacity элементов. Элементы не переносятся
+    void Reserve(size_t new_capacity);
+    /// Освобождает блоки, в которых нет элементов
+    void ShrinkToFit();
+    void Swap(SegmentedVector& other) noexcept;
+    /// При исключении в конструкторе нового элемента размер не меняется
+    void Resize(size_t new_size);
+    /// Удаляет все элементы, сохраняя блоки
+    void Clear() noexcept;
+
+    template <typename Type>
+    void PushBack(Type&& value);
+
+    void PopBack() noexcept;
+
+    /// Ссылки на остальные элементы остаются действительными
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args);
+
+    [[nodiscard]] Alloc GetAllocator() const noexcept;
+
+private:
+    [[no_unique_address]] Alloc alloc_;
+    /// блок k вмещает Layout::SegmentSize(k) элементов; выделены всегда первые блоки подряд
+    Vector<Segment, SegmentAlloc> segments_;
+    size_t size_ = 0;
+
+    /// вызывает op(T* first, size_t count) для непрерывных участков элементов [first, last)
+    template <typename Op>
+    void ForEachRange(size_t first, size_t last, Op op);
+
+    /// уничтожает элементы начиная с new_size
+    void Truncate(size_t new_size) noexcept;
+
+    /// уничтожает элементы и забирает блоки other вместе с его аллокатором
+    void TakeStorage(SegmentedVector& other) noexcept;
+
+}; // class SegmentedVector
+
+/// Итератор произвольного доступа: указатель на вектор и индекс элемента
+template <typename T, typename Alloc, size_t FirstSegmentSize>
+template <bool IsConst>
+class SegmentedVector<T, Alloc, FirstSegmentSize>::Iterator {
+    using Owner = std::conditional_t<IsConst, const SegmentedVector, SegmentedVector>;
+
+public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<IsConst, const T*, T*>;
+    using reference = std::conditional_t<IsConst, const T&, T&>;
+
+    Iterator() = default;
+
+    Iterator(Owner* owner, size_t index) noexcept
+            : owner_(owner)
+            , index_(index)  //
+    {
+    }
+
+    /// неконстантный итератор преобразуется в константный
+    operator Iterator<true>() const noexcept requires(!IsConst) {
+        return {owner_, index_};
+    }
+
+    reference operator*() const noexcept {
+        return (*owner_)[index_];
+    }
+
+    pointer operator->() const noexcept {
+        return &**this;
+    }
+
+    reference operator[](difference_type n) const noexcept {
+        return (*owner_)[index_ + n];
+    }
+
+    Iterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+
+    Iterator operator++(int) noexcept {
+        Iterator copy = *this;
+        ++index_;
+        return copy;
+    }
+
+    Iterator& operator--() noexcept {
+        --index_;
+        return *this;
+    }
+
+    Iterator operator--(int) noexcept {
+        Iterator copy = *this;
+        --index_;
+        return copy;
+    }
+
+    Iterator& operator+=(difference_type n) noexcept {
+        index_ += n;
+        return *this;
+    }
+
+    Iterator& operator-=(difference_type n) noexcept {
+        index_ -= n;
+        return *this;
+    }
+
+    friend Iterator operator+(Iterator it, difference_type n) noexcept {
+        return it += n;
+    }
+
+    friend Iterator operator+(difference_type n, Iterator it) noexcept {
+        return it += n;
+    }
+
+    friend Iterator operator-(Iterator it, difference_type n) noexcept {
+        return it -= n;
+    }
+
+    friend difference_type operator-(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+    }
+
+    friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return lhs.index_ == rhs.index_;
+    }
+
+    friend auto operator<=>(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return lhs.index_ <=> rhs.index_;
+    }
+
+private:
+    Owner* owner_ = nullptr;
+    size_t index_ = 0;
+};
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+SegmentedVector<T, Alloc, FirstSegmentSize>::SegmentedVector(const Alloc& alloc) noexcept
+        : alloc_(alloc)
+        , segments_(SegmentAlloc(alloc))  //
+{
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+SegmentedVector<T, Alloc, FirstSegmentSize>::SegmentedVector(size_t size, const Alloc& alloc)
+        : SegmentedVector(alloc)  //
+{
+    Resize(size);
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+SegmentedVector<T, Alloc, FirstSegmentSize>::SegmentedVector(const SegmentedVector& other)
+        : SegmentedVector(other, AllocTraits::select_on_container_copy_construction(other.alloc_))  //
+{
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+SegmentedVector<T, Alloc, FirstSegmentSize>::SegmentedVector(const SegmentedVector& other, const Alloc& alloc)
+        : SegmentedVector(alloc)  //
+{
+    Reserve(other.size_);
+    for (const T& value : other) {
+        EmplaceBack(value);
+    }
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+SegmentedVector<T, Alloc, FirstSegmentSize>& SegmentedVector<T, Alloc, FirstSegmentSize>::operator=(
+        const SegmentedVector& rhs) {
+    if (this == &rhs) {
+        return *this;
+    }
+    if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+        if (alloc_ != rhs.alloc_) {
+            /* блоки нужно вернуть старому аллокатору, поэтому копия строится аллокатором rhs */
+            SegmentedVector rhs_copy(rhs, rhs.alloc_);
+            TakeStorage(rhs_copy);
+            return *this;
+        }
+    }
+    const size_t common = std::min(size_, rhs.size_);
+    for (size_t i = 0; i != common; ++i) {
+        (*this)[i] = rhs[i];
+    }
+    if (rhs.size_ < size_) {
+        Truncate(rhs.size_);
+    } else {
+        Reserve(rhs.size_);
+        for (size_t i = common; i != rhs.size_; ++i) {
+            EmplaceBack(rhs[i]);
+        }
+    }
+    return *this;
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+SegmentedVector<T, Alloc, FirstSegmentSize>::SegmentedVector(SegmentedVector&& other) noexcept
+        : alloc_(std::move(other.alloc_))
+        , segments_(std::move(other.segments_))
+        , size_(std::exchange(other.size_, 0))  //
+{
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+SegmentedVector<T, Alloc, FirstSegmentSize>& SegmentedVector<T, Alloc, FirstSegmentSize>::operator=(
+        SegmentedVector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                        || AllocTraits::is_always_equal::value) {
+    if (this == &rhs) {
+        return *this;
+    }
+    if constexpr (!AllocTraits::propagate_on_container_move_assignment::value
+                  && !AllocTraits::is_always_equal::value) {
+        if (alloc_ != rhs.alloc_) {
+            Truncate(0);
+            Reserve(rhs.size_);
+            for (T& value : rhs) {
+                EmplaceBack(std::move(value));
+            }
+            return *this;
+        }
+    }
+    TakeStorage(rhs);
+    return *this;
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+SegmentedVector<T, Alloc, FirstSegmentSize>::~SegmentedVector() {
+    Truncate(0);
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+typename SegmentedVector<T, Alloc, FirstSegmentSize>::iterator SegmentedVector<T, Alloc, FirstSegmentSize>::begin() noexcept {
+    return {this, 0};
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+typename SegmentedVector<T, Alloc, FirstSegmentSize>::iterator SegmentedVector<T, Alloc, FirstSegmentSize>::end() noexcept {
+    return {this, size_};
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+typename SegmentedVector<T, Alloc, FirstSegmentSize>::const_iterator SegmentedVector<T, Alloc, FirstSegmentSize>::begin() const noexcept {
+    return {this, 0};
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+typename SegmentedVector<T, Alloc, FirstSegmentSize>::const_iterator SegmentedVector<T, Alloc, FirstSegmentSize>::end() const noexcept {
+    return {this, size_};
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+typename SegmentedVector<T, Alloc, FirstSegmentSize>::const_iterator SegmentedVector<T, Alloc, FirstSegmentSize>::cbegin() const noexcept {
+    return begin();
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+typename SegmentedVector<T, Alloc, FirstSegmentSize>::const_iterator SegmentedVector<T, Alloc, FirstSegmentSize>::cend() const noexcept {
+    return end();
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+size_t SegmentedVector<T, Alloc, FirstSegmentSize>::Size() const noexcept {
+    return size_;
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+size_t SegmentedVector<T, Alloc, FirstSegmentSize>::Capacity() const noexcept {
+    return Layout::SegmentBase(segments_.Size());
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+bool SegmentedVector<T, Alloc, FirstSegmentSize>::IsEmpty() const noexcept {
+    return size_ == 0;
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+const T& SegmentedVector<T, Alloc, FirstSegmentSize>::operator[](size_t index) const noexcept {
+    return const_cast<SegmentedVector&>(*this)[index];
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+T& SegmentedVector<T, Alloc, FirstSegmentSize>::operator[](size_t index) noexcept {
+    assert(index < size_);
+    const size_t k = Layout::SegmentOf(index);
+    return segments_[k][index - Layout::SegmentBase(k)];
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+void SegmentedVector<T, Alloc, FirstSegmentSize>::Reserve(size_t new_capacity) {
+    const size_t segments = Layout::SegmentsFor(new_capacity);
+    if (segments <= segments_.Size()) {
+        return;
+    }
+    segments_.Reserve(segments);
+    while (segments_.Size() < segments) {
+        segments_.EmplaceBack(Layout::SegmentSize(segments_.Size()), alloc_);
+    }
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+void SegmentedVector<T, Alloc, FirstSegmentSize>::ShrinkToFit() {
+    const size_t segments = Layout::SegmentsFor(size_);
+    while (segments_.Size() > segments) {
+        segments_.PopBack();
+    }
+    segments_.ShrinkToFit();
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+void SegmentedVector<T, Alloc, FirstSegmentSize>::Swap(SegmentedVector& other) noexcept {
+    if constexpr (AllocTraits::propagate_on_container_swap::value) {
+        using std::swap;
+        swap(alloc_, other.alloc_);
+    } else {
+        assert(alloc_ == other.alloc_);
+    }
+    segments_.Swap(other.segments_);
+    std::swap(size_, other.size_);
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+void SegmentedVector<T, Alloc, FirstSegmentSize>::Resize(size_t new_size) {
+    if (new_size < size_) {
+        Truncate(new_size);
+        return;
+    }
+    Reserve(new_size);
+    const size_t old_size = size_;
+    try {
+        ForEachRange(old_size, new_size, [this](T* first, size_t count) {
+            BulkValueConstruct(first, count);
+            size_ += count;
+        });
+    } catch (...) {
+        Truncate(old_size);
+        throw;
+    }
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+void SegmentedVector<T, Alloc, FirstSegmentSize>::Clear() noexcept {
+    Truncate(0);
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+template<typename Type>
+void SegmentedVector<T, Alloc, FirstSegmentSize>::PushBack(Type&& value) {
+    EmplaceBack(std::forward<Type>(value));
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+void SegmentedVector<T, Alloc, FirstSegmentSize>::PopBack() noexcept {
+    assert(size_ > 0);
+    Truncate(size_ - 1);
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+template<typename... Args>
+T& SegmentedVector<T, Alloc, FirstSegmentSize>::EmplaceBack(Args&&... args) {
+    const size_t k = Layout::SegmentOf(size_);
+    if (k == segments_.Size()) {
+        /// новый блок добавляется, существующие элементы остаются на месте
+        segments_.EmplaceBack(Layout::SegmentSize(k), alloc_);
+    }
+    T* place = segments_[k] + (size_ - Layout::SegmentBase(k));
+    new (place) T(std::forward<Args>(args)...);
+    ++size_;
+    return *place;
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+Alloc SegmentedVector<T, Alloc, FirstSegmentSize>::GetAllocator() const noexcept {
+    return alloc_;
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+template<typename Op>
+void SegmentedVector<T, Alloc, FirstSegmentSize>::ForEachRange(size_t first, size_t last, Op op) {
+    while (first < last) {
+        const size_t k = Layout::SegmentOf(first);
+        const size_t offset = first - Layout::SegmentBase(k);
+        const size_t count = std::min(last - first, Layout::SegmentSize(k) - offset);
+        op(segments_[k] + offset, count);
+        first += count;
+    }
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+void SegmentedVector<T, Alloc, FirstSegmentSize>::Truncate(size_t new_size) noexcept {
+    assert(new_size <= size_);
+    ForEachRange(new_size, size_, [](T* first, size_t count) {
+        BulkDestroy(first, count);
+    });
+    size_ = new_size;
+}
+
+template<typename T, typename Alloc, size_t FirstSegmentSize>
+void SegmentedVector<T, Alloc, FirstSegmentSize>::TakeStorage(SegmentedVector& other) noexcept {
+    Truncate(0);
+    if constexpr (std::is_move_assignable_v<Alloc>) {
+        alloc_ = std::move(other.alloc_);
+    }
+    segments_ = std::move(other.segments_);
+    size_ = std::exchange(other.size_, 0);
+}
@@ -0,0 +1,290 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+
+/// Двоичная сериализация векторов тривиально копируемых элементов без промежуточных буферов.
+/// Каждый вектор записывается как заголовок SerializedHeader и следующие за ним байты элементов.
+/// Вектор векторов записывается как заголовок с количеством вложенных векторов,
+/// за которым подряд идут сами вложенные векторы в том же формате.
+/// Формат привязан к представлению T, поэтому переносим только между одинаковыми платформами
+
+/// Заголовок сериализованного вектора
+struct SerializedHeader {
+    static constexpr char MAGIC[4] = {'V', 'E', 'C', 'S'};
+    static constexpr uint16_t VERSION = 1;
+
+    char magic[4];
+    uint16_t version;
+    /// глубина вложенности: 0 для вектора элементов, 1 для вектора векторов и т.д.
+    uint16_t nesting;
+    /// размер элемента самого внутреннего вектора
+    uint32_t element_size;
+    uint32_t reserved;
+    /// количество элементов (для вложенных — количество векторов)
+    uint64_t count;
+};
+
+static_assert(sizeof(SerializedHeader) == 24 && std::is_trivially_copyable_v<SerializedHeader>);
+
+namespace serialization_detail {
+
+template <typename T>
+struct Layout {
+    static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable elements can be serialized");
+
+    static constexpr uint16_t NESTING = 0;
+    static constexpr size_t ELEMENT_SIZE = sizeof(T);
+};
+
+template <typename T, typename Alloc, typename Growth>
+struct Layout<Vector<T, Alloc, Growth>> {
+    static constexpr uint16_t NESTING = Layout<T>::NESTING + 1;
+    static constexpr size_t ELEMENT_SIZE = Layout<T>::ELEMENT_SIZE;
+};
+
+template <typename T>
+SerializedHeader MakeHeader(size_t count) noexcept {
+    SerializedHeader header{};
+    std::memcpy(header.magic, SerializedHeader::MAGIC, sizeof(header.magic));
+    header.version = SerializedHeader::VERSION;
+    header.nesting = Layout<T>::NESTING;
+    header.element_size = static_cast<uint32_t>(Layout<T>::ELEMENT_SIZE);
+    header.count = count;
+    return header;
+}
+
+[[noreturn]] inline void ThrowSystemError(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+/// Читает ровно size байт, повторяя read после частичного чтения и EINTR
+inline void ReadExactly(int fd, void* buf, size_t size) {
+    auto* dst = static_cast<std::byte*>(buf);
+    while (size != 0) {
+        const ssize_t n = ::read(fd, dst, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ThrowSystemError("read");
+        }
+        if (n == 0) {
+            throw std::runtime_error("unexpected end of serialized vector");
+        }
+        dst += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
+/// Читает и проверяет заголовок вектора с элементами T, возвращает количество элементов
+template <typename T>
+size_t ReadHeader(int fd) {
+    SerializedHeader header;
+    ReadExactly(fd, &header, sizeof(header));
+    const SerializedHeader expected = MakeHeader<T>(0);
+    if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("stream does not contain a serialized vector");
+    }
+    if (header.version != expected.version) {
+        throw std::runtime_error("unsupported serialized vector version " + std::to_string(header.version));
+    }
+    if (header.nesting != expected.nesting || header.element_size != expected.element_size) {
+        throw std::runtime_error("serialized vector has a different element type");
+    }
+    // count пришёл из потока: count * sizeof(T) не должно переполняться
+    if (header.count > static_cast<uint64_t>(PTRDIFF_MAX) / sizeof(T)) {
+        throw std::runtime_error("serialized vector is too large");
+    }
+    return static_cast<size_t>(header.count);
+}
+
+/// Сколько байт выделяется под элементы, ещё не пришедшие из потока. Память сверх этого
+/// выделяется только по мере чтения, поэтому испорченный count не приводит к огромному выделению
+inline constexpr size_t READ_CHUNK_BYTES = size_t{1} << 20;
+
+/// Количество элементов, под которые выделяется память, когда прочитано done из count
+template <typename T>
+constexpr size_t NextReadSize(size_t done, size_t count) noexcept {
+    const size_t step = std::max(done, std::max<size_t>(READ_CHUNK_BYTES / sizeof(T), 1));
+    return std::min(count, done + step);
+}
+
+}  // namespace serialization_detail
+
+/// Байты элементов вектора без копирования
+template <typename T, typename Alloc, typename Growth>
+std::span<const std::byte> AsBytes(const Vector<T, Alloc, Growth>& v) noexcept {
+    static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable elements can be viewed as bytes");
+    return std::as_bytes(std::span<const T>(v.begin(), v.Size()));
+}
+
+template <typename T, typename Alloc, typename Growth>
+std::span<std::byte> AsWritableBytes(Vector<T, Alloc, Growth>& v) noexcept {
+    static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable elements can be viewed as bytes");
+    return std::as_writable_bytes(std::span<T>(v.begin(), v.Size()));
+}
+
+/// Список фрагментов для writev: заголовки и буферы нескольких векторов,
+/// в том числе вложенных, записываются одним системным вызовом без склейки в общий буфер.
+/// Фрагменты ссылаются на память векторов, поэтому те не должны меняться до записи
+class IoVecList {
+public:
+    /// Добавляет вектор тривиально копируемых элементов
+    template <typename T, typename Alloc, typename Growth>
+        requires std::is_trivially_copyable_v<T>
+    void Add(const Vector<T, Alloc, Growth>& v);
+
+    /// Добавляет вектор векторов: заголовок с количеством и каждый вложенный вектор
+    template <typename T, typename InnerAlloc, typename InnerGrowth, typename Alloc, typename Growth>
+    void Add(const Vector<Vector<T, InnerAlloc, InnerGrowth>, Alloc, Growth>& v);
+
+    [[nodiscard]] std::span<const iovec> Iovecs() const noexcept;
+    [[nodiscard]] size_t TotalBytes() const noexcept;
+
+    /// Записывает все фрагменты в fd, повторяя writev после частичной записи.
+    /// Ошибки записи выбрасываются как std::system_error
+    void WriteTo(int fd) const;
+
+private:
+    /// заголовки хранятся в deque, чтобы указатели на них не менялись при добавлении
+    std::deque<SerializedHeader> headers_;
+    Vector<iovec> iovecs_;
+    size_t total_bytes_ = 0;
+
+    void Append(const void* data, size_t size);
+};
+
+template <typename T, typename Alloc, typename Growth>
+    requires std::is_trivially_copyable_v<T>
+void IoVecList::Add(const Vector<T, Alloc, Growth>& v) {
+    const SerializedHeader& header = headers_.emplace_back(serialization_detail::MakeHeader<T>(v.Size()));
+    Append(&header, sizeof(header));
+    const auto bytes = AsBytes(v);
+    Append(bytes.data(), bytes.size());
+}
+
+template <typename T, typename InnerAlloc, typename InnerGrowth, typename Alloc, typename Growth>
+void IoVecList::Add(const Vector<Vector<T, InnerAlloc, InnerGrowth>, Alloc, Growth>& v) {
+    using Inner = Vector<T, InnerAlloc, InnerGrowth>;
+    const SerializedHeader& header = headers_.emplace_back(serialization_detail::MakeHeader<Inner>(v.Size()));
+    Append(&header, sizeof(header));
+    for (const Inner& inner : v) {
+        Add(inner);
+    }
+}
+
+inline std::span<const iovec> IoVecList::Iovecs() const noexcept {
+    return {iovecs_.begin(), iovecs_.Size()};
+}
+
+inline size_t IoVecList::TotalBytes() const noexcept {
+    return total_bytes_;
+}
+
+inline void IoVecList::Append(const void* data, size_t size) {
+    if (size == 0) {
+        return;
+    }
+    iovec* last = iovecs_.IsEmpty() ? nullptr : &iovecs_[iovecs_.Size() - 1];
+    if (last != nullptr && static_cast<const std::byte*>(last->iov_base) + last->iov_len == data) {
+        // соседние фрагменты склеиваются, например заголовки пустых векторов
+        last->iov_len += size;
+    } else {
+        iovecs_.PushBack(iovec{const_cast<void*>(data), size});
+    }
+    total_bytes_ += size;
+}
+
+inline void IoVecList::WriteTo(int fd) const {
+#if defined(IOV_MAX)
+    constexpr size_t MAX_IOVECS = IOV_MAX;
+#else
+    constexpr size_t MAX_IOVECS = 16;
+#endif
+    size_t index = 0;
+    // смещение внутри iovecs_[index], записанное при частичной записи
+    size_t offset = 0;
+    while (index < iovecs_.Size()) {
+        const size_t count = std::min(MAX_IOVECS, iovecs_.Size() - index);
+        ssize_t written;
+        if (offset == 0) {
+            written = ::writev(fd, &iovecs_[index], static_cast<int>(count));
+        } else {
+            // начало первого фрагмента уже записано; сам список менять нельзя
+            const iovec& first = iovecs_[index];
+            const iovec rest{static_cast<std::byte*>(first.iov_base) + offset, first.iov_len - offset};
+            written = ::write(fd, rest.iov_base, rest.iov_len);
+        }
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            serialization_detail::ThrowSystemError("writev");
+        }
+        auto remaining = static_cast<size_t>(written);
+        while (remaining != 0) {
+            const size_t left = iovecs_[index].iov_len - offset;
+            if (remaining < left) {
+                offset += remaining;
+                break;
+            }
+            remaining -= left;
+            offset = 0;
+            ++index;
+        }
+    }
+}
+
+/// Записывает вектор (или вектор векторов) в fd одним вызовом writev
+template <typename T, typename Alloc, typename Growth>
+void WriteTo(int fd, const Vector<T, Alloc, Growth>& v) {
+    IoVecList list;
+    list.Add(v);
+    list.WriteTo(fd);
+}
+
+/// Читает вектор, записанный WriteTo, заменяя содержимое v.
+/// Заголовок другого типа или версии, слишком большое количество элементов и обрыв потока
+/// приводят к std::runtime_error, ошибки чтения — к std::system_error; при ошибке v не меняется.
+/// Данные читаются в новый буфер, который растёт по мере чтения, и только затем заменяют v
+template <typename T, typename Alloc, typename Growth>
+    requires std::is_trivially_copyable_v<T>
+void ReadFrom(int fd, Vector<T, Alloc, Growth>& v) {
+    const size_t count = serialization_detail::ReadHeader<T>(fd);
+    Vector<T, Alloc, Growth> result(v.GetAllocator());
+    while (result.Size() != count) {
+        const size_t done = result.Size();
+        result.ResizeForOverwrite(serialization_detail::NextReadSize<T>(done, count));
+        const auto bytes = AsWritableBytes(result).subspan(done * sizeof(T));
+        serialization_detail::ReadExactly(fd, bytes.data(), bytes.size());
+    }
+    v.Swap(result);
+}
+
+template <typename T, typename InnerAlloc, typename InnerGrowth, typename Alloc, typename Growth>
+void ReadFrom(int fd, Vector<Vector<T, InnerAlloc, InnerGrowth>, Alloc, Growth>& v) {
+    using Inner = Vector<T, InnerAlloc, InnerGrowth>;
+    const size_t count = serialization_detail::ReadHeader<Inner>(fd);
+    Vector<Inner, Alloc, Growth> result(v.GetAllocator());
+    result.Reserve(serialization_detail::NextReadSize<Inner>(0, count));
+    while (result.Size() != count) {
+        ReadFrom(fd, result.EmplaceBack());
+    }
+    v.Swap(result);
+}
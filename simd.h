@@ -0,0 +1,450 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+/// Векторизованные ядра для непрерывных массивов арифметических типов: Find, Count, Equal,
+/// MinMax, Sum и Fill. Поиск с ранним выходом компилятор сам не векторизует, поэтому ядра
+/// написаны на векторных расширениях GCC/Clang и собираются для нескольких наборов инструкций:
+/// SSE2 (128 бит, базовый для x86-64), AVX2 (256 бит) и AVX-512BW (512 бит) с выбором
+/// по возможностям процессора во время выполнения; на AArch64 используется NEON (128 бит).
+/// Загрузки невыровненные, поэтому ядра работают с любым буфером, а выровненные буферы
+/// (AlignedVector, HugePageVector) просто не пересекают границ кеш-линий.
+/// Без векторных расширений используется скалярный вариант
+
+namespace simd {
+
+/// Набор инструкций, которым пользуются ядра
+enum class SimdLevel {
+    SCALAR,
+    /// 128-битные регистры: SSE2 или NEON
+    VECTOR_128,
+    AVX2,
+    AVX512,
+};
+
+}  // namespace simd
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__aarch64__))
+#define VECTOR_SIMD_EXTENSIONS 1
+#endif
+
+namespace simd_detail {
+
+/// Наилучший набор инструкций, поддерживаемый процессором
+inline simd::SimdLevel DetectSimdLevel() noexcept {
+#if defined(VECTOR_SIMD_EXTENSIONS) && defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        return simd::SimdLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return simd::SimdLevel::AVX2;
+    }
+    return simd::SimdLevel::VECTOR_128;
+#elif defined(VECTOR_SIMD_EXTENSIONS)
+    return simd::SimdLevel::VECTOR_128;
+#else
+    return simd::SimdLevel::SCALAR;
+#endif
+}
+
+inline std::atomic<simd::SimdLevel>& Level() noexcept {
+    static std::atomic<simd::SimdLevel> level{DetectSimdLevel()};
+    return level;
+}
+
+/// Скалярные варианты; они же обрабатывают хвосты короче одного регистра
+template <typename T>
+size_t FindScalar(const T* data, size_t n, T value) noexcept {
+    for (size_t i = 0; i != n; ++i) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return n;
+}
+
+template <typename T>
+size_t CountScalar(const T* data, size_t n, T value) noexcept {
+    size_t count = 0;
+    for (size_t i = 0; i != n; ++i) {
+        count += data[i] == value;
+    }
+    return count;
+}
+
+template <typename T>
+bool EqualScalar(const T* lhs, const T* rhs, size_t n) noexcept {
+    for (size_t i = 0; i != n; ++i) {
+        if (!(lhs[i] == rhs[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Минимум и максимум по правилу x < min / max < x, поэтому NaN после первого элемента не учитывается
+template <typename T>
+void MinMaxScalar(const T* data, size_t n, T& min, T& max) noexcept {
+    for (size_t i = 0; i != n; ++i) {
+        min = data[i] < min ? data[i] : min;
+        max = max < data[i] ? data[i] : max;
+    }
+}
+
+/// Целые суммируются по модулю 2^N без неопределённого поведения при переполнении
+template <typename T>
+struct SumLaneOf {
+    using type = T;
+};
+
+template <std::integral T>
+struct SumLaneOf<T> {
+    using type = std::make_unsigned_t<T>;
+};
+
+template <typename T>
+using SumLane = typename SumLaneOf<T>::type;
+
+template <typename T>
+T SumScalar(const T* data, size_t n) noexcept {
+    SumLane<T> sum{};
+    for (size_t i = 0; i != n; ++i) {
+        sum += static_cast<SumLane<T>>(data[i]);
+    }
+    return static_cast<T>(sum);
+}
+
+#if defined(VECTOR_SIMD_EXTENSIONS)
+
+// Вспомогательные функции ниже всегда встраиваются, поэтому предупреждения
+// о соглашении передачи векторов AVX в функции без AVX к ним не относятся
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+/// Вектор из Bytes / sizeof(T) элементов T
+template <typename T, size_t Bytes>
+struct VecOf {
+    typedef T type __attribute__((vector_size(Bytes)));
+};
+
+/// Целочисленный вектор того же размера, как результат сравнения
+template <typename T>
+using MaskLane = std::conditional_t<sizeof(T) == 1, int8_t,
+                 std::conditional_t<sizeof(T) == 2, int16_t, std::conditional_t<sizeof(T) == 4, int32_t, int64_t>>>;
+
+template <typename T, size_t Bytes>
+using Vec = typename VecOf<T, Bytes>::type;
+
+template <typename T, size_t Bytes>
+using Mask = typename VecOf<MaskLane<T>, Bytes>::type;
+
+template <typename T, size_t Bytes>
+[[gnu::always_inline]] inline Vec<T, Bytes> Load(const T* data) noexcept {
+    Vec<T, Bytes> v;
+    std::memcpy(&v, data, Bytes);
+    return v;
+}
+
+template <typename T, size_t Bytes>
+[[gnu::always_inline]] inline Vec<T, Bytes> Splat(T value) noexcept {
+    Vec<T, Bytes> v;
+    for (size_t i = 0; i != Bytes / sizeof(T); ++i) {
+        v[i] = value;
+    }
+    return v;
+}
+
+/// Есть ли в маске хотя бы одна истинная дорожка
+template <size_t Bytes, typename M>
+[[gnu::always_inline]] inline bool Any(const M& mask) noexcept {
+    uint64_t words[Bytes / 8];
+    std::memcpy(words, &mask, Bytes);
+    uint64_t any = 0;
+    for (uint64_t word : words) {
+        any |= word;
+    }
+    return any != 0;
+}
+
+template <typename T, size_t Bytes>
+[[gnu::always_inline]] inline size_t FindImpl(const T* data, size_t n, T value) noexcept {
+    constexpr size_t LANES = Bytes / sizeof(T);
+    const auto needle = Splat<T, Bytes>(value);
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        if (Any<Bytes>(Load<T, Bytes>(data + i) == needle)) {
+            // точная позиция ищется внутри одного регистра
+            return i + FindScalar(data + i, LANES, value);
+        }
+    }
+    return i + FindScalar(data + i, n - i, value);
+}
+
+template <typename T, size_t Bytes>
+[[gnu::always_inline]] inline size_t CountImpl(const T* data, size_t n, T value) noexcept {
+    constexpr size_t LANES = Bytes / sizeof(T);
+    // истинная дорожка сравнения равна -1, поэтому счётчики дорожек уменьшаются;
+    // их сбрасываем в общий итог раньше, чем узкие дорожки переполнятся
+    constexpr size_t FLUSH = std::min<size_t>(size_t{1} << (8 * sizeof(T) - 1), size_t{1} << 20) - 1;
+    const auto needle = Splat<T, Bytes>(value);
+    size_t count = 0;
+    size_t i = 0;
+    while (i + LANES <= n) {
+        Mask<T, Bytes> acc{};
+        const size_t blocks = std::min(FLUSH, (n - i) / LANES);
+        for (size_t b = 0; b != blocks; ++b, i += LANES) {
+            acc += Load<T, Bytes>(data + i) == needle;
+        }
+        for (size_t lane = 0; lane != LANES; ++lane) {
+            count += static_cast<size_t>(-static_cast<int64_t>(acc[lane]));
+        }
+    }
+    return count + CountScalar(data + i, n - i, value);
+}
+
+template <typename T, size_t Bytes>
+[[gnu::always_inline]] inline bool EqualImpl(const T* lhs, const T* rhs, size_t n) noexcept {
+    constexpr size_t LANES = Bytes / sizeof(T);
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        if (Any<Bytes>(Load<T, Bytes>(lhs + i) != Load<T, Bytes>(rhs + i))) {
+            return false;
+        }
+    }
+    return EqualScalar(lhs + i, rhs + i, n - i);
+}
+
+template <typename T, size_t Bytes>
+[[gnu::always_inline]] inline void MinMaxImpl(const T* data, size_t n, T& min, T& max) noexcept {
+    constexpr size_t LANES = Bytes / sizeof(T);
+    if (n < LANES) {
+        MinMaxScalar(data, n, min, max);
+        return;
+    }
+    const T initial_min = min;
+    const T initial_max = max;
+    auto vmin = Splat<T, Bytes>(min);
+    auto vmax = Splat<T, Bytes>(max);
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        const auto v = Load<T, Bytes>(data + i);
+        vmin = v < vmin ? v : vmin;
+        vmax = vmax < v ? v : vmax;
+    }
+    for (size_t lane = 0; lane != LANES; ++lane) {
+        min = vmin[lane] < min ? vmin[lane] : min;
+        max = max < vmax[lane] ? vmax[lane] : max;
+    }
+    MinMaxScalar(data + i, n - i, min, max);
+    if constexpr (std::is_floating_point_v<T>) {
+        /* Дорожки видят элементы не в порядке индексов, поэтому из равных -0.0 и 0.0 может
+           остаться не тот нуль, который оставил бы скалярный проход, — первый по порядку */
+        if (min == T(0) && initial_min != T(0)) {
+            min = data[FindImpl<T, Bytes>(data, n, T(0))];
+        }
+        if (max == T(0) && initial_max != T(0)) {
+            max = data[FindImpl<T, Bytes>(data, n, T(0))];
+        }
+    }
+}
+
+template <typename T, size_t Bytes>
+[[gnu::always_inline]] inline T SumImpl(const T* data, size_t n) noexcept {
+    using Lane = SumLane<T>;
+    constexpr size_t LANES = Bytes / sizeof(T);
+    Vec<Lane, Bytes> acc{};
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        acc += Load<Lane, Bytes>(reinterpret_cast<const Lane*>(data + i));
+    }
+    Lane sum{};
+    for (size_t lane = 0; lane != LANES; ++lane) {
+        sum += acc[lane];
+    }
+    return static_cast<T>(sum + static_cast<Lane>(SumScalar(data + i, n - i)));
+}
+
+/// Экземпляры ядер для конкретного набора инструкций
+#if defined(__x86_64__)
+#define VECTOR_SIMD_KERNELS(SUFFIX, BYTES, TARGET)                                              \
+    template <typename T>                                                                       \
+    [[gnu::target(TARGET)]] size_t Find##SUFFIX(const T* data, size_t n, T value) noexcept {    \
+        return FindImpl<T, BYTES>(data, n, value);                                              \
+    }                                                                                           \
+    template <typename T>                                                                       \
+    [[gnu::target(TARGET)]] size_t Count##SUFFIX(const T* data, size_t n, T value) noexcept {   \
+        return CountImpl<T, BYTES>(data, n, value);                                             \
+    }                                                                                           \
+    template <typename T>                                                                       \
+    [[gnu::target(TARGET)]] bool Equal##SUFFIX(const T* lhs, const T* rhs, size_t n) noexcept { \
+        return EqualImpl<T, BYTES>(lhs, rhs, n);                                                \
+    }                                                                                           \
+    template <typename T>                                                                       \
+    [[gnu::target(TARGET)]] void MinMax##SUFFIX(const T* data, size_t n, T& min, T& max) noexcept { \
+        MinMaxImpl<T, BYTES>(data, n, min, max);                                                \
+    }                                                                                           \
+    template <typename T>                                                                       \
+    [[gnu::target(TARGET)]] T Sum##SUFFIX(const T* data, size_t n) noexcept {                   \
+        return SumImpl<T, BYTES>(data, n);                                                      \
+    }
+
+VECTOR_SIMD_KERNELS(Avx512, 64, "avx512f,avx512bw")
+VECTOR_SIMD_KERNELS(Avx2, 32, "avx2")
+
+#undef VECTOR_SIMD_KERNELS
+#endif
+
+#pragma GCC diagnostic pop
+
+/// Выбирает экземпляр ядра по текущему набору инструкций
+#if defined(__x86_64__)
+#define VECTOR_SIMD_DISPATCH(KERNEL, ...)                        \
+    switch (Level().load(std::memory_order_relaxed)) {           \
+        case simd::SimdLevel::AVX512:                            \
+            return KERNEL##Avx512(__VA_ARGS__);                  \
+        case simd::SimdLevel::AVX2:                              \
+            return KERNEL##Avx2(__VA_ARGS__);                    \
+        case simd::SimdLevel::VECTOR_128:                        \
+            return KERNEL##Impl<T, 16>(__VA_ARGS__);             \
+        case simd::SimdLevel::SCALAR:                            \
+            break;                                               \
+    }                                                            \
+    return KERNEL##Scalar(__VA_ARGS__)
+#else
+#define VECTOR_SIMD_DISPATCH(KERNEL, ...)                        \
+    if (Level().load(std::memory_order_relaxed) != simd::SimdLevel::SCALAR) { \
+        return KERNEL##Impl<T, 16>(__VA_ARGS__);                 \
+    }                                                            \
+    return KERNEL##Scalar(__VA_ARGS__)
+#endif
+
+#else
+
+#define VECTOR_SIMD_DISPATCH(KERNEL, ...) return KERNEL##Scalar(__VA_ARGS__)
+
+#endif
+
+template <typename T>
+size_t Find(const T* data, size_t n, T value) noexcept {
+    VECTOR_SIMD_DISPATCH(Find, data, n, value);
+}
+
+template <typename T>
+size_t Count(const T* data, size_t n, T value) noexcept {
+    VECTOR_SIMD_DISPATCH(Count, data, n, value);
+}
+
+template <typename T>
+bool Equal(const T* lhs, const T* rhs, size_t n) noexcept {
+    VECTOR_SIMD_DISPATCH(Equal, lhs, rhs, n);
+}
+
+template <typename T>
+void MinMax(const T* data, size_t n, T& min, T& max) noexcept {
+    VECTOR_SIMD_DISPATCH(MinMax, data, n, min, max);
+}
+
+template <typename T>
+T Sum(const T* data, size_t n) noexcept {
+    VECTOR_SIMD_DISPATCH(Sum, data, n);
+}
+
+#undef VECTOR_SIMD_DISPATCH
+
+template <typename Range>
+concept ArithmeticRange = std::ranges::contiguous_range<Range> && std::ranges::sized_range<Range>
+                          && std::is_arithmetic_v<std::ranges::range_value_t<Range>>
+                          && !std::is_same_v<std::ranges::range_value_t<Range>, bool>;
+
+}  // namespace simd_detail
+
+namespace simd {
+
+inline SimdLevel GetSimdLevel() noexcept {
+    return simd_detail::Level().load(std::memory_order_relaxed);
+}
+
+/// Ограничивает набор инструкций, например для сравнения вариантов ядер.
+/// Уровень выше поддерживаемого процессором понижается до поддерживаемого
+inline void SetSimdLevel(SimdLevel level) noexcept {
+    simd_detail::Level().store(std::min(level, simd_detail::DetectSimdLevel()), std::memory_order_relaxed);
+}
+
+/// Индекс первого элемента, равного value, или размер диапазона, если такого нет.
+/// Для однобайтовых типов используется memchr
+template <simd_detail::ArithmeticRange Range>
+size_t Find(const Range& range, std::ranges::range_value_t<Range> value) noexcept {
+    using T = std::ranges::range_value_t<Range>;
+    const T* data = std::ranges::data(range);
+    const size_t n = std::ranges::size(range);
+    if constexpr (sizeof(T) == 1) {
+        const void* found = n != 0 ? std::memchr(data, static_cast<unsigned char>(value), n) : nullptr;
+        return found != nullptr ? static_cast<const T*>(found) - data : n;
+    } else {
+        return simd_detail::Find(data, n, value);
+    }
+}
+
+/// Количество элементов, равных value
+template <simd_detail::ArithmeticRange Range>
+size_t Count(const Range& range, std::ranges::range_value_t<Range> value) noexcept {
+    return simd_detail::Count(std::ranges::data(range), std::ranges::size(range), value);
+}
+
+/// Поэлементное сравнение операцией ==; как и для скаляров, NaN не равен ничему, а -0.0 == 0.0
+template <simd_detail::ArithmeticRange Lhs, simd_detail::ArithmeticRange Rhs>
+    requires std::is_same_v<std::ranges::range_value_t<Lhs>, std::ranges::range_value_t<Rhs>>
+bool Equal(const Lhs& lhs, const Rhs& rhs) noexcept {
+    const size_t n = std::ranges::size(lhs);
+    return n == std::ranges::size(rhs) && simd_detail::Equal(std::ranges::data(lhs), std::ranges::data(rhs), n);
+}
+
+/// Наименьший и наибольший элементы непустого диапазона.
+/// Сравнение операцией <, поэтому NaN учитывается, только если стоит первым,
+/// а из равных элементов (-0.0 и 0.0) возвращается первый, как при скалярном проходе
+template <simd_detail::ArithmeticRange Range>
+std::pair<std::ranges::range_value_t<Range>, std::ranges::range_value_t<Range>> MinMax(const Range& range) noexcept {
+    const auto* data = std::ranges::data(range);
+    const size_t n = std::ranges::size(range);
+    assert(n != 0);
+    std::pair result{data[0], data[0]};
+    simd_detail::MinMax(data + 1, n - 1, result.first, result.second);
+    return result;
+}
+
+/// Сумма элементов. Целые складываются по модулю 2^N, как беззнаковые того же размера.
+/// Числа с плавающей точкой складываются в нескольких дорожках параллельно,
+/// поэтому результат может отличаться от последовательного сложения в последних битах
+template <simd_detail::ArithmeticRange Range>
+std::ranges::range_value_t<Range> Sum(const Range& range) noexcept {
+    return simd_detail::Sum(std::ranges::data(range), std::ranges::size(range));
+}
+
+/// Заполняет диапазон значением value. Цикл без раннего выхода компилятор векторизует сам,
+/// а однобайтовые типы заполняются через memset
+template <simd_detail::ArithmeticRange Range>
+void Fill(Range& range, std::ranges::range_value_t<Range> value) noexcept {
+    using T = std::ranges::range_value_t<Range>;
+    T* data = std::ranges::data(range);
+    const size_t n = std::ranges::size(range);
+    if constexpr (sizeof(T) == 1) {
+        if (n != 0) {
+            std::memset(data, static_cast<unsigned char>(value), n);
+        }
+    } else {
+        std::fill_n(data, n, value);
+    }
+}
+
+}  // namespace simd
@@ -0,0 +1,458 @@
+#pragma once
+#include "vector.h"
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+
+/// Вектор с внутренним буфером на N элементов.
+/// Пока элементов не больше N, они хранятся прямо в объекте и память из кучи не выделяется.
+/// При переполнении элементы переносятся в RawMemory, выделенную аллокатором Alloc,
+/// вместимость которой определяет политика роста Growth.
+/// В отличие от Vector, перемещение вектора во внутреннем буфере перемещает элементы поштучно
+template <typename T, size_t N, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth>
+class SmallVector {
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    static_assert(N > 0, "use Vector for vectors without inline storage");
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+    using allocator_type = Alloc;
+
+    /// Конструктор по умолчанию.
+    /// Создаёт пустой вектор вместимостью N без выделения памяти
+    SmallVector() = default;
+
+    explicit SmallVector(const Alloc& alloc) noexcept;
+
+    /// Создаёт вектор заданного размера, элементы проинициализированы значением по умолчанию.
+    /// Память в куче выделяется, только если size больше N
+    explicit SmallVector(size_t size, const Alloc& alloc = Alloc());
+
+    SmallVector(const SmallVector& other);
+
+    SmallVector(const SmallVector& other, const Alloc& alloc);
+
+    SmallVector& operator=(const SmallVector& rhs);
+
+    /// Забирает память other из кучи, а элементы внутреннего буфера перемещает поштучно
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    SmallVector& operator=(SmallVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>
+                                                       && std::is_nothrow_move_assignable_v<T>);
+
+    ~SmallVector();
+
+    iterator begin() noexcept;
+    iterator end() noexcept;
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args);
+    iterator Erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>);
+    iterator Insert(const_iterator pos, const T& value);
+    iterator Insert(const_iterator pos, T&& value);
+
+    [[nodiscard]] size_t Size() const noexcept;
+    [[nodiscard]] size_t Capacity() const noexcept;
+    const T& operator[](size_t index) const noexcept;
+    T& operator[](size_t index) noexcept;
+    /// Резервирует достаточно места, чтобы вместить количество capacity.
+    /// Пока capacity не больше N, ничего не делает
+    void Reserve(size_t new_capacity);
+    /// выполняющий обмен содержимого вектора с другим вектором.
+    /// Как и у Vector::Swap, аллокаторы должны быть равны, если propagate_on_container_swap не задан
+    void Swap(SmallVector& other) noexcept(NOTHROW_SWAP);
+    void Resize(size_t new_size);
+
+    template <typename Type>
+    void PushBack(Type&& value);
+
+    void PopBack() noexcept;
+    [[nodiscard]] bool IsEmpty() const noexcept;
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args);
+
+    /// Хранятся ли элементы во внутреннем буфере
+    [[nodiscard]] bool IsInline() const noexcept;
+
+    [[nodiscard]] Alloc GetAllocator() const noexcept;
+
+private:
+    /// Память в куче; пока она не выделена, элементы лежат в inline_
+    RawMemory<T, Alloc> heap_;
+    size_t size_ = 0;
+    alignas(T) std::byte inline_[N * sizeof(T)];
+
+    /// переносить элементы при росте перемещением, даже если оно может выбросить исключение
+    static constexpr bool RELOCATE_BY_MOVE = relocates_by_move_v<T, Growth>;
+
+    /// обмен через перемещающие присваивания не выделяет память, если аллокаторы равны
+    /// или передаются вместе с буфером; иначе элементы переносятся в новый буфер
+    static constexpr bool NOTHROW_SWAP = std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>
+                                         && (!AllocTraits::propagate_on_container_swap::value
+                                             || AllocTraits::propagate_on_container_move_assignment::value
+                                             || AllocTraits::is_always_equal::value);
+
+    T* Data() noexcept;
+    const T* Data() const noexcept;
+
+    /// вместимость для required элементов при росте по политике Growth
+    [[nodiscard]] size_t NextCapacity(size_t required) const noexcept;
+
+    /// вставка элемента в этот же вектор, когда вместимость достаточна
+    template <typename... Args>
+    void EmplaceShift(size_t index, Args&&... args);
+
+    /// переносит элементы в кучу при полностью заполненном векторе
+    template <typename... Args>
+    void EmplaceReallocate(size_t index, Args&&... args);
+
+    /// заменяет элементы вектора count элементами, начиная с first
+    template <typename RandomIt>
+    void AssignN(RandomIt first, size_t count);
+
+    /// перемещает элементы other в собственный внутренний буфер
+    void MoveInline(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+}; // class SmallVector
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+SmallVector<T, N, Alloc, Growth>::SmallVector(const Alloc& alloc) noexcept
+        : heap_(alloc)  //
+{
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+SmallVector<T, N, Alloc, Growth>::SmallVector(size_t size, const Alloc& alloc)
+        : heap_(size > N ? Growth::Fit(size, sizeof(T)) : 0, alloc)  //
+{
+    std::uninitialized_value_construct_n(Data(), size);
+    size_ = size;
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+SmallVector<T, N, Alloc, Growth>::SmallVector(const SmallVector& other):
+    SmallVector(other, AllocTraits::select_on_container_copy_construction(other.heap_.GetAllocator())) {
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+SmallVector<T, N, Alloc, Growth>::SmallVector(const SmallVector& other, const Alloc& alloc):
+    heap_(other.size_ > N ? Growth::Fit(other.size_, sizeof(T)) : 0, alloc) {
+    std::uninitialized_copy_n(other.Data(), other.size_, Data());
+    size_ = other.size_;
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+SmallVector<T, N, Alloc, Growth>& SmallVector<T, N, Alloc, Growth>::operator=(const SmallVector& rhs) {
+    if (this != &rhs) {
+        if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+            if (heap_.GetAllocator() != rhs.heap_.GetAllocator()) {
+                /* Память из кучи возвращается старому аллокатору до того, как принять новый */
+                std::destroy_n(Data(), size_);
+                size_ = 0;
+                heap_ = RawMemory<T, Alloc>(rhs.heap_.GetAllocator());
+            }
+        }
+        AssignN(rhs.Data(), rhs.size_);
+    }
+    return *this;
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+SmallVector<T, N, Alloc, Growth>::SmallVector(SmallVector&& other)
+        noexcept(std::is_nothrow_move_constructible_v<T>)
+        : heap_(std::move(other.heap_))  //
+{
+    if (heap_.GetAddress() != nullptr) {
+        size_ = std::exchange(other.size_, 0);
+    } else {
+        MoveInline(other);
+    }
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+SmallVector<T, N, Alloc, Growth>& SmallVector<T, N, Alloc, Growth>::operator=(SmallVector&& rhs)
+        noexcept(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>) {
+    if (this != &rhs) {
+        bool can_take_heap = rhs.heap_.GetAddress() != nullptr;
+        if constexpr (!AllocTraits::propagate_on_container_move_assignment::value
+                      && !AllocTraits::is_always_equal::value) {
+            can_take_heap = can_take_heap && heap_.GetAllocator() == rhs.heap_.GetAllocator();
+        }
+        if (can_take_heap) {
+            std::destroy_n(Data(), size_);
+            size_ = 0;
+            heap_ = std::move(rhs.heap_);
+            std::swap(size_, rhs.size_);
+        } else {
+            /* Элементы во внутреннем буфере или в чужой памяти перемещаются по одному */
+            AssignN(std::make_move_iterator(rhs.begin()), rhs.size_);
+        }
+    }
+    return *this;
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+SmallVector<T, N, Alloc, Growth>::~SmallVector() {
+    if (!IsInline()) {
+        RecordDestruction<T>(heap_.Capacity() - size_);
+    }
+    std::destroy_n(Data(), size_);
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+typename SmallVector<T, N, Alloc, Growth>::iterator SmallVector<T, N, Alloc, Growth>::begin() noexcept {
+    return Data();
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+typename SmallVector<T, N, Alloc, Growth>::iterator SmallVector<T, N, Alloc, Growth>::end() noexcept {
+    return Data() + size_;
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+typename SmallVector<T, N, Alloc, Growth>::const_iterator SmallVector<T, N, Alloc, Growth>::begin() const noexcept {
+    return Data();
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+typename SmallVector<T, N, Alloc, Growth>::const_iterator SmallVector<T, N, Alloc, Growth>::end() const noexcept {
+    return Data() + size_;
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+typename SmallVector<T, N, Alloc, Growth>::const_iterator SmallVector<T, N, Alloc, Growth>::cbegin() const noexcept {
+    return begin();
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+typename SmallVector<T, N, Alloc, Growth>::const_iterator SmallVector<T, N, Alloc, Growth>::cend() const noexcept {
+    return end();
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+template <typename... Args>
+typename SmallVector<T, N, Alloc, Growth>::iterator SmallVector<T, N, Alloc, Growth>::Emplace(const_iterator pos, Args&&... args) {
+    size_t index = pos - begin();
+
+    if (size_ < Capacity()) {
+        if (index == size_) {
+            EmplaceBack(std::forward<Args>(args)...);
+        } else {
+            EmplaceShift(index, std::forward<Args>(args)...);
+        }
+    } else {
+        EmplaceReallocate(index, std::forward<Args>(args)...);
+    }
+    return begin() + index;
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+typename SmallVector<T, N, Alloc, Growth>::iterator SmallVector<T, N, Alloc, Growth>::Insert(const_iterator pos, const T& value) {
+    return Emplace(pos, value);
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+typename SmallVector<T, N, Alloc, Growth>::iterator SmallVector<T, N, Alloc, Growth>::Insert(const_iterator pos, T&& value) {
+    return Emplace(pos, std::move(value));
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+typename SmallVector<T, N, Alloc, Growth>::iterator SmallVector<T, N, Alloc, Growth>::Erase(const_iterator pos)
+        noexcept(std::is_nothrow_move_assignable_v<T>) {
+    assert(pos >= begin() && pos < end());
+    size_t index = pos - begin();
+    std::move(begin() + index + 1, end(), begin() + index);
+    PopBack();
+    return begin() + index;
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+size_t SmallVector<T, N, Alloc, Growth>::Size() const noexcept {
+    return size_;
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+size_t SmallVector<T, N, Alloc, Growth>::Capacity() const noexcept {
+    return heap_.GetAddress() != nullptr ? heap_.Capacity() : N;
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+const T& SmallVector<T, N, Alloc, Growth>::operator[](size_t index) const noexcept {
+    return const_cast<SmallVector&>(*this)[index];
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+T& SmallVector<T, N, Alloc, Growth>::operator[](size_t index) noexcept {
+    assert(index < size_);
+    return Data()[index];
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+void SmallVector<T, N, Alloc, Growth>::Reserve(size_t new_capacity) {
+    if (new_capacity <= Capacity()) {
+        return;
+    }
+    RawMemory<T, Alloc> new_data(Growth::Fit(new_capacity, sizeof(T)), heap_.GetAllocator());
+    RelocateElements<T, RELOCATE_BY_MOVE>(Data(), size_, new_data.GetAddress(), size_);
+    heap_.Swap(new_data);
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+void SmallVector<T, N, Alloc, Growth>::Swap(SmallVector& other) noexcept(NOTHROW_SWAP) {
+    if constexpr (!AllocTraits::propagate_on_container_swap::value) {
+        assert(heap_.GetAllocator() == other.heap_.GetAllocator());
+    }
+    if (heap_.GetAddress() != nullptr && other.heap_.GetAddress() != nullptr) {
+        heap_.Swap(other.heap_);
+        std::swap(size_, other.size_);
+    } else {
+        /// хотя бы один из векторов хранит элементы во внутреннем буфере
+        SmallVector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+void SmallVector<T, N, Alloc, Growth>::Resize(size_t new_size) {
+    if (new_size < size_) {
+        std::destroy_n(Data() + new_size, size_ - new_size);
+    } else if (new_size > size_) {
+        Reserve(new_size);
+        std::uninitialized_value_construct_n(Data() + size_, new_size - size_);
+    }
+    size_ = new_size;
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+template<typename Type>
+void SmallVector<T, N, Alloc, Growth>::PushBack(Type&& value) {
+    EmplaceBack(std::forward<Type>(value));
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+void SmallVector<T, N, Alloc, Growth>::PopBack() noexcept {
+    assert(!IsEmpty());
+    std::destroy_at(Data() + size_ - 1);
+    --size_;
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+bool SmallVector<T, N, Alloc, Growth>::IsEmpty() const noexcept {
+    return size_ == 0;
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+template<typename ...Args>
+T& SmallVector<T, N, Alloc, Growth>::EmplaceBack(Args&&... args) {
+    if (size_ == Capacity()) {
+        RawMemory<T, Alloc> new_data(NextCapacity(size_ + 1), heap_.GetAllocator());
+        new (new_data + size_) T(std::forward<Args>(args)...);
+
+        try {
+            RelocateElements<T, RELOCATE_BY_MOVE>(Data(), size_, new_data.GetAddress(), size_);
+        } catch (...) {
+            std::destroy_at(new_data + size_);
+            throw;
+        }
+        heap_.Swap(new_data);
+    } else {
+        new (Data() + size_) T(std::forward<Args>(args)...);
+    }
+
+    ++size_;
+    return Data()[size_ - 1];
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+bool SmallVector<T, N, Alloc, Growth>::IsInline() const noexcept {
+    return heap_.GetAddress() == nullptr;
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+Alloc SmallVector<T, N, Alloc, Growth>::GetAllocator() const noexcept {
+    return heap_.GetAllocator();
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+T* SmallVector<T, N, Alloc, Growth>::Data() noexcept {
+    return heap_.GetAddress() != nullptr ? heap_.GetAddress() : std::launder(reinterpret_cast<T*>(inline_));
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+const T* SmallVector<T, N, Alloc, Growth>::Data() const noexcept {
+    return const_cast<SmallVector&>(*this).Data();
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+size_t SmallVector<T, N, Alloc, Growth>::NextCapacity(size_t required) const noexcept {
+    return Growth::Grow(Capacity(), required, sizeof(T));
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+template<typename ...Args>
+void SmallVector<T, N, Alloc, Growth>::EmplaceShift(size_t index, Args&&... args) {
+    T* data = Data();
+    /// Создаем временный объект, чтобы избежать перезаписи при вставке из этого же вектора
+    T temp_value(std::forward<Args>(args)...);
+    new (data + size_) T(std::move(data[size_ - 1]));
+    std::move_backward(data + index, data + size_ - 1, data + size_);
+    data[index] = std::move(temp_value);
+    ++size_;
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+template<typename ...Args>
+void SmallVector<T, N, Alloc, Growth>::EmplaceReallocate(size_t index, Args&&... args) {
+    RawMemory<T, Alloc> new_data(NextCapacity(size_ + 1), heap_.GetAllocator());
+
+    new (new_data + index) T(std::forward<Args>(args)...);
+
+    try {
+        RelocateElements<T, RELOCATE_BY_MOVE>(Data(), size_, new_data.GetAddress(), index, 1);
+    } catch (...) {
+        std::destroy_at(new_data + index);
+        throw;
+    }
+
+    heap_.Swap(new_data);
+    ++size_;
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+template<typename RandomIt>
+void SmallVector<T, N, Alloc, Growth>::AssignN(RandomIt first, size_t count) {
+    if (count > Capacity()) {
+        RawMemory<T, Alloc> new_data(Growth::Fit(count, sizeof(T)), heap_.GetAllocator());
+        std::uninitialized_copy_n(first, count, new_data.GetAddress());
+        std::destroy_n(Data(), size_);
+        heap_.Swap(new_data);
+    } else if (count < size_) {
+        std::copy_n(first, count, Data());
+        std::destroy_n(Data() + count, size_ - count);
+    } else {
+        std::copy_n(first, size_, Data());
+        std::uninitialized_copy_n(first + size_, count - size_, Data() + size_);
+    }
+    size_ = count;
+}
+
+template<typename T, size_t N, typename Alloc, typename Growth>
+void SmallVector<T, N, Alloc, Growth>::MoveInline(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    assert(IsInline() && IsEmpty() && other.IsInline());
+    std::uninitialized_move_n(other.Data(), other.size_, Data());
+    std::destroy_n(other.Data(), other.size_);
+    size_ = std::exchange(other.size_, 0);
+}
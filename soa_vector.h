@@ -0,0 +1,366 @@
+#pragma once
+#include "vector.h"
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+/// Вектор записей, поля которых хранятся в отдельных массивах (structure of arrays):
+/// столбец I — RawMemory<Ts...[I]>. Все столбцы имеют общий размер и общую вместимость,
+/// которую определяет политика роста Growth. Проход по одному полю читает только его массив
+/// и не тратит пропускную способность памяти на остальные поля.
+/// Строка доступна через operator[] как кортеж ссылок на поля, столбец — через Column<I>()
+template <typename Growth, typename... Ts>
+class BasicSoAVector {
+    static_assert(sizeof...(Ts) > 0, "SoAVector needs at least one column");
+    /// столбец без копирования переносится перемещением, и исключение при переносе
+    /// оставило бы часть строк в старых буферах, часть — в новых
+    static_assert(((std::is_copy_constructible_v<Ts> || std::is_nothrow_move_constructible_v<Ts>
+                    || is_trivially_relocatable_v<Ts>) && ...),
+                  "SoAVector columns must be copy constructible or nothrow move constructible");
+
+    using Columns = std::tuple<RawMemory<Ts>...>;
+    using Indices = std::index_sequence_for<Ts...>;
+
+    template <size_t I>
+    using Field = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+public:
+    /// Прокси-ссылка на строку: присваивание кортежа значений записывает поля,
+    /// а std::get и структурное связывание дают ссылки на отдельные поля
+    using reference = std::tuple<Ts&...>;
+    using const_reference = std::tuple<const Ts&...>;
+    using value_type = std::tuple<Ts...>;
+
+    BasicSoAVector() = default;
+
+    /// Создаёт size строк, поля которых проинициализированы значением по умолчанию
+    explicit BasicSoAVector(size_t size);
+
+    BasicSoAVector(const BasicSoAVector& other);
+    BasicSoAVector& operator=(const BasicSoAVector& rhs);
+    BasicSoAVector(BasicSoAVector&& other) noexcept;
+    BasicSoAVector& operator=(BasicSoAVector&& rhs) noexcept;
+
+    ~BasicSoAVector();
+
+    [[nodiscard]] size_t Size() const noexcept;
+    [[nodiscard]] size_t Capacity() const noexcept;
+    [[nodiscard]] bool IsEmpty() const noexcept;
+
+    reference operator[](size_t index) noexcept;
+    const_reference operator[](size_t index) const noexcept;
+
+    /// Элементы столбца I; указатель действителен до реаллокации
+    template <size_t I>
+    std::span<Field<I>> Column() noexcept;
+    template <size_t I>
+    std::span<const Field<I>> Column() const noexcept;
+
+    /// Добавляет строку, создавая поле I из args...[I].
+    /// Если создание поля или перенос столбцов выбрасывает исключение, вектор не меняется
+    template <typename... Args>
+        requires(sizeof...(Args) == sizeof...(Ts))
+    reference EmplaceBack(Args&&... args);
+
+    void PushBack(const value_type& row);
+    void PushBack(value_type&& row);
+
+    void PopBack() noexcept;
+
+    /// Резервирует место под new_capacity строк во всех столбцах сразу.
+    /// Итоговую вместимость определяет Growth::Fit
+    void Reserve(size_t new_capacity);
+    void ShrinkToFit();
+    void Resize(size_t new_size);
+    void Swap(BasicSoAVector& other) noexcept;
+
+private:
+    Columns columns_;
+    size_t size_ = 0;
+
+    /// можно ли перенести элементы столбца без риска исключения
+    template <typename T>
+    static constexpr bool NOTHROW_RELOCATE = is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>;
+
+    /// размер элемента для политики роста — размер строки целиком
+    static constexpr size_t ROW_SIZE = (sizeof(Ts) + ...);
+
+    /// переносит столбцы в буферы вместимостью new_capacity. Если make не nullptr,
+    /// до переноса в позиции size_ новых буферов создаётся строка (см. ConstructRow)
+    template <typename Make>
+    void Reallocate(size_t new_capacity, Make&& make);
+
+    /// выполняет op(column, I) для каждого столбца
+    template <typename Op, size_t... I>
+    static void ForEachColumn(Columns& columns, Op&& op, std::index_sequence<I...>);
+
+    /// уничтожает поля строк [first, last) во всех столбцах
+    void DestroyRows(size_t first, size_t last) noexcept;
+
+    /// создаёт поля index-й строки в columns, вызывая make(index_constant<I>, Field<I>* place).
+    /// Если создание поля выбрасывает исключение, уже созданные поля строки уничтожаются
+    template <typename Make>
+    static void ConstructRow(Columns& columns, size_t index, Make&& make);
+
+}; // class BasicSoAVector
+
+/// Вектор столбцов Ts... с удвоением вместимости
+template <typename... Ts>
+using SoAVector = BasicSoAVector<DoublingGrowth, Ts...>;
+
+template<typename Growth, typename... Ts>
+BasicSoAVector<Growth, Ts...>::BasicSoAVector(size_t size) {
+    /// деструктор не вызывается для недостроенного объекта: уже созданные строки уничтожаются здесь
+    try {
+        Resize(size);
+    } catch (...) {
+        DestroyRows(0, size_);
+        throw;
+    }
+}
+
+template<typename Growth, typename... Ts>
+BasicSoAVector<Growth, Ts...>::BasicSoAVector(const BasicSoAVector& other) {
+    Reserve(other.size_);
+    try {
+        for (size_t i = 0; i != other.size_; ++i) {
+            ConstructRow(columns_, i, [&other, i]<size_t I>(std::integral_constant<size_t, I>, Field<I>* place) {
+                new (place) Field<I>(std::get<I>(other.columns_)[i]);
+            });
+            ++size_;
+        }
+    } catch (...) {
+        DestroyRows(0, size_);
+        throw;
+    }
+}
+
+template<typename Growth, typename... Ts>
+BasicSoAVector<Growth, Ts...>& BasicSoAVector<Growth, Ts...>::operator=(const BasicSoAVector& rhs) {
+    if (this != &rhs) {
+        BasicSoAVector rhs_copy(rhs);
+        Swap(rhs_copy);
+    }
+    return *this;
+}
+
+template<typename Growth, typename... Ts>
+BasicSoAVector<Growth, Ts...>::BasicSoAVector(BasicSoAVector&& other) noexcept
+        : columns_(std::move(other.columns_))
+        , size_(std::exchange(other.size_, 0))  //
+{
+}
+
+template<typename Growth, typename... Ts>
+BasicSoAVector<Growth, Ts...>& BasicSoAVector<Growth, Ts...>::operator=(BasicSoAVector&& rhs) noexcept {
+    if (this != &rhs) {
+        DestroyRows(0, size_);
+        columns_ = std::move(rhs.columns_);
+        size_ = std::exchange(rhs.size_, 0);
+    }
+    return *this;
+}
+
+template<typename Growth, typename... Ts>
+BasicSoAVector<Growth, Ts...>::~BasicSoAVector() {
+    DestroyRows(0, size_);
+}
+
+template<typename Growth, typename... Ts>
+size_t BasicSoAVector<Growth, Ts...>::Size() const noexcept {
+    return size_;
+}
+
+template<typename Growth, typename... Ts>
+size_t BasicSoAVector<Growth, Ts...>::Capacity() const noexcept {
+    return std::get<0>(columns_).Capacity();
+}
+
+template<typename Growth, typename... Ts>
+bool BasicSoAVector<Growth, Ts...>::IsEmpty() const noexcept {
+    return size_ == 0;
+}
+
+template<typename Growth, typename... Ts>
+typename BasicSoAVector<Growth, Ts...>::reference BasicSoAVector<Growth, Ts...>::operator[](size_t index) noexcept {
+    assert(index < size_);
+    return std::apply([index](auto&... column) {
+        return reference(column[index]...);
+    }, columns_);
+}
+
+template<typename Growth, typename... Ts>
+typename BasicSoAVector<Growth, Ts...>::const_reference BasicSoAVector<Growth, Ts...>::operator[](size_t index) const noexcept {
+    assert(index < size_);
+    return std::apply([index](const auto&... column) {
+        return const_reference(column[index]...);
+    }, columns_);
+}
+
+template<typename Growth, typename... Ts>
+template<size_t I>
+std::span<typename BasicSoAVector<Growth, Ts...>::template Field<I>> BasicSoAVector<Growth, Ts...>::Column() noexcept {
+    return {std::get<I>(columns_).GetAddress(), size_};
+}
+
+template<typename Growth, typename... Ts>
+template<size_t I>
+std::span<const typename BasicSoAVector<Growth, Ts...>::template Field<I>> BasicSoAVector<Growth, Ts...>::Column() const noexcept {
+    return {std::get<I>(columns_).GetAddress(), size_};
+}
+
+template<typename Growth, typename... Ts>
+template<typename... Args>
+    requires(sizeof...(Args) == sizeof...(Ts))
+typename BasicSoAVector<Growth, Ts...>::reference BasicSoAVector<Growth, Ts...>::EmplaceBack(Args&&... args) {
+    auto make = [&args...]<size_t I>(std::integral_constant<size_t, I>, Field<I>* place) {
+        new (place) Field<I>(std::get<I>(std::forward_as_tuple(std::forward<Args>(args)...)));
+    };
+    if (size_ == Capacity()) {
+        /// поля новой строки создаются до переноса, так как аргументы могут ссылаться на строки вектора
+        Reallocate(Growth::Grow(Capacity(), size_ + 1, ROW_SIZE), make);
+    } else {
+        ConstructRow(columns_, size_, make);
+    }
+    ++size_;
+    return (*this)[size_ - 1];
+}
+
+template<typename Growth, typename... Ts>
+void BasicSoAVector<Growth, Ts...>::PushBack(const value_type& row) {
+    std::apply([this](const Ts&... fields) {
+        EmplaceBack(fields...);
+    }, row);
+}
+
+template<typename Growth, typename... Ts>
+void BasicSoAVector<Growth, Ts...>::PushBack(value_type&& row) {
+    std::apply([this](Ts&... fields) {
+        EmplaceBack(std::move(fields)...);
+    }, row);
+}
+
+template<typename Growth, typename... Ts>
+void BasicSoAVector<Growth, Ts...>::PopBack() noexcept {
+    assert(size_ > 0);
+    DestroyRows(size_ - 1, size_);
+    --size_;
+}
+
+template<typename Growth, typename... Ts>
+void BasicSoAVector<Growth, Ts...>::Reserve(size_t new_capacity) {
+    if (new_capacity <= Capacity()) {
+        return;
+    }
+    Reallocate(Growth::Fit(new_capacity, ROW_SIZE), nullptr);
+}
+
+template<typename Growth, typename... Ts>
+void BasicSoAVector<Growth, Ts...>::ShrinkToFit() {
+    if (size_ < Capacity()) {
+        Reallocate(size_ == 0 ? 0 : Growth::Fit(size_, ROW_SIZE), nullptr);
+    }
+}
+
+template<typename Growth, typename... Ts>
+void BasicSoAVector<Growth, Ts...>::Resize(size_t new_size) {
+    if (new_size < size_) {
+        DestroyRows(new_size, size_);
+        size_ = new_size;
+        return;
+    }
+    Reserve(new_size);
+    while (size_ < new_size) {
+        ConstructRow(columns_, size_, []<size_t I>(std::integral_constant<size_t, I>, Field<I>* place) {
+            new (place) Field<I>();
+        });
+        ++size_;
+    }
+}
+
+template<typename Growth, typename... Ts>
+void BasicSoAVector<Growth, Ts...>::Swap(BasicSoAVector& other) noexcept {
+    ForEachColumn(columns_, [&other]<size_t I>(auto& column, std::integral_constant<size_t, I>) {
+        column.Swap(std::get<I>(other.columns_));
+    }, Indices{});
+    std::swap(size_, other.size_);
+}
+
+template<typename Growth, typename... Ts>
+template<typename Make>
+void BasicSoAVector<Growth, Ts...>::Reallocate(size_t new_capacity, Make&& make) {
+    assert(new_capacity >= size_ + (std::is_null_pointer_v<std::decay_t<Make>> ? 0 : 1));
+    Columns new_columns{RawMemory<Ts>(new_capacity)...};
+    if constexpr (!std::is_null_pointer_v<std::decay_t<Make>>) {
+        ConstructRow(new_columns, size_, make);
+    }
+    /* Столбцы, перенос которых может выбросить исключение, сначала копируются без разрушения
+       исходных элементов; при неудаче уничтожаются уже созданные копии и вектор не меняется.
+       Остальные столбцы тривиально переносимы или перемещаются без исключений (см. static_assert
+       в начале класса) и переносятся после этого */
+    size_t copied = 0;
+    try {
+        ForEachColumn(columns_, [&]<size_t I>(auto& column, std::integral_constant<size_t, I>) {
+            if constexpr (!NOTHROW_RELOCATE<Field<I>>) {
+                BulkCopyConstruct(column.GetAddress(), size_, std::get<I>(new_columns).GetAddress());
+                copied |= size_t{1} << I;
+            }
+        }, Indices{});
+    } catch (...) {
+        ForEachColumn(new_columns, [&]<size_t I>(auto& column, std::integral_constant<size_t, I>) {
+            if (copied & (size_t{1} << I)) {
+                BulkDestroy(column.GetAddress(), size_);
+            }
+            if constexpr (!std::is_null_pointer_v<std::decay_t<Make>>) {
+                std::destroy_at(column + size_);
+            }
+        }, Indices{});
+        throw;
+    }
+    ForEachColumn(columns_, [&]<size_t I>(auto& column, std::integral_constant<size_t, I>) {
+        if constexpr (NOTHROW_RELOCATE<Field<I>>) {
+            RelocateElements(column.GetAddress(), size_, std::get<I>(new_columns).GetAddress(), size_);
+        } else {
+            BulkDestroy(column.GetAddress(), size_);
+        }
+        column.Swap(std::get<I>(new_columns));
+    }, Indices{});
+}
+
+template<typename Growth, typename... Ts>
+template<typename Op, size_t... I>
+void BasicSoAVector<Growth, Ts...>::ForEachColumn(Columns& columns, Op&& op, std::index_sequence<I...>) {
+    (op(std::get<I>(columns), std::integral_constant<size_t, I>{}), ...);
+}
+
+template<typename Growth, typename... Ts>
+void BasicSoAVector<Growth, Ts...>::DestroyRows(size_t first, size_t last) noexcept {
+    std::apply([first, last](auto&... column) {
+        (BulkDestroy(column.GetAddress() + first, last - first), ...);
+    }, columns_);
+}
+
+template<typename Growth, typename... Ts>
+template<typename Make>
+void BasicSoAVector<Growth, Ts...>::ConstructRow(Columns& columns, size_t index, Make&& make) {
+    size_t constructed = 0;
+    try {
+        ForEachColumn(columns, [&]<size_t I>(auto& column, std::integral_constant<size_t, I> i) {
+            make(i, column + index);
+            ++constructed;
+        }, Indices{});
+    } catch (...) {
+        ForEachColumn(columns, [&]<size_t I>(auto& column, std::integral_constant<size_t, I>) {
+            if (I < constructed) {
+                std::destroy_at(column + index);
+            }
+        }, Indices{});
+        throw;
+    }
+}
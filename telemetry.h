@@ -0,0 +1,507 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <source_location>
+#include <type_traits>
+#include <vector>
+
+#if defined(VECTOR_WITH_TELEMETRY)
+#include <mutex>
+#include <typeinfo>
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+#endif
+
+#if defined(VECTOR_WITH_SITE_TRACKING)
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <new>
+#endif
+
+/// Телеметрия операций Vector, RawMemory и SmallVector, сгруппированная по типу элементов.
+/// Включается макросом VECTOR_WITH_TELEMETRY; без него функции Record* пусты
+/// и контейнеры не тратят на учёт ни памяти, ни инструкций.
+/// Показания всех типов собираются в общем реестре процесса: CollectTelemetry.
+/// Контейнеры, работающие при вычислении на этапе компиляции, не учитываются.
+///
+/// Макрос VECTOR_WITH_SITE_TRACKING дополнительно включает учёт живых Vector по месту создания
+/// (std::source_location конструктора): CollectSiteTelemetry показывает, сколько памяти
+/// простаивает в незанятой вместимости у векторов, созданных в каждой строке программы.
+/// Каждый Vector хранит запись о себе внутри объекта и после изменяющих операций добавляет
+/// изменения размера и вместимости к атомарным счётчикам места создания. Блокировок нет ни при
+/// создании и уничтожении вектора, ни при сборе показаний; векторы одного места, меняющиеся
+/// в разных потоках, делят кэш-линию его счётчиков
+
+/// Способ, которым элементы переносятся в новый буфер
+enum class RelocationKind {
+    /// побайтовое копирование тривиально перемещаемых элементов
+    BITWISE,
+    /// перемещающий конструктор (noexcept или тип без копирования)
+    MOVE,
+    /// копирующий конструктор ради строгой гарантии исключений
+    COPY,
+    /// изменение размера блока через reallocate аллокатора
+    REALLOCATE,
+};
+
+/// Снимок векторов, созданных в одном месте программы. Размеры в элементах суммируются
+/// по векторам с разными типами элементов, поэтому для сравнения мест удобнее байты
+struct SiteSnapshot {
+    const char* file_name = "";
+    const char* function_name = "";
+    uint_least32_t line = 0;
+    uint_least32_t column = 0;
+
+    /// живые векторы и их суммарные размер и вместимость
+    size_t live = 0;
+    size_t size = 0;
+    size_t capacity = 0;
+    size_t size_bytes = 0;
+    size_t capacity_bytes = 0;
+    /// незанятая вместимость (capacity - size) в байтах
+    size_t slack_bytes = 0;
+    /// смены буфера с уже созданными элементами, включая векторы, которые уже уничтожены
+    size_t reallocations = 0;
+    size_t destroyed = 0;
+};
+
+/// Снимок счётчиков для одного типа элементов
+struct TelemetrySnapshot {
+    /// имя типа элементов
+    const char* type_name = "";
+    size_t element_size = 0;
+
+    size_t allocations = 0;
+    size_t allocated_bytes = 0;
+    /// смены буфера с уже созданными элементами
+    size_t reallocations = 0;
+    size_t relocated_bitwise = 0;
+    size_t relocated_by_move = 0;
+    size_t relocated_by_copy = 0;
+    size_t relocated_by_reallocate = 0;
+    /// наибольшая вместимость одного буфера
+    size_t peak_capacity = 0;
+    /// сколько векторов уничтожено и сколько незанятых ячеек (capacity - size) осталось у них суммарно
+    size_t destroyed = 0;
+    size_t wasted_capacity = 0;
+    size_t peak_wasted_capacity = 0;
+};
+
+namespace vector_telemetry_detail {
+
+/// Счётчики одного типа элементов; регистрируются в реестре при первом обращении
+struct Counters {
+    const char* type_name;
+    size_t element_size;
+
+    std::atomic<size_t> allocations{0};
+    std::atomic<size_t> allocated_bytes{0};
+    std::atomic<size_t> reallocations{0};
+    std::atomic<size_t> relocated[4] = {};
+    std::atomic<size_t> peak_capacity{0};
+    std::atomic<size_t> destroyed{0};
+    std::atomic<size_t> wasted_capacity{0};
+    std::atomic<size_t> peak_wasted_capacity{0};
+};
+
+inline void UpdateMax(std::atomic<size_t>& peak, size_t value) noexcept {
+    size_t current = peak.load(std::memory_order_relaxed);
+    while (current < value && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+#if defined(VECTOR_WITH_TELEMETRY)
+
+class Registry {
+public:
+    static Registry& Instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    void Add(Counters* counters) {
+        std::lock_guard lock(mutex_);
+        counters_.push_back(counters);
+    }
+
+    std::vector<TelemetrySnapshot> Collect() const {
+        std::lock_guard lock(mutex_);
+        std::vector<TelemetrySnapshot> result;
+        result.reserve(counters_.size());
+        for (const Counters* c : counters_) {
+            TelemetrySnapshot snapshot;
+            snapshot.type_name = c->type_name;
+            snapshot.element_size = c->element_size;
+            snapshot.allocations = c->allocations.load(std::memory_order_relaxed);
+            snapshot.allocated_bytes = c->allocated_bytes.load(std::memory_order_relaxed);
+            snapshot.reallocations = c->reallocations.load(std::memory_order_relaxed);
+            snapshot.relocated_bitwise = c->relocated[static_cast<int>(RelocationKind::BITWISE)].load(std::memory_order_relaxed);
+            snapshot.relocated_by_move = c->relocated[static_cast<int>(RelocationKind::MOVE)].load(std::memory_order_relaxed);
+            snapshot.relocated_by_copy = c->relocated[static_cast<int>(RelocationKind::COPY)].load(std::memory_order_relaxed);
+            snapshot.relocated_by_reallocate =
+                    c->relocated[static_cast<int>(RelocationKind::REALLOCATE)].load(std::memory_order_relaxed);
+            snapshot.peak_capacity = c->peak_capacity.load(std::memory_order_relaxed);
+            snapshot.destroyed = c->destroyed.load(std::memory_order_relaxed);
+            snapshot.wasted_capacity = c->wasted_capacity.load(std::memory_order_relaxed);
+            snapshot.peak_wasted_capacity = c->peak_wasted_capacity.load(std::memory_order_relaxed);
+            result.push_back(snapshot);
+        }
+        return result;
+    }
+
+    void Reset() {
+        std::lock_guard lock(mutex_);
+        for (Counters* c : counters_) {
+            c->allocations = 0;
+            c->allocated_bytes = 0;
+            c->reallocations = 0;
+            for (auto& relocated : c->relocated) {
+                relocated = 0;
+            }
+            c->peak_capacity = 0;
+            c->destroyed = 0;
+            c->wasted_capacity = 0;
+            c->peak_wasted_capacity = 0;
+        }
+    }
+
+private:
+    Registry() = default;
+
+    mutable std::mutex mutex_;
+    std::vector<Counters*> counters_;
+};
+
+inline const char* TypeName(const std::type_info& type) {
+#if defined(__GNUG__)
+    int status = 0;
+    // строка живёт до конца процесса, как и сами счётчики
+    if (char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status); status == 0) {
+        return demangled;
+    }
+#endif
+    return type.name();
+}
+
+template <typename T>
+Counters& CountersFor() {
+    static Counters* counters = [] {
+        auto* c = new Counters{TypeName(typeid(T)), sizeof(T)};
+        Registry::Instance().Add(c);
+        return c;
+    }();
+    return *counters;
+}
+
+#endif
+
+/// Первый параметр конструктора Vector по умолчанию: отделяет его от явного конструктора
+/// из std::source_location, чтобы место создания не преобразовывалось в вектор неявно
+struct DefaultSiteTag {
+    explicit DefaultSiteTag() = default;
+};
+
+#if defined(VECTOR_WITH_SITE_TRACKING)
+
+/// Место создания векторов и суммарные показания его живых векторов. Каждый вектор
+/// добавляет к ним изменения своих размера и вместимости, поэтому учёт не требует блокировок
+struct Site {
+    Site(const char* file_name, const char* function_name, uint_least32_t line, uint_least32_t column) noexcept
+            : file_name(file_name)
+            , function_name(function_name)
+            , line(line)
+            , column(column)  //
+    {
+    }
+
+    const char* file_name;
+    const char* function_name;
+    uint_least32_t line;
+    uint_least32_t column;
+
+    std::atomic<size_t> live{0};
+    std::atomic<size_t> size{0};
+    std::atomic<size_t> capacity{0};
+    std::atomic<size_t> size_bytes{0};
+    std::atomic<size_t> capacity_bytes{0};
+    std::atomic<size_t> reallocations{0};
+    std::atomic<size_t> destroyed{0};
+
+    [[nodiscard]] bool Matches(const std::source_location& location) const noexcept {
+        return line == location.line() && column == location.column()
+               && (file_name == location.file_name() || std::strcmp(file_name, location.file_name()) == 0)
+               && (function_name == location.function_name()
+                   || std::strcmp(function_name, location.function_name()) == 0);
+    }
+};
+
+/// Открытая адресация без блокировок: места только добавляются и живут до конца процесса
+inline constexpr size_t SITE_TABLE_SIZE = 4096;
+
+inline std::atomic<Site*> site_table[SITE_TABLE_SIZE] = {};
+
+/// Место, куда попадают векторы, если таблица переполнена
+inline Site& OverflowSite() noexcept {
+    static Site site{"<overflow>", "", 0, 0};
+    return site;
+}
+
+inline Site* FindSite(const std::source_location& location) noexcept {
+    const size_t hash = location.line() * size_t{0x9e3779b1} ^ location.column();
+    for (size_t probe = 0; probe != SITE_TABLE_SIZE; ++probe) {
+        std::atomic<Site*>& slot = site_table[(hash + probe) % SITE_TABLE_SIZE];
+        Site* site = slot.load(std::memory_order_acquire);
+        if (site == nullptr) {
+            auto* created = new (std::nothrow) Site{location.file_name(), location.function_name(),
+                                                    location.line(), location.column()};
+            if (created == nullptr) {
+                return &OverflowSite();
+            }
+            if (slot.compare_exchange_strong(site, created, std::memory_order_acq_rel)) {
+                return created;
+            }
+            /// слот занял другой поток, site указывает на его место
+            delete created;
+        }
+        if (site->Matches(location)) {
+            return site;
+        }
+    }
+    return &OverflowSite();
+}
+
+/// Запись живого вектора, встроенная в сам вектор. Помнит последние опубликованные размер
+/// и вместимость и добавляет к счётчикам места только их изменения. Беззнаковые счётчики
+/// уменьшаются по модулю 2^N, и сумма изменений всех векторов места остаётся точной
+class SiteRecord {
+public:
+    constexpr SiteRecord(const std::source_location& location, size_t element_size) noexcept {
+        if (!std::is_constant_evaluated()) {
+            site_ = FindSite(location);
+            element_size_ = element_size;
+            site_->live.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /// Запись копии или перемещённого вектора: пустое location означает место origin
+    constexpr SiteRecord(const SiteRecord& origin, const std::source_location& location, size_t element_size) noexcept {
+        if (!std::is_constant_evaluated()) {
+            site_ = location.line() == 0 && origin.site_ != nullptr ? origin.site_ : FindSite(location);
+            element_size_ = element_size;
+            site_->live.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    SiteRecord(const SiteRecord&) = delete;
+    SiteRecord& operator=(const SiteRecord&) = delete;
+
+    constexpr ~SiteRecord() {
+        if (site_ != nullptr) {
+            Update(0, 0);
+            site_->live.fetch_sub(1, std::memory_order_relaxed);
+            site_->destroyed.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /// Публикует размер и вместимость; смена ненулевой вместимости считается реаллокацией
+    constexpr void Update(size_t size, size_t capacity) noexcept {
+        if (site_ == nullptr) {
+            return;
+        }
+        if (size != size_) {
+            site_->size.fetch_add(size - size_, std::memory_order_relaxed);
+            site_->size_bytes.fetch_add((size - size_) * element_size_, std::memory_order_relaxed);
+            size_ = size;
+        }
+        if (capacity != capacity_) {
+            site_->capacity.fetch_add(capacity - capacity_, std::memory_order_relaxed);
+            site_->capacity_bytes.fetch_add((capacity - capacity_) * element_size_, std::memory_order_relaxed);
+            if (capacity_ != 0 && capacity != 0) {
+                site_->reallocations.fetch_add(1, std::memory_order_relaxed);
+            }
+            capacity_ = capacity;
+        }
+    }
+
+private:
+    Site* site_ = nullptr;
+    size_t element_size_ = 0;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
+
+inline std::vector<SiteSnapshot> CollectSites() {
+    std::vector<SiteSnapshot> result;
+    auto collect = [&result](const Site& site) {
+        SiteSnapshot snapshot;
+        snapshot.file_name = site.file_name;
+        snapshot.function_name = site.function_name;
+        snapshot.line = site.line;
+        snapshot.column = site.column;
+        snapshot.live = site.live.load(std::memory_order_relaxed);
+        snapshot.size = site.size.load(std::memory_order_relaxed);
+        snapshot.capacity = site.capacity.load(std::memory_order_relaxed);
+        snapshot.size_bytes = site.size_bytes.load(std::memory_order_relaxed);
+        snapshot.capacity_bytes = site.capacity_bytes.load(std::memory_order_relaxed);
+        snapshot.reallocations = site.reallocations.load(std::memory_order_relaxed);
+        snapshot.destroyed = site.destroyed.load(std::memory_order_relaxed);
+        /// счётчики читаются по отдельности, и пока векторы места меняются, снимок может
+        /// на мгновение показать размер больше вместимости
+        snapshot.slack_bytes = snapshot.capacity_bytes > snapshot.size_bytes
+                                       ? snapshot.capacity_bytes - snapshot.size_bytes
+                                       : 0;
+        if (snapshot.live != 0 || snapshot.destroyed != 0) {
+            result.push_back(snapshot);
+        }
+    };
+    for (std::atomic<Site*>& slot : site_table) {
+        if (const Site* site = slot.load(std::memory_order_acquire)) {
+            collect(*site);
+        }
+    }
+    collect(OverflowSite());
+    std::ranges::sort(result, std::greater<>(), &SiteSnapshot::slack_bytes);
+    return result;
+}
+
+#else
+
+/// Без VECTOR_WITH_SITE_TRACKING запись пуста и не занимает места в векторе
+class SiteRecord {
+public:
+    constexpr SiteRecord(const std::source_location& /*location*/, size_t /*element_size*/) noexcept {
+    }
+
+    constexpr SiteRecord(const SiteRecord& /*origin*/, const std::source_location& /*location*/,
+                         size_t /*element_size*/) noexcept {
+    }
+
+    constexpr void Update(size_t /*size*/, size_t /*capacity*/) noexcept {
+    }
+};
+
+#endif
+
+}  // namespace vector_telemetry_detail
+
+/// Выделение буфера под capacity элементов
+template <typename T>
+constexpr void RecordAllocation([[maybe_unused]] size_t capacity) noexcept {
+#if defined(VECTOR_WITH_TELEMETRY)
+    if (std::is_constant_evaluated()) {
+        return;
+    }
+    auto& c = vector_telemetry_detail::CountersFor<T>();
+    c.allocations.fetch_add(1, std::memory_order_relaxed);
+    c.allocated_bytes.fetch_add(capacity * sizeof(T), std::memory_order_relaxed);
+    vector_telemetry_detail::UpdateMax(c.peak_capacity, capacity);
+#endif
+}
+
+/// Перенос count существующих элементов в другой буфер; пустой буфер реаллокацией не считается
+template <typename T>
+constexpr void RecordRelocation([[maybe_unused]] RelocationKind kind, [[maybe_unused]] size_t count) noexcept {
+#if defined(VECTOR_WITH_TELEMETRY)
+    if (std::is_constant_evaluated()) {
+        return;
+    }
+    if (count == 0) {
+        return;
+    }
+    auto& c = vector_telemetry_detail::CountersFor<T>();
+    c.reallocations.fetch_add(1, std::memory_order_relaxed);
+    c.relocated[static_cast<int>(kind)].fetch_add(count, std::memory_order_relaxed);
+#endif
+}
+
+/// Изменение вместимости блока средствами аллокатора, без выделения нового буфера
+template <typename T>
+void RecordResize([[maybe_unused]] size_t capacity) noexcept {
+#if defined(VECTOR_WITH_TELEMETRY)
+    vector_telemetry_detail::UpdateMax(vector_telemetry_detail::CountersFor<T>().peak_capacity, capacity);
+#endif
+}
+
+/// Уничтожение контейнера с выделенным буфером, у которого осталось wasted неиспользованных ячеек
+template <typename T>
+constexpr void RecordDestruction([[maybe_unused]] size_t wasted) noexcept {
+#if defined(VECTOR_WITH_TELEMETRY)
+    if (std::is_constant_evaluated()) {
+        return;
+    }
+    auto& c = vector_telemetry_detail::CountersFor<T>();
+    c.destroyed.fetch_add(1, std::memory_order_relaxed);
+    c.wasted_capacity.fetch_add(wasted, std::memory_order_relaxed);
+    vector_telemetry_detail::UpdateMax(c.peak_wasted_capacity, wasted);
+#endif
+}
+
+/// Возвращает показания для всех типов элементов, с которыми работали контейнеры.
+/// Без VECTOR_WITH_TELEMETRY результат пуст
+inline std::vector<TelemetrySnapshot> CollectTelemetry() {
+#if defined(VECTOR_WITH_TELEMETRY)
+    return vector_telemetry_detail::Registry::Instance().Collect();
+#else
+    return {};
+#endif
+}
+
+/// Обнуляет счётчики, например между интервалами сбора
+inline void ResetTelemetry() {
+#if defined(VECTOR_WITH_TELEMETRY)
+    vector_telemetry_detail::Registry::Instance().Reset();
+#endif
+}
+
+/// Печатает показания в текстовом формате «тип ключ=значение ...», по строке на тип
+inline void WriteTelemetry(std::ostream& out) {
+    for (const TelemetrySnapshot& s : CollectTelemetry()) {
+        out << s.type_name
+            << " element_size=" << s.element_size
+            << " allocations=" << s.allocations
+            << " allocated_bytes=" << s.allocated_bytes
+            << " reallocations=" << s.reallocations
+            << " relocated_bitwise=" << s.relocated_bitwise
+            << " relocated_by_move=" << s.relocated_by_move
+            << " relocated_by_copy=" << s.relocated_by_copy
+            << " relocated_by_reallocate=" << s.relocated_by_reallocate
+            << " peak_capacity=" << s.peak_capacity
+            << " destroyed=" << s.destroyed
+            << " wasted_capacity=" << s.wasted_capacity
+            << " peak_wasted_capacity=" << s.peak_wasted_capacity
+            << '\n';
+    }
+}
+
+/// Возвращает показания мест создания Vector, начиная с мест с наибольшей незанятой вместимостью.
+/// Без VECTOR_WITH_SITE_TRACKING результат пуст
+inline std::vector<SiteSnapshot> CollectSiteTelemetry() {
+#if defined(VECTOR_WITH_SITE_TRACKING)
+    return vector_telemetry_detail::CollectSites();
+#else
+    return {};
+#endif
+}
+
+/// Печатает показания мест создания в формате «файл:строка:столбец ключ=значение ... функция»,
+/// по строке на место
+inline void WriteSiteTelemetry(std::ostream& out) {
+    for (const SiteSnapshot& s : CollectSiteTelemetry()) {
+        out << s.file_name << ':' << s.line << ':' << s.column
+            << " live=" << s.live
+            << " size=" << s.size
+            << " capacity=" << s.capacity
+            << " size_bytes=" << s.size_bytes
+            << " capacity_bytes=" << s.capacity_bytes
+            << " slack_bytes=" << s.slack_bytes
+            << " reallocations=" << s.reallocations
+            << " destroyed=" << s.destroyed
+            << ' ' << s.function_name
+            << '\n';
+    }
+}
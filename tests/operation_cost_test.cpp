@@ -0,0 +1,421 @@
+#include "../small_vector.h"
+#include "../vector.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Контракты стоимости операций: каждая проверка задаёт точное количество конструирований,
+// копирований, перемещений, присваиваний, разрушений элементов и выделений памяти.
+// Счётчики, не упомянутые в ожидании, должны остаться нулевыми, поэтому лишнее перемещение
+// или выделение памяти проваливает тест. Проверки не зависят от NDEBUG.
+// Выделения буферов считает аллокатор CountingAllocator, а глобальный operator new
+// ловит выделения в обход аллокатора
+
+namespace {
+
+/// Изменения счётчиков за время операции
+struct Costs {
+    size_t default_constructed = 0;
+    size_t constructed = 0;
+    size_t copied = 0;
+    size_t moved = 0;
+    size_t copy_assigned = 0;
+    size_t move_assigned = 0;
+    size_t destroyed = 0;
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    /// выделения через глобальный operator new
+    size_t heap_allocations = 0;
+};
+
+Costs counters;
+int failures = 0;
+
+}  // namespace
+
+void* operator new(size_t size) {
+    ++counters.heap_allocations;
+    if (void* ptr = std::malloc(size != 0 ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t /*size*/) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+/// Элемент, который считает вызовы своих специальных функций
+struct Counted {
+    Counted() noexcept {
+        ++counters.default_constructed;
+    }
+
+    explicit Counted(int id) noexcept
+            : id(id)  //
+    {
+        ++counters.constructed;
+    }
+
+    Counted(const Counted& other) noexcept
+            : id(other.id)  //
+    {
+        ++counters.copied;
+    }
+
+    Counted(Counted&& other) noexcept
+            : id(other.id)  //
+    {
+        ++counters.moved;
+    }
+
+    Counted& operator=(const Counted& other) noexcept {
+        id = other.id;
+        ++counters.copy_assigned;
+        return *this;
+    }
+
+    Counted& operator=(Counted&& other) noexcept {
+        id = other.id;
+        ++counters.move_assigned;
+        return *this;
+    }
+
+    ~Counted() {
+        ++counters.destroyed;
+    }
+
+    int id = 0;
+};
+
+/// Тот же элемент, но объявленный тривиально перемещаемым: Vector переносит его побайтово
+struct Relocatable : Counted {
+    using Counted::Counted;
+};
+
+/// Аллокатор без состояния, который считает выделения буферов
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        ++counters.allocations;
+        if (void* ptr = std::malloc(n * sizeof(T))) {
+            return static_cast<T*>(ptr);
+        }
+        throw std::bad_alloc();
+    }
+
+    void deallocate(T* ptr, size_t /*n*/) noexcept {
+        ++counters.deallocations;
+        std::free(ptr);
+    }
+
+    bool operator==(const CountingAllocator& /*other*/) const noexcept {
+        return true;
+    }
+};
+
+}  // namespace
+
+template <>
+struct is_trivially_relocatable<Relocatable> : std::true_type {
+};
+
+namespace {
+
+template <typename Growth = DoublingGrowth>
+using CountedVector = Vector<Counted, CountingAllocator<Counted>, Growth>;
+
+Costs operator-(const Costs& lhs, const Costs& rhs) {
+    return {lhs.default_constructed - rhs.default_constructed, lhs.constructed - rhs.constructed,
+            lhs.copied - rhs.copied, lhs.moved - rhs.moved, lhs.copy_assigned - rhs.copy_assigned,
+            lhs.move_assigned - rhs.move_assigned, lhs.destroyed - rhs.destroyed,
+            lhs.allocations - rhs.allocations, lhs.deallocations - rhs.deallocations,
+            lhs.heap_allocations - rhs.heap_allocations};
+}
+
+void Compare(std::string_view contract, std::string_view counter, size_t actual, size_t expected) {
+    if (actual != expected) {
+        std::cerr << contract << ": " << counter << " = " << actual << ", expected " << expected << '\n';
+        ++failures;
+    }
+}
+
+/// Выполняет op и сравнивает изменения всех счётчиков с expected
+template <typename Op>
+void ExpectCost(std::string_view contract, Op op, const Costs& expected) {
+    const Costs before = counters;
+    op();
+    const Costs actual = counters - before;
+    Compare(contract, "default_constructed", actual.default_constructed, expected.default_constructed);
+    Compare(contract, "constructed", actual.constructed, expected.constructed);
+    Compare(contract, "copied", actual.copied, expected.copied);
+    Compare(contract, "moved", actual.moved, expected.moved);
+    Compare(contract, "copy_assigned", actual.copy_assigned, expected.copy_assigned);
+    Compare(contract, "move_assigned", actual.move_assigned, expected.move_assigned);
+    Compare(contract, "destroyed", actual.destroyed, expected.destroyed);
+    Compare(contract, "allocations", actual.allocations, expected.allocations);
+    Compare(contract, "deallocations", actual.deallocations, expected.deallocations);
+    Compare(contract, "heap_allocations", actual.heap_allocations, expected.heap_allocations);
+}
+
+void Check(std::string_view contract, bool condition) {
+    if (!condition) {
+        std::cerr << contract << ": check failed\n";
+        ++failures;
+    }
+}
+
+constexpr size_t SIZE = 1000;
+
+void TestConstruction() {
+    ExpectCost("Vector(size)", [] {
+        CountedVector<> v(SIZE);
+    }, {.default_constructed = SIZE, .destroyed = SIZE, .allocations = 1, .deallocations = 1});
+
+    CountedVector<> v(SIZE);
+    ExpectCost("copy constructor", [&v] {
+        CountedVector<> copy(v);
+    }, {.copied = SIZE, .destroyed = SIZE, .allocations = 1, .deallocations = 1});
+
+    ExpectCost("move constructor", [&v] {
+        CountedVector<> moved(std::move(v));
+        v = std::move(moved);
+    }, {});
+
+    CountedVector<> large(2 * SIZE);
+    ExpectCost("copy assignment into sufficient capacity", [&large, &v] {
+        large = v;
+    }, {.copy_assigned = SIZE, .destroyed = SIZE});
+    Check("copy assignment keeps capacity", large.Capacity() == 2 * SIZE);
+
+    CountedVector<> small(10);
+    ExpectCost("copy assignment with reallocation", [&small, &v] {
+        small = v;
+    }, {.copied = SIZE, .destroyed = 10, .allocations = 1, .deallocations = 1});
+
+    ExpectCost("range constructor", [&v] {
+        CountedVector<> copy(from_range, v);
+    }, {.copied = SIZE, .destroyed = SIZE, .allocations = 1, .deallocations = 1});
+
+    ExpectCost("Assign into sufficient capacity", [&large, &v] {
+        large.Assign(v.begin(), v.end());
+    }, {.copy_assigned = SIZE});
+}
+
+void TestCapacity() {
+    CountedVector<> v(SIZE);
+    ExpectCost("Reserve", [&v] {
+        v.Reserve(2 * SIZE);
+    }, {.moved = SIZE, .destroyed = SIZE, .allocations = 1, .deallocations = 1});
+    ExpectCost("Reserve below capacity", [&v] {
+        v.Reserve(SIZE);
+    }, {});
+    ExpectCost("ShrinkToFit", [&v] {
+        v.ShrinkToFit();
+    }, {.moved = SIZE, .destroyed = SIZE, .allocations = 1, .deallocations = 1});
+    ExpectCost("ShrinkToFit without spare capacity", [&v] {
+        v.ShrinkToFit();
+    }, {});
+    ExpectCost("Resize down", [&v] {
+        v.Resize(SIZE / 2);
+    }, {.destroyed = SIZE / 2});
+    ExpectCost("Resize up within capacity", [&v] {
+        v.Resize(SIZE);
+    }, {.default_constructed = SIZE / 2});
+    ExpectCost("Resize up with reallocation", [&v] {
+        v.Resize(2 * SIZE);
+    }, {.default_constructed = SIZE, .moved = SIZE, .destroyed = SIZE, .allocations = 1, .deallocations = 1});
+
+    Vector<Relocatable, CountingAllocator<Relocatable>> relocatable(SIZE);
+    ExpectCost("Reserve of trivially relocatable elements", [&relocatable] {
+        relocatable.Reserve(2 * SIZE);
+    }, {.allocations = 1, .deallocations = 1});
+}
+
+void TestAppend() {
+    CountedVector<> v(SIZE);
+    const Counted value(1);
+    ExpectCost("PushBack copy with reallocation", [&v, &value] {
+        v.PushBack(value);
+    }, {.copied = 1, .moved = SIZE, .destroyed = SIZE, .allocations = 1, .deallocations = 1});
+    Check("PushBack doubles capacity", v.Capacity() == 2 * SIZE);
+    ExpectCost("PushBack temporary into spare capacity", [&v] {
+        v.PushBack(Counted(2));
+    }, {.constructed = 1, .moved = 1, .destroyed = 1});
+    ExpectCost("EmplaceBack into spare capacity", [&v] {
+        v.EmplaceBack(3);
+    }, {.constructed = 1});
+    ExpectCost("PopBack", [&v] {
+        v.PopBack();
+    }, {.destroyed = 1});
+
+    CountedVector<> full(SIZE);
+    ExpectCost("EmplaceBack with reallocation", [&full] {
+        full.EmplaceBack(4);
+    }, {.constructed = 1, .moved = SIZE, .destroyed = SIZE, .allocations = 1, .deallocations = 1});
+
+    const std::vector<Counted> source(SIZE / 2);
+    CountedVector<> target;
+    ExpectCost("AppendRange of a sized range", [&target, &source] {
+        target.AppendRange(source);
+    }, {.copied = SIZE / 2, .allocations = 1});
+    ExpectCost("AppendWith", [&target] {
+        target.AppendWith(SIZE / 2, [](Counted* dst, size_t n) {
+            for (size_t i = 0; i != n; ++i) {
+                new (dst + i) Counted(static_cast<int>(i));
+            }
+        });
+    }, {.constructed = SIZE / 2, .moved = SIZE / 2, .destroyed = SIZE / 2, .allocations = 1, .deallocations = 1});
+}
+
+void TestInsertErase() {
+    constexpr size_t COUNT = 10;
+    {
+        CountedVector<> v(SIZE);
+        v.Reserve(2 * SIZE);
+        ExpectCost("Emplace into spare capacity", [&v] {
+            v.Emplace(v.cbegin() + 3, 42);
+        }, {.constructed = 1, .moved = 1, .move_assigned = SIZE - 3, .destroyed = 1});
+        ExpectCost("Erase", [&v] {
+            v.Erase(v.cbegin() + 3);
+        }, {.move_assigned = SIZE - 3, .destroyed = 1});
+    }
+    {
+        CountedVector<> v(SIZE);
+        ExpectCost("Emplace with reallocation", [&v] {
+            v.Emplace(v.cbegin() + 1, 42);
+        }, {.constructed = 1, .moved = SIZE, .destroyed = SIZE, .allocations = 1, .deallocations = 1});
+    }
+    {
+        CountedVector<> v(SIZE);
+        v.Reserve(2 * SIZE);
+        const Counted value(7);
+        ExpectCost("Insert count copies into spare capacity", [&v, &value] {
+            v.Insert(v.cbegin() + (SIZE - COUNT / 2), COUNT, value);
+        }, {.copied = COUNT / 2, .moved = COUNT / 2, .copy_assigned = COUNT / 2});
+
+        const std::vector<Counted> source(COUNT);
+        ExpectCost("Insert range into spare capacity", [&v, &source] {
+            v.Insert(v.cbegin(), source.begin(), source.end());
+        }, {.moved = COUNT, .copy_assigned = COUNT, .move_assigned = SIZE});
+        ExpectCost("Erase range", [&v] {
+            v.Erase(v.cbegin(), v.cbegin() + COUNT);
+        }, {.move_assigned = SIZE + COUNT, .destroyed = COUNT});
+    }
+    {
+        CountedVector<> v(SIZE);
+        const std::vector<Counted> source(COUNT);
+        ExpectCost("Insert range with reallocation", [&v, &source] {
+            v.Insert(v.cbegin() + SIZE / 2, source.begin(), source.end());
+        }, {.copied = COUNT, .moved = SIZE, .destroyed = SIZE, .allocations = 1, .deallocations = 1});
+    }
+    {
+        CountedVector<> v;
+        for (int i = 0; i != static_cast<int>(SIZE); ++i) {
+            v.EmplaceBack(i);
+        }
+        ExpectCost("SwapErase", [&v] {
+            v.SwapErase(v.cbegin());
+        }, {.move_assigned = 1, .destroyed = 1});
+        // SwapErase поставил первым id 999; удаляются нечётные id, и, начиная с первого удалённого,
+        // каждый оставшийся элемент сдвигается одним присваиванием
+        ExpectCost("EraseIf", [&v] {
+            v.EraseIf([](const Counted& c) {
+                return c.id % 2 == 1;
+            });
+        }, {.move_assigned = SIZE / 2 - 1, .destroyed = SIZE / 2});
+        ExpectCost("RemoveIf", [&v] {
+            v.RemoveIf([](const Counted& c) {
+                return c.id < 10;
+            });
+        }, {.move_assigned = 4, .destroyed = 4});
+    }
+}
+
+void TestGrowthPolicies() {
+    constexpr size_t COUNT = 100;
+    auto fill = []<typename V>(V& v) {
+        for (int i = 0; i != static_cast<int>(COUNT); ++i) {
+            v.EmplaceBack(i);
+        }
+    };
+    // вместимости 1, 2, 4, ..., 128
+    ExpectCost("DoublingGrowth", [&fill] {
+        CountedVector<> v;
+        fill(v);
+    }, {.constructed = COUNT, .moved = 127, .destroyed = 127 + COUNT, .allocations = 8, .deallocations = 8});
+    // первое выделение на 64 байта: 16 элементов, затем 32, 64, 128
+    static_assert(sizeof(Counted) == 4);
+    ExpectCost("MinAllocationGrowth", [&fill] {
+        CountedVector<MinAllocationGrowth<>> v;
+        fill(v);
+    }, {.constructed = COUNT, .moved = 112, .destroyed = 112 + COUNT, .allocations = 4, .deallocations = 4});
+    // вместимости 1, 2, 3, 4, 6, 9, 13, 19, 28, 42, 63, 94, 141
+    ExpectCost("OneAndHalfGrowth", [&fill] {
+        CountedVector<OneAndHalfGrowth> v;
+        fill(v);
+    }, {.constructed = COUNT, .moved = 284, .destroyed = 284 + COUNT, .allocations = 13, .deallocations = 13});
+}
+
+void TestSmallVector() {
+    using Small = SmallVector<Counted, 8, CountingAllocator<Counted>>;
+    Small v;
+    ExpectCost("SmallVector inline EmplaceBack", [&v] {
+        for (int i = 0; i != 8; ++i) {
+            v.EmplaceBack(i);
+        }
+    }, {.constructed = 8});
+    ExpectCost("SmallVector spill to heap", [&v] {
+        v.EmplaceBack(8);
+    }, {.constructed = 1, .moved = 8, .destroyed = 8, .allocations = 1});
+    ExpectCost("SmallVector copy of a heap vector", [&v] {
+        Small copy(v);
+    }, {.copied = 9, .destroyed = 9, .allocations = 1, .deallocations = 1});
+    ExpectCost("SmallVector move of a heap vector", [&v] {
+        Small moved(std::move(v));
+        v = std::move(moved);
+    }, {});
+
+    // элементы внутреннего буфера перемещаются поштучно, а перемещённые из источника уничтожаются
+    Small inline_vector(4);
+    ExpectCost("SmallVector move of an inline vector", [&inline_vector] {
+        Small moved(std::move(inline_vector));
+    }, {.moved = 4, .destroyed = 8});
+    Check("moved-from SmallVector is empty", inline_vector.Size() == 0);
+}
+
+}  // namespace
+
+int main() {
+    TestConstruction();
+    TestCapacity();
+    TestAppend();
+    TestInsertErase();
+    TestGrowthPolicies();
+    TestSmallVector();
+    if (failures != 0) {
+        std::cerr << failures << " operation cost contract(s) violated\n";
+        return 1;
+    }
+    std::cout << "all operation cost contracts hold\n";
+    return 0;
+}
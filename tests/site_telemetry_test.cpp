@@ -0,0 +1,176 @@
+#include "../vector.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <source_location>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Учёт живых Vector по месту создания (VECTOR_WITH_SITE_TRACKING): размер, вместимость,
+// незанятая память и реаллокации суммируются по строкам, где векторы были созданы.
+// Проверки не зависят от NDEBUG
+
+namespace {
+
+int failures = 0;
+
+void Check(std::string_view contract, bool condition) {
+    if (!condition) {
+        std::cerr << contract << ": check failed\n";
+        ++failures;
+    }
+}
+
+/// Показания места в этом файле на строке line, пустой снимок — если место не найдено
+SiteSnapshot SiteAt(uint_least32_t line) {
+    const char* file = std::source_location::current().file_name();
+    for (const SiteSnapshot& site : CollectSiteTelemetry()) {
+        if (site.line == line && std::strcmp(site.file_name, file) == 0) {
+            return site;
+        }
+    }
+    return {};
+}
+
+void TestGrowthSlack() {
+    const uint_least32_t line = std::source_location::current().line() + 1;
+    Vector<int> v;
+    Check("empty vector is live", SiteAt(line).live == 1);
+    for (int i = 0; i != 1000; ++i) {
+        v.PushBack(i);
+    }
+    SiteSnapshot site = SiteAt(line);
+    Check("size after growth", site.live == 1 && site.size == 1000 && site.capacity == 1024);
+    Check("slack after growth", site.slack_bytes == 24 * sizeof(int));
+    // вместимости 1, 2, 4, ..., 1024
+    Check("reallocations during growth", site.reallocations == 10);
+
+    v.Resize(10);
+    site = SiteAt(line);
+    Check("Resize down keeps capacity", site.size == 10 && site.slack_bytes == 1014 * sizeof(int));
+    v.ShrinkToFit();
+    site = SiteAt(line);
+    Check("ShrinkToFit releases slack", site.capacity == 10 && site.slack_bytes == 0 && site.reallocations == 11);
+}
+
+void TestInstances() {
+    const uint_least32_t loop_line = std::source_location::current().line() + 2;
+    for (int i = 0; i != 3; ++i) {
+        Vector<double> temporary(10);
+        temporary.Reserve(20);
+    }
+    const SiteSnapshot loop = SiteAt(loop_line);
+    Check("destroyed vectors are not live", loop.live == 0 && loop.destroyed == 3 && loop.capacity == 0);
+    Check("reallocations of destroyed vectors are kept", loop.reallocations == 3);
+
+    const uint_least32_t source_line = std::source_location::current().line() + 1;
+    Vector<double> source(100);
+    const uint_least32_t moved_line = std::source_location::current().line() + 1;
+    Vector<double> moved(std::move(source));
+    const uint_least32_t copy_line = std::source_location::current().line() + 1;
+    Vector<double> copy(moved);
+    const SiteSnapshot origin = SiteAt(source_line);
+    Check("moved and copied vectors keep the source site",
+          origin.live == 3 && origin.size_bytes == 200 * sizeof(double) && origin.capacity == 200);
+    Check("move and copy do not create sites", SiteAt(moved_line).live == 0 && SiteAt(copy_line).live == 0);
+    const std::source_location relocated = std::source_location::current();
+    Vector<double> relocated_copy(copy, relocated);
+    Check("explicit site of a copy", SiteAt(relocated.line()).live == 1 && SiteAt(source_line).live == 3);
+
+    std::ostringstream out;
+    WriteSiteTelemetry(out);
+    const std::string expected = std::string(std::source_location::current().file_name()) + ':'
+                                 + std::to_string(source_line) + ':';
+    Check("WriteSiteTelemetry prints the site", out.str().find(expected) != std::string::npos);
+}
+
+void TestExplicitSite() {
+    static_assert(!std::is_convertible_v<std::source_location, Vector<int>>);
+    static_assert(std::is_nothrow_default_constructible_v<Vector<int>>);
+    const std::source_location location = std::source_location::current();
+    Vector<int> v(location);
+    v.Reserve(8);
+    const SiteSnapshot site = SiteAt(location.line());
+    Check("explicit site", site.live == 1 && site.capacity == 8);
+}
+
+void TestNestedVectors() {
+    // вектор внутри контейнера учитывается в месте, где его создали, а не в строке контейнера,
+    // которая перемещает его при реаллокации
+    const uint_least32_t inner_line = std::source_location::current().line() + 1;
+    Vector<int> inner(10);
+    const uint_least32_t outer_line = std::source_location::current().line() + 1;
+    Vector<Vector<int>> outer;
+    std::vector<Vector<int>> held;
+    for (int i = 0; i != 8; ++i) {
+        outer.PushBack(inner);
+        held.push_back(inner);
+    }
+    Check("nested copies keep the inner site", SiteAt(inner_line).live == 17 && SiteAt(inner_line).size == 170);
+    Check("outer vector has its own site", SiteAt(outer_line).live == 1 && SiteAt(outer_line).size == 8);
+    size_t foreign = 0;
+    for (const SiteSnapshot& site : CollectSiteTelemetry()) {
+        if (site.live != 0 && std::strstr(site.file_name, "site_telemetry_test") == nullptr) {
+            foreign += site.live;
+        }
+    }
+    Check("relocated elements are not counted inside the containers", foreign == 0);
+
+    // элемент, построенный самим контейнером, получает место явно
+    const std::source_location emplaced = std::source_location::current();
+    held.emplace_back(5, std::allocator<int>(), emplaced);
+    Check("emplaced vector with an explicit site", SiteAt(emplaced.line()).live == 1 && SiteAt(emplaced.line()).size == 5);
+}
+
+void TestConcurrentSites() {
+    const size_t THREADS = 4;
+    const int VECTORS = 1000;
+    std::vector<uint_least32_t> lines(THREADS);
+    std::atomic<bool> done = false;
+    std::thread collector([&done] {
+        while (!done.load()) {
+            static_cast<void>(CollectSiteTelemetry());
+        }
+    });
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t != THREADS; ++t) {
+        threads.emplace_back([&lines, t] {
+            for (int i = 0; i != VECTORS; ++i) {
+                lines[t] = std::source_location::current().line() + 1;
+                Vector<int> v;
+                v.PushBack(i);
+                v.PushBack(i);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    done = true;
+    collector.join();
+    const SiteSnapshot site = SiteAt(lines[0]);
+    Check("concurrent vectors are all destroyed", site.live == 0 && site.destroyed == THREADS * VECTORS);
+    Check("concurrent reallocations", site.reallocations == THREADS * VECTORS);
+}
+
+}  // namespace
+
+int main() {
+    TestGrowthSlack();
+    TestInstances();
+    TestExplicitSite();
+    TestNestedVectors();
+    TestConcurrentSites();
+    if (failures != 0) {
+        std::cerr << failures << " site telemetry check(s) failed\n";
+        return 1;
+    }
+    std::cout << "site telemetry checks passed\n";
+    return 0;
+}
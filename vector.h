@@ -1,17 +1,233 @@
 #pragma once
+#include "parallel_memory.h"
+#include "simd.h"
+#include "telemetry.h"
+
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <cstdlib>
+#include <concepts>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory_resource>
 #include <new>
+#include <ranges>
+#include <type_traits>
 #include <utility>
+#if defined(VECTOR_HAVE_NALLOCX)
+#include <jemalloc/jemalloc.h>
+#endif
 #include <memory>
 
+/// Признак тривиальной перемещаемости: объект можно перенести в другое место памяти
+/// побайтовым копированием, после чего исходный объект считается уничтоженным
+/// без вызова деструктора. По умолчанию выводится для тривиально копируемых типов,
+/// для остальных (например, владеющих указателей) его можно включить специализацией
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {
+};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+/// Разрешение переносить элементы при росте вектора перемещением, даже если перемещающий
+/// конструктор не объявлен noexcept. Вместо копирования элементов вектор даёт только базовую
+/// гарантию: если перемещение выбросит исключение, вектор сохранит прежние размер и буфер,
+/// но часть его элементов останется в перемещённом состоянии. Включается специализацией
+/// для типа или для отдельного вектора политикой роста RelaxedGrowth
+template <typename T>
+struct relocate_by_move : std::false_type {
+};
 
 template <typename T>
+inline constexpr bool relocate_by_move_v = relocate_by_move<T>::value;
+
+/// Переносит size элементов из src в неинициализированную память dst,
+/// оставляя gap свободных ячеек начиная с позиции index.
+/// После успешного переноса элементы в src уничтожены.
+/// Если копирование выбрасывает исключение, src остаётся нетронутым, а dst пустым.
+/// С ByMove элементы перемещаются и при бросающем перемещении: после исключения dst пуст,
+/// а элементы src живы, но часть из них может оказаться в перемещённом состоянии.
+/// На этапе компиляции побайтовое копирование недоступно, и элементы перемещаются
+template <typename T, bool ByMove = relocate_by_move_v<T>>
+constexpr void RelocateElements(T* src, size_t size, T* dst, size_t index, size_t gap = 0) {
+    assert(index <= size);
+    if constexpr (is_trivially_relocatable_v<T>) {
+        if (!std::is_constant_evaluated()) {
+            RecordRelocation<T>(RelocationKind::BITWISE, size);
+            /// переносим элементы до позиции и после неё двумя блоками
+            BulkMemcpy(dst, src, index);
+            BulkMemcpy(dst + index + gap, src + index, size - index);
+            return;
+        }
+    }
+    if constexpr (ByMove || is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>
+                  || !std::is_copy_constructible_v<T>) {
+        RecordRelocation<T>(RelocationKind::MOVE, size);
+        BulkMoveConstruct(src, index, dst);
+        try {
+            BulkMoveConstruct(src + index, size - index, dst + index + gap);
+        } catch (...) {
+            BulkDestroy(dst, index);
+            throw;
+        }
+        BulkDestroy(src, size);
+    } else {
+        RecordRelocation<T>(RelocationKind::COPY, size);
+        BulkCopyConstruct(src, index, dst);
+        try {
+            BulkCopyConstruct(src + index, size - index, dst + index + gap);
+        } catch (...) {
+            BulkDestroy(dst, index);
+            throw;
+        }
+        BulkDestroy(src, size);
+    }
+}
+
+/// Политики роста определяют вместимость, которую вектор запрашивает у аллокатора:
+///  Grow(capacity, required, elem_size) — новая вместимость, когда при текущей capacity
+///      не помещается required элементов (амортизированный рост при вставке);
+///  Fit(required, elem_size) — вместимость под точно запрошенное количество элементов
+///      (конструирование, Reserve, Resize).
+/// Обе функции возвращают не меньше required; elem_size — размер элемента в байтах
+
+/// Геометрический рост в Num / Den раз, первое выделение — под один элемент
+template <size_t Num, size_t Den>
+struct GeometricGrowth {
+    static_assert(Num > Den, "growth factor must be greater than 1");
+
+    static constexpr size_t Grow(size_t capacity, size_t required, size_t /*elem_size*/) noexcept {
+        const size_t grown = capacity == 0 ? 1 : capacity / Den * Num + capacity % Den * Num / Den;
+        return std::max(grown, required);
+    }
+
+    static constexpr size_t Fit(size_t required, size_t /*elem_size*/) noexcept {
+        return required;
+    }
+};
+
+using DoublingGrowth = GeometricGrowth<2, 1>;
+using OneAndHalfGrowth = GeometricGrowth<3, 2>;
+
+/// Первое выделение при росте занимает не меньше MinBytes байт,
+/// чтобы вектор, заполняемый с нуля, не проходил через вместимости 1, 2, 4, ...
+template <typename Base = DoublingGrowth, size_t MinBytes = 64>
+struct MinAllocationGrowth {
+    static constexpr size_t Grow(size_t capacity, size_t required, size_t elem_size) noexcept {
+        const size_t grown = Base::Grow(capacity, required, elem_size);
+        return capacity == 0 ? std::max(grown, (MinBytes + elem_size - 1) / elem_size) : grown;
+    }
+
+    static constexpr size_t Fit(size_t required, size_t elem_size) noexcept {
+        return Base::Fit(required, elem_size);
+    }
+};
+
+/// Политика Base, разрешающая вектору переносить элементы при росте перемещением
+/// (см. relocate_by_move) для всех типов элементов. Оборачивает остальные политики снаружи:
+/// признак читается только у политики, указанной в векторе
+template <typename Base = DoublingGrowth>
+struct RelaxedGrowth {
+    static constexpr bool RELOCATE_BY_MOVE = true;
+
+    static constexpr size_t Grow(size_t capacity, size_t required, size_t elem_size) noexcept {
+        return Base::Grow(capacity, required, elem_size);
+    }
+
+    static constexpr size_t Fit(size_t required, size_t elem_size) noexcept {
+        return Base::Fit(required, elem_size);
+    }
+};
+
+/// Переносит ли контейнер с политикой Growth элементы типа T перемещением независимо от noexcept
+template <typename T, typename Growth>
+inline constexpr bool relocates_by_move_v = relocate_by_move_v<T> || requires {
+    requires Growth::RELOCATE_BY_MOVE;
+};
+
+/// Возвращает количество байт, которое malloc фактически выделит на запрос bytes.
+/// С jemalloc (VECTOR_HAVE_NALLOCX) используется nallocx, для glibc размер
+/// вычисляется по её правилам выравнивания чанков, иначе запрос не меняется
+inline size_t MallocGoodSize(size_t bytes) noexcept {
+    if (bytes == 0) {
+        return 0;
+    }
+#if defined(VECTOR_HAVE_NALLOCX)
+    return nallocx(bytes, 0);
+#elif defined(__GLIBC__) && SIZE_MAX == UINT64_MAX
+    // Заголовок чанка занимает одно слово, чанки выровнены на 16 байт и не меньше 32 байт
+    constexpr size_t SIZE_SZ = sizeof(size_t);
+    constexpr size_t ALIGN_MASK = 2 * SIZE_SZ - 1;
+    constexpr size_t MIN_CHUNK = 4 * SIZE_SZ;
+    // Порог mmap по умолчанию: крупные блоки выделяются целыми страницами
+    constexpr size_t MMAP_THRESHOLD = 128 * 1024;
+    constexpr size_t PAGE_SIZE = 4096;
+    if (bytes > SIZE_MAX / 2) {
+        return bytes;
+    }
+    const size_t chunk = std::max(MIN_CHUNK, (bytes + SIZE_SZ + ALIGN_MASK) & ~ALIGN_MASK);
+    if (bytes >= MMAP_THRESHOLD) {
+        return ((chunk + SIZE_SZ + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1)) - 2 * SIZE_SZ;
+    }
+    return chunk - SIZE_SZ;
+#else
+    return bytes;
+#endif
+}
+
+/// Округляет вместимость базовой политики вверх до размера блока, который реально выдаст
+/// malloc, чтобы уже выделенные байты не пропадали. Имеет смысл только для аллокаторов,
+/// которые берут память у malloc (std::allocator с глобальным operator new)
+template <typename Base = DoublingGrowth>
+struct MallocSizeClassGrowth {
+    static size_t Grow(size_t capacity, size_t required, size_t elem_size) noexcept {
+        return RoundUp(Base::Grow(capacity, required, elem_size), elem_size);
+    }
+
+    static size_t Fit(size_t required, size_t elem_size) noexcept {
+        return RoundUp(Base::Fit(required, elem_size), elem_size);
+    }
+
+private:
+    static size_t RoundUp(size_t count, size_t elem_size) noexcept {
+        if (count == 0 || count > SIZE_MAX / elem_size) {
+            return count;
+        }
+        return std::max(count, MallocGoodSize(count * elem_size) / elem_size);
+    }
+};
+
+
+template <typename T, typename Alloc = std::allocator<T>>
 class RawMemory {
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    static_assert(std::is_same_v<typename AllocTraits::value_type, T>,
+                  "Alloc::value_type must be the same as T");
+    static_assert(std::is_same_v<typename AllocTraits::pointer, T*>,
+                  "fancy pointers are not supported");
+
 public:
-    RawMemory() = default;
+    using allocator_type = Alloc;
+
+    /// Умеет ли аллокатор менять размер блока без выделения нового:
+    /// для этого он предоставляет T* reallocate(T* p, size_t old_n, size_t new_n)
+    static constexpr bool CAN_REALLOCATE = requires(Alloc& alloc, T* p, size_t n) {
+        { alloc.reallocate(p, n, n) } -> std::same_as<T*>;
+    };
+
+    constexpr RawMemory() = default;
+
+    constexpr explicit RawMemory(const Alloc& alloc) noexcept:
+        alloc_(alloc) {
+    }
 
-    explicit RawMemory(size_t capacity):
+    constexpr explicit RawMemory(size_t capacity, const Alloc& alloc = Alloc()):
+        alloc_(alloc),
         buffer_(Allocate(capacity)),
         capacity_(capacity) {
     }
@@ -19,245 +235,596 @@ public:
     RawMemory(const RawMemory&) = delete;
     RawMemory& operator=(const RawMemory& rhs) = delete;
 
-    RawMemory(RawMemory&& other) noexcept {
-        buffer_ = other.buffer_;
-        capacity_ = other.capacity_;
-        other.buffer_ = nullptr;
-        other.capacity_ = 0;
+    /// Перемещённый аллокатор сравнивается равным исходному,
+    /// поэтому буфер переходит вместе с ним
+    constexpr RawMemory(RawMemory&& other) noexcept:
+        alloc_(std::move(other.alloc_)),
+        buffer_(std::exchange(other.buffer_, nullptr)),
+        capacity_(std::exchange(other.capacity_, 0)) {
     }
 
-    RawMemory& operator=(RawMemory&& rhs) noexcept {
+    /// Забирает буфер rhs вместе с его аллокатором. Если аллокатор нельзя присвоить
+    /// (как std::pmr::polymorphic_allocator), аллокаторы обязаны быть равны
+    constexpr RawMemory& operator=(RawMemory&& rhs) noexcept {
         if (this != &rhs) {
-            Deallocate(buffer_);
-            capacity_ = 0;
-            Swap(rhs);
+            Deallocate(buffer_, capacity_);
+            buffer_ = std::exchange(rhs.buffer_, nullptr);
+            capacity_ = std::exchange(rhs.capacity_, 0);
+            if constexpr (std::is_move_assignable_v<Alloc>) {
+                alloc_ = std::move(rhs.alloc_);
+            } else {
+                assert(alloc_ == rhs.alloc_);
+            }
         }
         return *this;
     }
 
-    ~RawMemory() {
-        Deallocate(buffer_);
+    constexpr ~RawMemory() {
+        Deallocate(buffer_, capacity_);
     }
 
-    T* operator+(size_t offset) noexcept {
+    constexpr T* operator+(size_t offset) noexcept {
         // Разрешается получать адрес ячейки памяти, следующей за последним элементом массива
         assert(offset <= capacity_);
         return buffer_ + offset;
     }
 
-    const T* operator+(size_t offset) const noexcept {
+    constexpr const T* operator+(size_t offset) const noexcept {
         return const_cast<RawMemory&>(*this) + offset;
     }
 
-    const T& operator[](size_t index) const noexcept {
+    constexpr const T& operator[](size_t index) const noexcept {
         return const_cast<RawMemory&>(*this)[index];
     }
 
-    T& operator[](size_t index) noexcept {
+    constexpr T& operator[](size_t index) noexcept {
         assert(index < capacity_);
         return buffer_[index];
     }
 
-    void Swap(RawMemory& other) noexcept {
+    /// Аллокаторы обмениваются, только если этого требует propagate_on_container_swap,
+    /// иначе обмен буферами допустим лишь между равными аллокаторами
+    constexpr void Swap(RawMemory& other) noexcept {
         std::swap(buffer_, other.buffer_);
         std::swap(capacity_, other.capacity_);
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(alloc_, other.alloc_);
+        } else {
+            assert(alloc_ == other.alloc_);
+        }
     }
 
-    const T* GetAddress() const noexcept {
+    constexpr const T* GetAddress() const noexcept {
         return buffer_;
     }
 
-    T* GetAddress() noexcept {
+    constexpr T* GetAddress() noexcept {
         return buffer_;
     }
 
-    size_t Capacity() const {
+    constexpr size_t Capacity() const {
         return capacity_;
     }
 
+    constexpr const Alloc& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    /// Меняет вместимость блока средствами аллокатора, сохраняя его содержимое побайтово.
+    /// При исключении блок остаётся прежним
+    void Reallocate(size_t new_capacity) requires CAN_REALLOCATE {
+        if (new_capacity == 0) {
+            Deallocate(buffer_, capacity_);
+            buffer_ = nullptr;
+        } else if (buffer_ == nullptr) {
+            buffer_ = Allocate(new_capacity);
+        } else {
+            buffer_ = alloc_.reallocate(buffer_, capacity_, new_capacity);
+            RecordResize<T>(new_capacity);
+        }
+        capacity_ = new_capacity;
+    }
+
 private:
     // Выделяет сырую память под n элементов и возвращает указатель на неё
-    static T* Allocate(size_t n) {
-        return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
+    constexpr T* Allocate(size_t n) {
+        if (n == 0) {
+            return nullptr;
+        }
+        T* buf = AllocTraits::allocate(alloc_, n);
+        RecordAllocation<T>(n);
+        return buf;
     }
 
-    // Освобождает сырую память, выделенную ранее по адресу buf при помощи Allocate
-    static void Deallocate(T* buf) noexcept {
-        operator delete(buf);
+    // Освобождает сырую память под n элементов, выделенную ранее по адресу buf при помощи Allocate
+    constexpr void Deallocate(T* buf, size_t n) noexcept {
+        if (buf != nullptr) {
+            AllocTraits::deallocate(alloc_, buf, n);
+        }
     }
 
+    // Пустой аллокатор (например, std::allocator) не занимает места
+    [[no_unique_address]] Alloc alloc_;
     T* buffer_ = nullptr;
     size_t capacity_ = 0;
 };
 
 
+/// Тег конструктора, который инициализирует элементы по умолчанию (default-init):
+/// элементы тривиальных типов остаются неинициализированными
+struct DefaultInitTag {
+    explicit DefaultInitTag() = default;
+};
 
-template <typename T>
+inline constexpr DefaultInitTag default_init{};
+
+/// Тег конструктора из диапазона (аналог std::from_range из C++23): отличает его
+/// от копирующего конструктора, ведь Vector сам является диапазоном
+struct FromRangeTag {
+    explicit FromRangeTag() = default;
+};
+
+inline constexpr FromRangeTag from_range{};
+
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth>
 class Vector {
+    using AllocTraits = std::allocator_traits<Alloc>;
+
 public:
     using iterator = T*;
     using const_iterator = const T*;
+    using allocator_type = Alloc;
 
     /// Конструктор по умолчанию.
-    /// Инициализирует вектор нулевого размера и вместимости
-    Vector() = default;
+    /// Инициализирует вектор нулевого размера и вместимости.
+    /// Последний параметр всех конструкторов — место создания вектора для учёта
+    /// с VECTOR_WITH_SITE_TRACKING (см. CollectSiteTelemetry); его не нужно передавать явно.
+    /// Копия и перемещённый вектор по умолчанию учитываются в месте исходного вектора.
+    /// Вектор, который строит другой контейнер (emplace_back, EmplaceBack, resize), получает
+    /// место внутри этого контейнера: чтобы учесть его у себя, передайте site явно
+    constexpr Vector(vector_telemetry_detail::DefaultSiteTag = vector_telemetry_detail::DefaultSiteTag(),
+                     std::source_location site = std::source_location::current()) noexcept;
+
+    /// Создаёт пустой вектор, учитываемый в месте site
+    constexpr explicit Vector(std::source_location site) noexcept;
+
+    /// Создаёт пустой вектор, который будет выделять память через alloc
+    constexpr explicit Vector(const Alloc& alloc, std::source_location site = std::source_location::current()) noexcept;
 
     /// Конструктор, который создаёт вектор заданного размера.
-    /// Вместимость созданного вектора равна его размеру,
+    /// Вместимость созданного вектора равна его размеру (с точностью до Growth::Fit),
     /// а элементы проинициализированы значением по умолчанию для типа T
-    explicit Vector(size_t size);
+    constexpr explicit Vector(size_t size, const Alloc& alloc = Alloc(), std::source_location site = std::source_location::current());
+
+    /// Создаёт вектор заданного размера, не обнуляя элементы тривиальных типов.
+    /// Предназначен для буферов, которые сразу будут перезаписаны (read, recv)
+    constexpr Vector(size_t size, DefaultInitTag, const Alloc& alloc = Alloc(), std::source_location site = std::source_location::current());
+
+    /// Создаёт вектор из элементов [first, last). Для многопроходных итераторов
+    /// память выделяется один раз, вместимость равна размеру (с точностью до Growth::Fit)
+    template <std::input_iterator InputIt>
+    constexpr Vector(InputIt first, InputIt last, const Alloc& alloc = Alloc(), std::source_location site = std::source_location::current());
+
+    constexpr Vector(std::initializer_list<T> init, const Alloc& alloc = Alloc(), std::source_location site = std::source_location::current());
+
+    /// Создаёт вектор из элементов диапазона. Для диапазонов, размер которых известен заранее,
+    /// память выделяется один раз, вместимость равна размеру (с точностью до Growth::Fit)
+    template <std::ranges::input_range Range>
+    constexpr Vector(FromRangeTag, Range&& range, const Alloc& alloc = Alloc(), std::source_location site = std::source_location::current());
+
+    /// То же, но для однопроходных диапазонов неизвестного размера сразу резервирует
+    /// size_hint элементов (см. AppendRange с подсказкой размера)
+    template <std::ranges::input_range Range>
+    constexpr Vector(FromRangeTag, Range&& range, size_t size_hint, const Alloc& alloc = Alloc(),
+                     std::source_location site = std::source_location::current());
 
     /// Копирующий конструктор. Создаёт копию элементов исходного вектора.
-    /// Имеет вместимость, равную размеру исходного вектора,
+    /// Имеет вместимость, равную размеру исходного вектора (с точностью до Growth::Fit),
     /// то есть выделяет память без запаса.
-    Vector(const Vector& other);
+    /// Аллокатор получается через select_on_container_copy_construction
+    constexpr Vector(const Vector& other, std::source_location site = std::source_location());
 
-    Vector& operator=(const Vector& rhs);
+    constexpr Vector(const Vector& other, const Alloc& alloc, std::source_location site = std::source_location());
 
-    Vector(Vector&& other) noexcept;
+    /// Копирует аллокатор rhs, только если этого требует propagate_on_container_copy_assignment
+    constexpr Vector& operator=(const Vector& rhs);
 
-    Vector& operator=(Vector&& rhs) noexcept;
+    constexpr Vector(Vector&& other, std::source_location site = std::source_location()) noexcept;
 
-    ~Vector();
+    /// Забирает память other, если alloc равен его аллокатору, иначе перемещает элементы поштучно
+    constexpr Vector(Vector&& other, const Alloc& alloc, std::source_location site = std::source_location());
 
-    iterator begin() noexcept;
-    iterator end() noexcept;
-    const_iterator begin() const noexcept;
-    const_iterator end() const noexcept;
-    const_iterator cbegin() const noexcept;
-    const_iterator cend() const noexcept;
+    /// Если аллокатор не распространяется при перемещении и не равен аллокатору rhs,
+    /// элементы перемещаются поштучно в память текущего аллокатора
+    constexpr Vector& operator=(Vector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                             || AllocTraits::is_always_equal::value);
 
-    template <typename... Args>
-    iterator Emplace(const_iterator pos, Args&&... args);
-    iterator Erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>);
-    iterator Insert(const_iterator pos, const T& value);
-    iterator Insert(const_iterator pos, T&& value);
+    constexpr Vector& operator=(std::initializer_list<T> init);
 
+    constexpr ~Vector();
 
+    constexpr iterator begin() noexcept;
+    constexpr iterator end() noexcept;
+    constexpr const_iterator begin() const noexcept;
+    constexpr const_iterator end() const noexcept;
+    constexpr const_iterator cbegin() const noexcept;
+    constexpr const_iterator cend() const noexcept;
 
-    [[nodiscard]] size_t Size() const noexcept;
-    [[nodiscard]] size_t Capacity() const noexcept;
-    const T& operator[](size_t index) const noexcept;
-    T& operator[](size_t index) noexcept;
-    /// Резервирует достаточно места, чтобы вместить количество capacity
-    void Reserve(size_t new_capacity);
+    template <typename... Args>
+    constexpr iterator Emplace(const_iterator pos, Args&&... args);
+    constexpr iterator Erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>);
+    /// Удаляет элементы [first, last), сдвигая хвост вектора один раз
+    constexpr iterator Erase(const_iterator first, const_iterator last) noexcept(std::is_nothrow_move_assignable_v<T>);
+    /// Удаляет элемент pos за O(1), перемещая на его место последний элемент; порядок не сохраняется.
+    /// Возвращает итератор на элемент, занявший место удалённого (или end())
+    constexpr iterator SwapErase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>);
+    /// Удаляет элементы, для которых pred истинен, за один проход с сохранением порядка остальных.
+    /// Возвращает количество удалённых элементов. Если pred выбрасывает исключение,
+    /// уже отброшенные элементы удалены, а непроверенные остаются в векторе.
+    /// Если исключение выбрасывает перемещающее присваивание, размер не меняется,
+    /// а часть элементов может остаться в состоянии после перемещения
+    template <typename Predicate>
+    constexpr size_t EraseIf(Predicate pred);
+    /// Как EraseIf, но не сохраняет порядок: на место удаляемого элемента переносится
+    /// последний, поэтому перемещений не больше, чем удалённых элементов
+    template <typename Predicate>
+    constexpr size_t RemoveIf(Predicate pred);
+    constexpr iterator Insert(const_iterator pos, const T& value);
+    constexpr iterator Insert(const_iterator pos, T&& value);
+    /// Вставляет count копий value перед pos
+    constexpr iterator Insert(const_iterator pos, size_t count, const T& value);
+    /// Вставляет элементы [first, last) перед pos, выделяя память не более одного раза.
+    /// Итераторы не должны указывать на элементы этого же вектора
+    template <std::input_iterator InputIt>
+    constexpr iterator Insert(const_iterator pos, InputIt first, InputIt last);
+
+    /// Добавляет элементы диапазона в конец вектора.
+    /// Для диапазонов, размер которых известен заранее, память выделяется не более одного раза
+    template <std::ranges::input_range Range>
+    constexpr void AppendRange(Range&& range);
+
+    /// Как AppendRange, но для однопроходных диапазонов неизвестного размера (генераторов,
+    /// потоков ввода) сначала резервирует место под size_hint элементов одним выделением.
+    /// Если элементов больше подсказки, дальше вектор растёт по политике Growth; если меньше,
+    /// лишняя вместимость остаётся до ShrinkToFit. Для диапазонов известного размера подсказка
+    /// не используется
+    template <std::ranges::input_range Range>
+    constexpr void AppendRange(Range&& range, size_t size_hint);
+
+    /// Добавляет count элементов в конец вектора, создавая их сразу в неинициализированной памяти:
+    /// construct(T* dst, size_t count) должна создать ровно count элементов, а при исключении
+    /// сама уничтожить уже созданные. Память выделяется не более одного раза; при исключении
+    /// вектор остаётся в исходном состоянии
+    template <typename Construct>
+    constexpr void AppendWith(size_t count, Construct construct);
+
+    /// Заменяет содержимое вектора элементами [first, last). Если многопроходный диапазон помещается
+    /// в текущую вместимость, существующим элементам присваиваются новые значения без выделения
+    /// памяти, как при копирующем присваивании; иначе новый буфер заполняется целиком до освобождения
+    /// старого. Итераторы не должны указывать на элементы этого же вектора
+    template <std::input_iterator InputIt>
+    constexpr void Assign(InputIt first, InputIt last);
+    /// Заменяет содержимое вектора count копиями value; value может быть элементом вектора
+    constexpr void Assign(size_t count, const T& value);
+    constexpr void Assign(std::initializer_list<T> init);
+    /// Заменяет содержимое вектора элементами диапазона, как Assign(first, last)
+    template <std::ranges::input_range Range>
+    constexpr void AssignRange(Range&& range);
+
+    [[nodiscard]] constexpr size_t Size() const noexcept;
+    [[nodiscard]] constexpr size_t Capacity() const noexcept;
+    constexpr const T& operator[](size_t index) const noexcept;
+    constexpr T& operator[](size_t index) noexcept;
+    /// Резервирует достаточно места, чтобы вместить количество capacity.
+    /// Итоговую вместимость определяет Growth::Fit
+    constexpr void Reserve(size_t new_capacity);
+    /// Уменьшает вместимость до размера вектора, возвращая лишнюю память аллокатору
+    constexpr void ShrinkToFit();
+    /// Уменьшает вместимость до max(capacity, Size()); большую вместимость не меняет
+    constexpr void ShrinkTo(size_t capacity);
     /// выполняющий обмен содержимого вектора с другим вектором
-    void Swap(Vector& other) noexcept;
-    void Resize(size_t new_size);
+    constexpr void Swap(Vector& other) noexcept;
+    constexpr void Resize(size_t new_size);
+    /// Как Resize, но новые элементы инициализируются по умолчанию,
+    /// то есть элементы тривиальных типов не обнуляются
+    constexpr void ResizeForOverwrite(size_t new_size);
+    /// Увеличивает размер до new_size как ResizeForOverwrite и вызывает
+    /// op(T* data, size_t new_size), которая заполняет буфер и возвращает итоговый размер
+    /// (не больше new_size). Элементы за итоговым размером уничтожаются.
+    /// Если op выбрасывает исключение, размер становится не больше исходного
+    template <typename Operation>
+    constexpr void ResizeAndOverwrite(size_t new_size, Operation op);
 
     template <typename Type>
-    void PushBack(Type&& value);
+    constexpr void PushBack(Type&& value);
 
-    void PopBack() noexcept;
-    [[nodiscard]] bool IsEmpty() const noexcept;
+    constexpr void PopBack() noexcept;
+    [[nodiscard]] constexpr bool IsEmpty() const noexcept;
 
     template <typename... Args>
-    T& EmplaceBack(Args&&... args);
+    constexpr T& EmplaceBack(Args&&... args);
+
+    [[nodiscard]] constexpr Alloc GetAllocator() const noexcept;
 
 private:
-    RawMemory<T> data_;
+    RawMemory<T, Alloc> data_;
     size_t size_ = 0;
+    [[no_unique_address]] vector_telemetry_detail::SiteRecord site_;
+
+    /// публикует размер и вместимость для учёта по месту создания
+    constexpr void PublishSite() noexcept {
+        site_.Update(size_, data_.Capacity());
+    }
+
+    /// заменяет элементы вектора count элементами, начиная с first, в памяти текущего аллокатора
+    template <typename RandomIt>
+    constexpr void AssignN(RandomIt first, size_t count);
+
+    /// то же для многопроходных итераторов, которые нельзя обрабатывать параллельно
+    template <typename ForwardIt>
+    constexpr void AssignForward(ForwardIt first, size_t count);
+
+    /// переносить элементы при росте перемещением, даже если оно может выбросить исключение
+    static constexpr bool RELOCATE_BY_MOVE = relocates_by_move_v<T, Growth>;
+
+    /// Можно ли менять размер буфера через reallocate аллокатора, не перенося элементы по одному
+    static constexpr bool REALLOCATE_IN_PLACE = is_trivially_relocatable_v<T> && RawMemory<T, Alloc>::CAN_REALLOCATE;
+
+    /// Можно ли сдвигать элементы побайтово (memmove): тривиально перемещаемые типы,
+    /// кроме вычисления на этапе компиляции, где побайтовое копирование недоступно
+    static constexpr bool RelocatesBitwise() noexcept {
+        return is_trivially_relocatable_v<T> && !std::is_constant_evaluated();
+    }
+
+    /// меняет вместимость буфера, сохраняя элементы
+    constexpr void Reallocate(size_t new_capacity);
+
+    /// вместимость для required элементов при росте по политике Growth
+    [[nodiscard]] constexpr size_t NextCapacity(size_t required) const noexcept;
+
+    /// уничтожает элементы и забирает память other вместе с его аллокатором
+    constexpr void TakeStorage(Vector& other) noexcept;
 
     /// вставка элемента в этот же вектор, когда вместимость достаточна
     template <typename... Args>
-    void EmplaceShift(size_t index, Args&&... args);
+    constexpr void EmplaceShift(size_t index, Args&&... args);
 
     /// выполняет реаллокацию памяти при полностью заполненном векторе
     template <typename... Args>
-    void EmplaceReallocate(size_t index, Args&&... args);
+    constexpr void EmplaceReallocate(size_t index, Args&&... args);
+
+    /// вставляет count элементов в позицию index.
+    /// construct(dst, offset, n) создаёт элементы вставки [offset, offset + n) в неинициализированной памяти,
+    /// assign(dst, offset, n) присваивает их уже существующим элементам
+    template <typename Construct, typename AssignOp>
+    constexpr iterator InsertWith(size_t index, size_t count, Construct&& construct, AssignOp&& assign);
+
+    /// вставляет count элементов с началом в first в позицию index
+    template <typename Iterator>
+    constexpr iterator InsertN(size_t index, Iterator first, size_t count);
 
 }; // class Vector
 
-template<typename T>
-Vector<T>::Vector(size_t size)
-        : data_(size)
-        , size_(size)  //
+template<typename T, typename Alloc, typename Growth>
+constexpr Vector<T, Alloc, Growth>::Vector(vector_telemetry_detail::DefaultSiteTag, std::source_location site) noexcept
+        : site_(site, sizeof(T))  //
 {
-    std::uninitialized_value_construct_n(data_.GetAddress(), size);
 }
 
-template<typename T>
-Vector<T>::Vector(const Vector& other):
-    data_(other.size_),
-    size_(other.size_) {
-    std::uninitialized_copy_n(other.data_.GetAddress(), other.size_, data_.GetAddress());
+template<typename T, typename Alloc, typename Growth>
+constexpr Vector<T, Alloc, Growth>::Vector(std::source_location site) noexcept
+        : site_(site, sizeof(T))  //
+{
 }
 
-template<typename T>
-Vector<T>& Vector<T>::operator=(const Vector& rhs) {
-    if (this != &rhs) {
-        if (rhs.size_ > data_.Capacity()) {
-            /* Применить copy-and-swap */
-            Vector rhs_copy(rhs);
-            Swap(rhs_copy);
-        } else {
-            /* Скопировать элементы из rhs, создав при необходимости новые
-               или удалив существующие */
-            if(rhs.size_ < size_) {
-                std::copy(rhs.data_.GetAddress(), rhs.data_.GetAddress() + rhs.size_, data_.GetAddress());
-                std::destroy_n(data_.GetAddress() + rhs.size_, size_ - rhs.size_);
+template<typename T, typename Alloc, typename Growth>
+constexpr Vector<T, Alloc, Growth>::Vector(const Alloc& alloc, std::source_location site) noexcept
+        : data_(alloc)
+        , site_(site, sizeof(T))  //
+{
+}
+
+template<typename T, typename Alloc, typename Growth>
+constexpr Vector<T, Alloc, Growth>::Vector(size_t size, const Alloc& alloc, std::source_location site)
+        : data_(Growth::Fit(size, sizeof(T)), alloc)
+        , size_(size)
+        , site_(site, sizeof(T))  //
+{
+    BulkValueConstruct(data_.GetAddress(), size);
+    PublishSite();
+}
+
+template<typename T, typename Alloc, typename Growth>
+constexpr Vector<T, Alloc, Growth>::Vector(size_t size, DefaultInitTag, const Alloc& alloc, std::source_location site)
+        : data_(Growth::Fit(size, sizeof(T)), alloc)
+        , size_(size)
+        , site_(site, sizeof(T))  //
+{
+    BulkDefaultConstruct(data_.GetAddress(), size);
+    PublishSite();
+}
+
+template<typename T, typename Alloc, typename Growth>
+template<std::input_iterator InputIt>
+constexpr Vector<T, Alloc, Growth>::Vector(InputIt first, InputIt last, const Alloc& alloc, std::source_location site)
+        : data_(alloc)
+        , site_(site, sizeof(T))  //
+{
+    if constexpr (std::forward_iterator<InputIt>) {
+        const auto count = static_cast<size_t>(std::distance(first, last));
+        Reserve(count);
+        InsertN(0, first, count);
+    } else {
+        /// деструктор не вызывается для недостроенного объекта: уже созданные элементы уничтожаются здесь
+        try {
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
             }
-            else {
-                std::copy(rhs.data_.GetAddress(), rhs.data_.GetAddress() + size_, data_.GetAddress());
-                std::uninitialized_copy_n(rhs.data_.GetAddress() + size_, rhs.size_ - size_, data_.GetAddress() + size_);
+        } catch (...) {
+            BulkDestroy(data_.GetAddress(), size_);
+            throw;
+        }
+    }
+}
+
+template<typename T, typename Alloc, typename Growth>
+constexpr Vector<T, Alloc, Growth>::Vector(std::initializer_list<T> init, const Alloc& alloc, std::source_location site)
+        : Vector(init.begin(), init.end(), alloc, site)  //
+{
+}
+
+template<typename T, typename Alloc, typename Growth>
+template<std::ranges::input_range Range>
+constexpr Vector<T, Alloc, Growth>::Vector(FromRangeTag, Range&& range, const Alloc& alloc, std::source_location site)
+        : Vector(from_range, std::forward<Range>(range), 0, alloc, site)  //
+{
+}
+
+template<typename T, typename Alloc, typename Growth>
+template<std::ranges::input_range Range>
+constexpr Vector<T, Alloc, Growth>::Vector(FromRangeTag, Range&& range, size_t size_hint, const Alloc& alloc,
+                                           std::source_location site)
+        : data_(alloc)
+        , site_(site, sizeof(T))  //
+{
+    if constexpr (std::ranges::sized_range<Range> || std::ranges::forward_range<Range>) {
+        /// вместимость под точный размер, как у конструктора копирования
+        Reserve(static_cast<size_t>(std::ranges::distance(range)));
+    }
+    /// однопроходный диапазон добавляется поэлементно, и при исключении уже созданные
+    /// элементы уничтожаются здесь: деструктор недостроенного объекта не вызывается
+    try {
+        AppendRange(std::forward<Range>(range), size_hint);
+    } catch (...) {
+        BulkDestroy(data_.GetAddress(), size_);
+        throw;
+    }
+}
+
+template<typename T, typename Alloc, typename Growth>
+constexpr Vector<T, Alloc, Growth>::Vector(const Vector& other, std::source_location site):
+    Vector(other, AllocTraits::select_on_container_copy_construction(other.data_.GetAllocator()), site) {
+}
+
+template<typename T, typename Alloc, typename Growth>
+constexpr Vector<T, Alloc, Growth>::Vector(const Vector& other, const Alloc& alloc, std::source_location site):
+    data_(Growth::Fit(other.size_, sizeof(T)), alloc),
+    size_(other.size_),
+    site_(other.site_, site, sizeof(T)) {
+    BulkCopyConstruct(other.data_.GetAddress(), other.size_, data_.GetAddress());
+    PublishSite();
+}
+
+template<typename T, typename Alloc, typename Growth>
+constexpr Vector<T, Alloc, Growth>& Vector<T, Alloc, Growth>::operator=(const Vector& rhs) {
+    if (this != &rhs) {
+        if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+            if (data_.GetAllocator() != rhs.data_.GetAllocator()) {
+                /* Текущий буфер нужно вернуть старому аллокатору,
+                   поэтому копия строится аллокатором rhs и забирается целиком */
+                Vector rhs_copy(rhs, rhs.data_.GetAllocator());
+                TakeStorage(rhs_copy);
+                return *this;
             }
-            size_ = rhs.size_;
         }
+        AssignN(rhs.data_.GetAddress(), rhs.size_);
     }
     return *this;
 }
 
-template<typename T>
-Vector<T>::Vector(Vector&& other) noexcept {
-    Swap(other);
+template<typename T, typename Alloc, typename Growth>
+constexpr Vector<T, Alloc, Growth>::Vector(Vector&& other, std::source_location site) noexcept
+        : data_(std::move(other.data_))
+        , size_(std::exchange(other.size_, 0))
+        , site_(other.site_, site, sizeof(T))  //
+{
+    PublishSite();
+    other.PublishSite();
+}
+
+template<typename T, typename Alloc, typename Growth>
+constexpr Vector<T, Alloc, Growth>::Vector(Vector&& other, const Alloc& alloc, std::source_location site)
+        : data_(alloc)
+        , site_(other.site_, site, sizeof(T))  //
+{
+    if (data_.GetAllocator() == other.data_.GetAllocator()) {
+        data_.Swap(other.data_);
+        std::swap(size_, other.size_);
+        other.PublishSite();
+    } else {
+        AssignN(std::make_move_iterator(other.begin()), other.size_);
+    }
+    PublishSite();
 }
 
-template<typename T>
-Vector<T>& Vector<T>::operator=(Vector&& rhs) noexcept {
+template<typename T, typename Alloc, typename Growth>
+constexpr Vector<T, Alloc, Growth>& Vector<T, Alloc, Growth>::operator=(Vector&& rhs)
+        noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                 || AllocTraits::is_always_equal::value) {
     if (this != &rhs) {
-        Swap(rhs);
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value
+                      || AllocTraits::is_always_equal::value) {
+            TakeStorage(rhs);
+        } else {
+            if (data_.GetAllocator() == rhs.data_.GetAllocator()) {
+                TakeStorage(rhs);
+            } else {
+                /* Чужую память забрать нельзя: перемещаем элементы по одному */
+                AssignN(std::make_move_iterator(rhs.begin()), rhs.size_);
+            }
+        }
     }
     return *this;
 }
 
-template<typename T>
-Vector<T>::~Vector() {
-    std::destroy_n(data_.GetAddress(), size_);
+template<typename T, typename Alloc, typename Growth>
+constexpr Vector<T, Alloc, Growth>& Vector<T, Alloc, Growth>::operator=(std::initializer_list<T> init) {
+    Assign(init);
+    return *this;
 }
 
-template<typename T>
-typename Vector<T>::iterator Vector<T>::begin() noexcept{
+template<typename T, typename Alloc, typename Growth>
+constexpr Vector<T, Alloc, Growth>::~Vector() {
+    if (data_.Capacity() != 0) {
+        RecordDestruction<T>(data_.Capacity() - size_);
+    }
+    BulkDestroy(data_.GetAddress(), size_);
+}
+
+template<typename T, typename Alloc, typename Growth>
+constexpr typename Vector<T, Alloc, Growth>::iterator Vector<T, Alloc, Growth>::begin() noexcept{
     return data_.GetAddress();
 }
 
-template<typename T>
-typename Vector<T>::iterator Vector<T>::end() noexcept{
+template<typename T, typename Alloc, typename Growth>
+constexpr typename Vector<T, Alloc, Growth>::iterator Vector<T, Alloc, Growth>::end() noexcept{
     return data_.GetAddress() + size_;
 }
 
-template<typename T>
-typename Vector<T>::const_iterator Vector<T>::begin() const noexcept{
+template<typename T, typename Alloc, typename Growth>
+constexpr typename Vector<T, Alloc, Growth>::const_iterator Vector<T, Alloc, Growth>::begin() const noexcept{
     return data_.GetAddress();
 }
 
-template<typename T>
-typename Vector<T>::const_iterator Vector<T>::end() const noexcept{
+template<typename T, typename Alloc, typename Growth>
+constexpr typename Vector<T, Alloc, Growth>::const_iterator Vector<T, Alloc, Growth>::end() const noexcept{
     return data_.GetAddress() + size_;
 }
 
-template<typename T>
-typename Vector<T>::const_iterator Vector<T>::cbegin() const noexcept{
+template<typename T, typename Alloc, typename Growth>
+constexpr typename Vector<T, Alloc, Growth>::const_iterator Vector<T, Alloc, Growth>::cbegin() const noexcept{
     return begin();
 }
 
-template<typename T>
-typename Vector<T>::const_iterator Vector<T>::cend() const noexcept{
+template<typename T, typename Alloc, typename Growth>
+constexpr typename Vector<T, Alloc, Growth>::const_iterator Vector<T, Alloc, Growth>::cend() const noexcept{
     return end();
 }
 
-template<typename T>
+template<typename T, typename Alloc, typename Growth>
 template <typename... Args>
-typename Vector<T>::iterator Vector<T>::Emplace(const_iterator pos, Args&&... args){
+constexpr typename Vector<T, Alloc, Growth>::iterator Vector<T, Alloc, Growth>::Emplace(const_iterator pos, Args&&... args){
     size_t index = pos - begin();
 
     if (size_ < data_.Capacity()) {
@@ -274,76 +841,345 @@ typename Vector<T>::iterator Vector<T>::Emplace(const_iterator pos, Args&&... ar
     }
 }
 
-template<typename T>
-typename Vector<T>::iterator Vector<T>::Insert(const_iterator pos, const T& value){
+template<typename T, typename Alloc, typename Growth>
+constexpr typename Vector<T, Alloc, Growth>::iterator Vector<T, Alloc, Growth>::Insert(const_iterator pos, const T& value){
     return Emplace(pos, value);
 }
 
-template<typename T>
-typename Vector<T>::iterator Vector<T>::Insert(const_iterator pos, T&& value){
+template<typename T, typename Alloc, typename Growth>
+constexpr typename Vector<T, Alloc, Growth>::iterator Vector<T, Alloc, Growth>::Insert(const_iterator pos, T&& value){
     return Emplace(pos, std::move(value));
 }
 
-template<typename T>
-typename Vector<T>::iterator Vector<T>::Erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>){
+template<typename T, typename Alloc, typename Growth>
+constexpr typename Vector<T, Alloc, Growth>::iterator Vector<T, Alloc, Growth>::Insert(const_iterator pos, size_t count, const T& value){
+    const size_t index = pos - begin();
+    const T* address = std::addressof(value);
+    const std::less<const T*> before;
+    /// value может ссылаться на элемент вектора, который будет сдвинут, и тогда вставляется его копия.
+    /// На этапе компиляции адреса разных объектов сравнивать нельзя, поэтому там копия делается всегда
+    if (size_ + count <= data_.Capacity()
+        && (std::is_constant_evaluated() || (!before(address, begin()) && before(address, end())))) {
+        const T value_copy(value);
+        return InsertWith(index, count,
+                          [&value_copy](T* dst, size_t /*offset*/, size_t n) { BulkFillConstruct(dst, n, value_copy); },
+                          [&value_copy](T* dst, size_t /*offset*/, size_t n) { std::fill_n(dst, n, value_copy); });
+    }
+    /// при реаллокации старые элементы остаются на месте, пока копии не созданы
+    return InsertWith(index, count,
+                      [&value](T* dst, size_t /*offset*/, size_t n) { BulkFillConstruct(dst, n, value); },
+                      [&value](T* dst, size_t /*offset*/, size_t n) { std::fill_n(dst, n, value); });
+}
+
+template<typename T, typename Alloc, typename Growth>
+template<std::input_iterator InputIt>
+constexpr typename Vector<T, Alloc, Growth>::iterator Vector<T, Alloc, Growth>::Insert(const_iterator pos, InputIt first, InputIt last){
+    const size_t index = pos - begin();
+    if constexpr (std::forward_iterator<InputIt>) {
+        return InsertN(index, first, static_cast<size_t>(std::distance(first, last)));
+    } else {
+        if (index == size_) {
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+            return begin() + index;
+        }
+        /// размер однопроходного диапазона заранее неизвестен: собираем его отдельно
+        Vector tail(data_.GetAllocator());
+        for (; first != last; ++first) {
+            tail.EmplaceBack(*first);
+        }
+        return InsertN(index, std::make_move_iterator(tail.begin()), tail.size_);
+    }
+}
+
+template<typename T, typename Alloc, typename Growth>
+template<std::ranges::input_range Range>
+constexpr void Vector<T, Alloc, Growth>::AppendRange(Range&& range) {
+    if constexpr (std::ranges::sized_range<Range> || std::ranges::forward_range<Range>) {
+        InsertN(size_, std::ranges::begin(range), static_cast<size_t>(std::ranges::distance(range)));
+    } else {
+        for (auto&& value : range) {
+            EmplaceBack(std::forward<decltype(value)>(value));
+        }
+    }
+}
+
+template<typename T, typename Alloc, typename Growth>
+template<std::ranges::input_range Range>
+constexpr void Vector<T, Alloc, Growth>::AppendRange(Range&& range, size_t size_hint) {
+    if constexpr (!std::ranges::sized_range<Range> && !std::ranges::forward_range<Range>) {
+        if (size_hint > data_.Capacity() - size_) {
+            Reserve(size_ + size_hint);
+        }
+    }
+    AppendRange(std::forward<Range>(range));
+}
+
+template<typename T, typename Alloc, typename Growth>
+template<std::input_iterator InputIt>
+constexpr void Vector<T, Alloc, Growth>::Assign(InputIt first, InputIt last) {
+    if constexpr (std::contiguous_iterator<InputIt>) {
+        AssignN(std::to_address(first), static_cast<size_t>(last - first));
+    } else if constexpr (std::forward_iterator<InputIt>) {
+        AssignForward(first, static_cast<size_t>(std::distance(first, last)));
+    } else {
+        /// новые элементы собираются отдельно, поэтому при исключении вектор не меняется
+        Vector replacement(first, last, data_.GetAllocator());
+        Swap(replacement);
+    }
+}
+
+template<typename T, typename Alloc, typename Growth>
+constexpr void Vector<T, Alloc, Growth>::Assign(size_t count, const T& value) {
+    if (count > data_.Capacity()) {
+        /// копии создаются до уничтожения старых элементов, среди которых может быть value
+        RawMemory<T, Alloc> new_data(Growth::Fit(count, sizeof(T)), data_.GetAllocator());
+        BulkFillConstruct(new_data.GetAddress(), count, value);
+        BulkDestroy(data_.GetAddress(), size_);
+        data_.Swap(new_data);
+    } else if (count < size_) {
+        std::fill_n(data_.GetAddress(), count, value);
+        BulkDestroy(data_.GetAddress() + count, size_ - count);
+    } else {
+        std::fill_n(data_.GetAddress(), size_, value);
+        BulkFillConstruct(data_.GetAddress() + size_, count - size_, value);
+    }
+    size_ = count;
+    PublishSite();
+}
+
+template<typename T, typename Alloc, typename Growth>
+constexpr void Vector<T, Alloc, Growth>::Assign(std::initializer_list<T> init) {
+    AssignN(init.begin(), init.size());
+}
+
+template<typename T, typename Alloc, typename Growth>
+template<std::ranges::input_range Range>
+constexpr void Vector<T, Alloc, Growth>::AssignRange(Range&& range) {
+    if constexpr (std::ranges::contiguous_range<Range> && std::ranges::sized_range<Range>) {
+        AssignN(std::ranges::data(range), static_cast<size_t>(std::ranges::size(range)));
+    } else if constexpr (std::ranges::forward_range<Range>) {
+        AssignForward(std::ranges::begin(range), static_cast<size_t>(std::ranges::distance(range)));
+    } else {
+        Vector replacement(from_range, std::forward<Range>(range), data_.GetAllocator());
+        Swap(replacement);
+    }
+}
+
+template<typename T, typename Alloc, typename Growth>
+template<typename Construct>
+constexpr void Vector<T, Alloc, Growth>::AppendWith(size_t count, Construct construct) {
+    InsertWith(size_, count,
+               [&construct](T* dst, size_t /*offset*/, size_t n) {
+                   construct(dst, n);
+               },
+               [](T* /*dst*/, size_t /*offset*/, size_t /*n*/) {
+                   /// при вставке в конец существующие элементы не перезаписываются
+               });
+}
+
+template<typename T, typename Alloc, typename Growth>
+constexpr typename Vector<T, Alloc, Growth>::iterator Vector<T, Alloc, Growth>::Erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>){
     assert(pos >= begin() && pos < end());
-    size_t index = pos - begin();
-    /// Сначала на место удаляемого элемента нужно переместить следующие за ним элементы
-    std::move(begin() + index + 1, end(), begin() + index);
-    PopBack();
+    return Erase(pos, pos + 1);
+}
+
+template<typename T, typename Alloc, typename Growth>
+constexpr typename Vector<T, Alloc, Growth>::iterator Vector<T, Alloc, Growth>::Erase(const_iterator first, const_iterator last)
+        noexcept(std::is_nothrow_move_assignable_v<T>){
+    assert(first >= begin() && first <= last && last <= end());
+    const size_t index = first - begin();
+    const size_t count = last - first;
+    if (count == 0) {
+        return begin() + index;
+    }
+    T* pos = begin() + index;
+    if (RelocatesBitwise()) {
+        /// удалённые элементы уничтожаются, а хвост переносится на их место одним блоком
+        std::destroy_n(pos, count);
+        std::memmove(static_cast<void*>(pos), static_cast<const void*>(pos + count),
+                     (size_ - index - count) * sizeof(T));
+    } else {
+        /// Сначала на место удаляемых элементов нужно переместить следующие за ними элементы
+        std::move(pos + count, end(), pos);
+        std::destroy_n(end() - count, count);
+    }
+    size_ -= count;
+    PublishSite();
     return begin() + index;
 }
 
-template<typename T>
-size_t Vector<T>::Size() const noexcept {
+template<typename T, typename Alloc, typename Growth>
+constexpr typename Vector<T, Alloc, Growth>::iterator Vector<T, Alloc, Growth>::SwapErase(const_iterator pos)
+        noexcept(std::is_nothrow_move_assignable_v<T>){
+    assert(pos >= begin() && pos < end());
+    T* hole = begin() + (pos - cbegin());
+    T* last = end() - 1;
+    if (hole != last) {
+        if (RelocatesBitwise()) {
+            std::destroy_at(hole);
+            std::memcpy(static_cast<void*>(hole), static_cast<const void*>(last), sizeof(T));
+        } else {
+            *hole = std::move(*last);
+            std::destroy_at(last);
+        }
+    } else {
+        std::destroy_at(last);
+    }
+    --size_;
+    PublishSite();
+    return hole;
+}
+
+template<typename T, typename Alloc, typename Growth>
+template<typename Predicate>
+constexpr size_t Vector<T, Alloc, Growth>::EraseIf(Predicate pred) {
+    T* const first = begin();
+    T* const last = end();
+    T* out = first + (std::find_if(cbegin(), cend(), std::ref(pred)) - cbegin());
+    T* it = out;
+    /// [it, last) ещё не проверены, они сдвигаются к out; уничтожаются освободившиеся ячейки.
+    /// Сдвиг перемещающим присваиванием может выбросить исключение, тогда размер не меняется
+    auto finish = [&]() {
+        const size_t tail = last - it;
+        if (RelocatesBitwise()) {
+            /// отброшенные элементы уже уничтожены, а оставленные перенесены побайтово
+            std::memmove(static_cast<void*>(out), static_cast<const void*>(it), tail * sizeof(T));
+        } else {
+            std::move(it, last, out);
+            std::destroy(out + tail, last);
+        }
+        const size_t removed = it - out;
+        size_ -= removed;
+        PublishSite();
+        return removed;
+    };
+    if (it == last) {
+        return 0;
+    }
+    /// первый отброшенный элемент уже проверен find_if, дальше out всегда левее it
+    if (RelocatesBitwise()) {
+        std::destroy_at(it);
+    }
+    ++it;
+    try {
+        for (; it != last; ++it) {
+            if (pred(std::as_const(*it))) {
+                if (RelocatesBitwise()) {
+                    std::destroy_at(it);
+                }
+            } else {
+                if (RelocatesBitwise()) {
+                    std::memcpy(static_cast<void*>(out), static_cast<const void*>(it), sizeof(T));
+                } else {
+                    *out = std::move(*it);
+                }
+                ++out;
+            }
+        }
+    } catch (...) {
+        finish();
+        throw;
+    }
+    return finish();
+}
+
+template<typename T, typename Alloc, typename Growth>
+template<typename Predicate>
+constexpr size_t Vector<T, Alloc, Growth>::RemoveIf(Predicate pred) {
+    T* const first = begin();
+    T* const old_last = end();
+    T* last = old_last;
+    /// [last, old_last) — ячейки, элементы которых отброшены или перенесены в начало
+    auto finish = [&]() noexcept {
+        if (!RelocatesBitwise()) {
+            std::destroy(last, old_last);
+        }
+        size_ = last - first;
+        PublishSite();
+        return static_cast<size_t>(old_last - last);
+    };
+    try {
+        for (T* it = first; it != last;) {
+            if (!pred(std::as_const(*it))) {
+                ++it;
+                continue;
+            }
+            --last;
+            if (RelocatesBitwise()) {
+                std::destroy_at(it);
+                if (it != last) {
+                    std::memcpy(static_cast<void*>(it), static_cast<const void*>(last), sizeof(T));
+                }
+            } else if (it != last) {
+                *it = std::move(*last);
+            }
+        }
+    } catch (...) {
+        finish();
+        throw;
+    }
+    return finish();
+}
+
+template<typename T, typename Alloc, typename Growth>
+constexpr size_t Vector<T, Alloc, Growth>::Size() const noexcept {
     return size_;
 }
 
-template<typename T>
-size_t Vector<T>::Capacity() const noexcept {
+template<typename T, typename Alloc, typename Growth>
+constexpr size_t Vector<T, Alloc, Growth>::Capacity() const noexcept {
     return data_.Capacity();
 }
 
-template<typename T>
-const T& Vector<T>::operator[](size_t index) const noexcept {
+template<typename T, typename Alloc, typename Growth>
+constexpr const T& Vector<T, Alloc, Growth>::operator[](size_t index) const noexcept {
     return const_cast<Vector&>(*this)[index];
 }
 
-template<typename T>
-T& Vector<T>::operator[](size_t index) noexcept {
+template<typename T, typename Alloc, typename Growth>
+constexpr T& Vector<T, Alloc, Growth>::operator[](size_t index) noexcept {
     assert(index < size_);
     return data_[index];
 }
 
-template<typename T>
-void Vector<T>::Reserve(size_t new_capacity) {
+template<typename T, typename Alloc, typename Growth>
+constexpr void Vector<T, Alloc, Growth>::Reserve(size_t new_capacity) {
     if (new_capacity <= data_.Capacity()) {
         return;
     }
-    RawMemory<T> new_data(new_capacity);
-    // constexpr оператор if будет вычислен во время компиляции
-    if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-        std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-    }
-    else {
-        std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
+    Reallocate(Growth::Fit(new_capacity, sizeof(T)));
+}
+
+template<typename T, typename Alloc, typename Growth>
+constexpr void Vector<T, Alloc, Growth>::ShrinkToFit() {
+    ShrinkTo(size_);
+}
+
+template<typename T, typename Alloc, typename Growth>
+constexpr void Vector<T, Alloc, Growth>::ShrinkTo(size_t capacity) {
+    const size_t new_capacity = size_ == 0 && capacity == 0 ? 0 : Growth::Fit(std::max(capacity, size_), sizeof(T));
+    if (new_capacity >= data_.Capacity()) {
+        return;
     }
-    std::destroy_n(data_.GetAddress(), size_);
-    data_.Swap(new_data);
+    Reallocate(new_capacity);
 }
 
-template<typename T>
-void Vector<T>::Swap(Vector& other) noexcept {
+template<typename T, typename Alloc, typename Growth>
+constexpr void Vector<T, Alloc, Growth>::Swap(Vector& other) noexcept {
     data_.Swap(other.data_);
     std::swap(size_, other.size_);
+    PublishSite();
+    other.PublishSite();
 }
 
-template<typename T>
-void Vector<T>::Resize(size_t new_size) {
+template<typename T, typename Alloc, typename Growth>
+constexpr void Vector<T, Alloc, Growth>::Resize(size_t new_size) {
     /// уменьшение размера вектора
     if (new_size < size_) {
         /// удалить лишние элементы вектора, вызвав их деструкторы
-        std::destroy_n(data_.GetAddress() + new_size, size_ - new_size);
+        BulkDestroy(data_.GetAddress() + new_size, size_ - new_size);
     }
         /// увеличение размера вектора
     else if (new_size > size_) {
@@ -352,95 +1188,317 @@ void Vector<T>::Resize(size_t new_size) {
             Reserve(new_size);
         }
         /// новые элементы нужно проинициализировать
-        std::uninitialized_value_construct_n(data_.GetAddress() + size_, new_size - size_);
+        BulkValueConstruct(data_.GetAddress() + size_, new_size - size_);
     }
     /// обновить размер вектора
     size_ = new_size;
+    PublishSite();
+}
+
+template<typename T, typename Alloc, typename Growth>
+constexpr void Vector<T, Alloc, Growth>::ResizeForOverwrite(size_t new_size) {
+    if (new_size < size_) {
+        BulkDestroy(data_.GetAddress() + new_size, size_ - new_size);
+    } else if (new_size > size_) {
+        if (new_size > data_.Capacity()) {
+            Reserve(new_size);
+        }
+        /// для тривиальных типов инициализация по умолчанию ничего не делает
+        BulkDefaultConstruct(data_.GetAddress() + size_, new_size - size_);
+    }
+    size_ = new_size;
+    PublishSite();
+}
+
+template<typename T, typename Alloc, typename Growth>
+template<typename Operation>
+constexpr void Vector<T, Alloc, Growth>::ResizeAndOverwrite(size_t new_size, Operation op) {
+    const size_t old_size = size_;
+    ResizeForOverwrite(new_size);
+    size_t final_size = 0;
+    try {
+        final_size = std::move(op)(data_.GetAddress(), new_size);
+    } catch (...) {
+        if (size_ > old_size) {
+            std::destroy_n(data_.GetAddress() + old_size, size_ - old_size);
+            size_ = old_size;
+            PublishSite();
+        }
+        throw;
+    }
+    assert(final_size <= new_size);
+    std::destroy_n(data_.GetAddress() + final_size, size_ - final_size);
+    size_ = final_size;
+    PublishSite();
 }
 
-template<typename T>
+template<typename T, typename Alloc, typename Growth>
 template<typename Type>
-void Vector<T>::PushBack(Type&& value) {
+constexpr void Vector<T, Alloc, Growth>::PushBack(Type&& value) {
     EmplaceBack(std::forward<Type>(value));
 }
 
-template<typename T>
-void Vector<T>::PopBack() noexcept {
+template<typename T, typename Alloc, typename Growth>
+constexpr void Vector<T, Alloc, Growth>::PopBack() noexcept {
     assert(!IsEmpty());
     std::destroy_at(data_.GetAddress() + size_ - 1);
     --size_;
+    PublishSite();
 }
 
-template<typename T>
-bool Vector<T>::IsEmpty() const noexcept {
+template<typename T, typename Alloc, typename Growth>
+constexpr bool Vector<T, Alloc, Growth>::IsEmpty() const noexcept {
     return size_ == 0;
 }
 
-template<typename T>
+template<typename T, typename Alloc, typename Growth>
 template<typename ...Args>
-T& Vector<T>::EmplaceBack(Args && ...args) {
+constexpr T& Vector<T, Alloc, Growth>::EmplaceBack(Args && ...args) {
     if (size_ == Capacity()) {
-        RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
-        new (new_data + size_) T(std::forward<Args>(args)...);
-
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-            std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-        } else {
-            std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
+        if constexpr (REALLOCATE_IN_PLACE) {
+            /// аргументы могут ссылаться на элементы вектора, поэтому элемент создаётся
+            /// до изменения размера буфера и затем переносится в него побайтово
+            alignas(T) std::byte value[sizeof(T)];
+            new (value) T(std::forward<Args>(args)...);
+            try {
+                data_.Reallocate(NextCapacity(size_ + 1));
+                RecordRelocation<T>(RelocationKind::REALLOCATE, size_);
+            } catch (...) {
+                std::destroy_at(std::launder(reinterpret_cast<T*>(value)));
+                throw;
+            }
+            std::memcpy(static_cast<void*>(data_ + size_), value, sizeof(T));
+            ++size_;
+            PublishSite();
+            return data_[size_ - 1];
+        }
+        RawMemory<T, Alloc> new_data(NextCapacity(size_ + 1), data_.GetAllocator());
+        std::construct_at(new_data + size_, std::forward<Args>(args)...);
+
+        try {
+            RelocateElements<T, RELOCATE_BY_MOVE>(data_.GetAddress(), size_, new_data.GetAddress(), size_);
+        } catch (...) {
+            std::destroy_at(new_data + size_);
+            throw;
         }
-
-        std::destroy_n(data_.GetAddress(), size_);
         data_.Swap(new_data);
     } else {
-        new (data_ + size_) T(std::forward<Args>(args)...);
+        std::construct_at(data_ + size_, std::forward<Args>(args)...);
     }
 
     ++size_;
+    PublishSite();
     return data_[size_ - 1];
 }
 
-template<typename T>
+template<typename T, typename Alloc, typename Growth>
 template<typename ...Args>
-void Vector<T>::EmplaceShift(size_t index, Args&&... args) {
+constexpr void Vector<T, Alloc, Growth>::EmplaceShift(size_t index, Args&&... args) {
     /// Создаем временный объект, чтобы избежать перезаписи при вставке из этого же вектора
     T temp_value(std::forward<Args>(args)...);
     /// Создаем копию или перемещаем последний элемент вектора в неинициализированную область
-    new (data_ + size_) T(std::move(data_[size_ - 1]));
+    std::construct_at(data_ + size_, std::move(data_[size_ - 1]));
     /// Перемещаем элементы вправо с использованием std::move_backward
     std::move_backward(data_ + index, data_ + size_ - 1, data_ + size_);
     /// Перемещаем временный элемент в позицию вставки
     data_[index] = std::move(temp_value);
     ++size_;
+    PublishSite();
 }
 
-template<typename T>
+template<typename T, typename Alloc, typename Growth>
 template<typename ...Args>
-void Vector<T>::EmplaceReallocate(size_t index, Args&&... args) {
-    RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
+constexpr void Vector<T, Alloc, Growth>::EmplaceReallocate(size_t index, Args&&... args) {
+    RawMemory<T, Alloc> new_data(NextCapacity(size_ + 1), data_.GetAllocator());
 
     /// Конструируем вставляемый элемент в новом блоке
-    new (new_data + index) T(std::forward<Args>(args)...);
+    std::construct_at(new_data + index, std::forward<Args>(args)...);
 
     try {
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-            /// перемещаем элементы до позиции в новый блок
-            std::uninitialized_move_n(data_.GetAddress(), index, new_data.GetAddress());
-            /// перемещаем элементы после позиции в новый блок
-            std::uninitialized_move_n(data_.GetAddress() + index, size_ - index,
-                                      new_data.GetAddress() + index + 1);
-        }
-        else {
-            std::uninitialized_copy_n(data_.GetAddress(), index, new_data.GetAddress());
-            std::uninitialized_copy_n(data_.GetAddress() + index, size_ - index,
-                                      new_data.GetAddress() + index + 1);
-        }
+        /// переносим элементы до и после позиции, оставляя место под вставленный
+        RelocateElements<T, RELOCATE_BY_MOVE>(data_.GetAddress(), size_, new_data.GetAddress(), index, 1);
     }
     catch (...) {
         std::destroy_n(new_data.GetAddress() + index, 1);
         throw;
     }
 
-    std::destroy_n(data_.GetAddress(), size_);
     data_.Swap(new_data);
     ++size_;
+    PublishSite();
+}
+
+template<typename T, typename Alloc, typename Growth>
+template<typename Construct, typename AssignOp>
+constexpr typename Vector<T, Alloc, Growth>::iterator Vector<T, Alloc, Growth>::InsertWith(size_t index, size_t count,
+                                                                                 Construct&& construct, AssignOp&& assign) {
+    assert(index <= size_);
+    if (count == 0) {
+        return begin() + index;
+    }
+    if (size_ + count > data_.Capacity()) {
+        /// Сначала создаём вставляемые элементы в новом блоке, затем переносим старые вокруг них.
+        /// При исключении вектор остаётся в исходном состоянии
+        RawMemory<T, Alloc> new_data(NextCapacity(size_ + count), data_.GetAllocator());
+        construct(new_data + index, 0, count);
+        try {
+            RelocateElements<T, RELOCATE_BY_MOVE>(data_.GetAddress(), size_, new_data.GetAddress(), index, count);
+        } catch (...) {
+            std::destroy_n(new_data + index, count);
+            throw;
+        }
+        data_.Swap(new_data);
+        size_ += count;
+        PublishSite();
+        return begin() + index;
+    }
+
+    T* pos = data_ + index;
+    const size_t elems_after = size_ - index;
+    if (RelocatesBitwise()) {
+        /// хвост сдвигается одним блоком, а при исключении возвращается обратно
+        std::memmove(static_cast<void*>(pos + count), static_cast<const void*>(pos), elems_after * sizeof(T));
+        try {
+            construct(pos, 0, count);
+        } catch (...) {
+            std::memmove(static_cast<void*>(pos), static_cast<const void*>(pos + count), elems_after * sizeof(T));
+            throw;
+        }
+        size_ += count;
+    } else {
+        T* old_end = data_ + size_;
+        if (elems_after > count) {
+            /// последние count элементов переезжают в неинициализированную область,
+            /// остальные сдвигаются присваиванием
+            BulkMoveConstruct(old_end - count, count, old_end);
+            size_ += count;
+            std::move_backward(pos, old_end - count, old_end);
+            assign(pos, 0, count);
+        } else {
+            /// часть вставляемых элементов попадает за конец вектора
+            construct(old_end, elems_after, count - elems_after);
+            size_ += count - elems_after;
+            BulkMoveConstruct(pos, elems_after, pos + count);
+            size_ += elems_after;
+            assign(pos, 0, elems_after);
+        }
+    }
+    PublishSite();
+    return begin() + index;
+}
+
+template<typename T, typename Alloc, typename Growth>
+template<typename Iterator>
+constexpr typename Vector<T, Alloc, Growth>::iterator Vector<T, Alloc, Growth>::InsertN(size_t index, Iterator first, size_t count) {
+    return InsertWith(index, count,
+                      [&first](T* dst, size_t offset, size_t n) {
+                          auto src = std::ranges::next(first, offset);
+                          if (std::is_constant_evaluated()) {
+                              parallel_memory_detail::ConstructEach(dst, n, [&src](T* place, size_t) {
+                                  std::construct_at(place, *src);
+                                  ++src;
+                              });
+                          } else {
+                              std::ranges::uninitialized_copy_n(src, n, dst, dst + n);
+                          }
+                      },
+                      [&first](T* dst, size_t offset, size_t n) {
+                          std::ranges::copy_n(std::ranges::next(first, offset), n, dst);
+                      });
+}
+
+template<typename T, typename Alloc, typename Growth>
+constexpr Alloc Vector<T, Alloc, Growth>::GetAllocator() const noexcept {
+    return data_.GetAllocator();
+}
+
+template<typename T, typename Alloc, typename Growth>
+constexpr void Vector<T, Alloc, Growth>::Reallocate(size_t new_capacity) {
+    assert(new_capacity >= size_);
+    if constexpr (REALLOCATE_IN_PLACE) {
+        /// аллокатор сам решает, расширить блок на месте или перенести его (realloc, mremap)
+        data_.Reallocate(new_capacity);
+        RecordRelocation<T>(RelocationKind::REALLOCATE, size_);
+    } else {
+        RawMemory<T, Alloc> new_data(new_capacity, data_.GetAllocator());
+        RelocateElements<T, RELOCATE_BY_MOVE>(data_.GetAddress(), size_, new_data.GetAddress(), size_);
+        data_.Swap(new_data);
+    }
+    PublishSite();
+}
+
+template<typename T, typename Alloc, typename Growth>
+constexpr size_t Vector<T, Alloc, Growth>::NextCapacity(size_t required) const noexcept {
+    return Growth::Grow(data_.Capacity(), required, sizeof(T));
+}
+
+template<typename T, typename Alloc, typename Growth>
+template<typename RandomIt>
+constexpr void Vector<T, Alloc, Growth>::AssignN(RandomIt first, size_t count) {
+    if (count > data_.Capacity()) {
+        /* Применить copy-and-swap: новый буфер заполняется целиком до освобождения старого */
+        RawMemory<T, Alloc> new_data(Growth::Fit(count, sizeof(T)), data_.GetAllocator());
+        BulkCopyConstruct(first, count, new_data.GetAddress());
+        BulkDestroy(data_.GetAddress(), size_);
+        data_.Swap(new_data);
+    } else if (count < size_) {
+        /* Скопировать элементы, удалив лишние существующие */
+        BulkCopyAssign(first, count, data_.GetAddress());
+        BulkDestroy(data_.GetAddress() + count, size_ - count);
+    } else {
+        /* Скопировать элементы, создав недостающие */
+        BulkCopyAssign(first, size_, data_.GetAddress());
+        BulkCopyConstruct(first + size_, count - size_, data_.GetAddress() + size_);
+    }
+    size_ = count;
+    PublishSite();
+}
+
+template<typename T, typename Alloc, typename Growth>
+template<typename ForwardIt>
+constexpr void Vector<T, Alloc, Growth>::AssignForward(ForwardIt first, size_t count) {
+    T* data = data_.GetAddress();
+    if (count > data_.Capacity()) {
+        RawMemory<T, Alloc> new_data(Growth::Fit(count, sizeof(T)), data_.GetAllocator());
+        std::ranges::uninitialized_copy_n(first, count, new_data.GetAddress(), new_data.GetAddress() + count);
+        BulkDestroy(data, size_);
+        data_.Swap(new_data);
+    } else if (count < size_) {
+        std::ranges::copy_n(first, count, data);
+        BulkDestroy(data + count, size_ - count);
+    } else {
+        auto rest = std::ranges::copy_n(first, size_, data).in;
+        std::ranges::uninitialized_copy_n(rest, count - size_, data + size_, data + count);
+    }
+    size_ = count;
+    PublishSite();
+}
+
+template<typename T, typename Alloc, typename Growth>
+constexpr void Vector<T, Alloc, Growth>::TakeStorage(Vector& other) noexcept {
+    BulkDestroy(data_.GetAddress(), size_);
+    size_ = 0;
+    data_ = std::move(other.data_);
+    std::swap(size_, other.size_);
+    PublishSite();
+    other.PublishSite();
 }
+
+/// Поэлементное сравнение; для арифметических типов используется векторизованное simd::Equal
+template <typename T, typename Alloc, typename Growth>
+constexpr bool operator==(const Vector<T, Alloc, Growth>& lhs, const Vector<T, Alloc, Growth>& rhs) {
+    if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+        if (!std::is_constant_evaluated()) {
+            return simd::Equal(lhs, rhs);
+        }
+    }
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+namespace pmr {
+
+/// Вектор, выделяющий память из std::pmr::memory_resource
+template <typename T, typename Growth = DoublingGrowth>
+using Vector = ::Vector<T, std::pmr::polymorphic_allocator<T>, Growth>;
+
+}  // namespace pmr